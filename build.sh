@@ -8,7 +8,21 @@ set -e  # Arrêter en cas d'erreur
 # Configuration
 CC="${CC:-gcc}"
 CFLAGS="-Wall -Wextra -std=c99 -O2 -g -Isrc"
-LDFLAGS="-lgdi32 -luser32 -lkernel32"  # Pour Windows cross-compilation
+# Bibliothèques et backends vidéo selon la plateforme
+case "$(uname -s)" in
+    MINGW*|MSYS*|CYGWIN*)
+        LDFLAGS="-lgdi32 -luser32 -lkernel32"
+        PLATFORM_SOURCES=("graphics_win32.c" "video_win32.c")
+        ;;
+    Darwin*)
+        LDFLAGS="-lpthread"
+        PLATFORM_SOURCES=()
+        ;;
+    *)
+        LDFLAGS="-lpthread -lrt"
+        PLATFORM_SOURCES=()
+        ;;
+esac
 SRC_DIR="src"
 BUILD_DIR="build"
 OBJ_DIR="$BUILD_DIR/obj"
@@ -92,7 +106,7 @@ build_all() {
     check_deps
 
     # Liste des fichiers sources principaux
-    local main_sources=("cpu.c" "cpu_tables.c" "cpu_tables_cb.c" "mmu.c" "timer.c" "ppu.c" "joypad.c" "graphics_win32.c" "emulator_simple.c")
+    local main_sources=("cpu.c" "cpu_tables.c" "cpu_tables_cb.c" "mmu.c" "timer.c" "serial.c" "link.c" "ppu.c" "framebuffer.c" "golden.c" "thread.c" "async_writer.c" "video_sink.c" "scaler.c" "render_thread.c" "joypad.c" "interrupt.c" "apu.c" "blip.c" "scheduler.c" "audio_ring.c" "resampler.c" "audio.c" "wav_sink.c" "video.c" "video_null.c" "video_shm.c" "${PLATFORM_SOURCES[@]}" "emulator_simple.c")
     local objects=""
 
     # Compilation des objets
@@ -117,27 +131,39 @@ build_tests() {
 
     # Test CPU (complexe)
     log_info "Building test_cpu..."
-    $CC $CFLAGS tests/unit/test_cpu.c src/cpu.c src/cpu_tables.c src/cpu_tables_cb.c src/mmu.c -o "$BIN_DIR/test_cpu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_cpu"
+    $CC $CFLAGS tests/unit/test_cpu.c src/cpu.c src/cpu_tables.c src/cpu_tables_cb.c src/interrupt.c src/mmu.c src/timer.c src/serial.c src/joypad.c src/apu.c src/blip.c src/scheduler.c src/ppu.c -o "$BIN_DIR/test_cpu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_cpu"
 
     # Test MMU
     log_info "Building test_mmu..."
-    $CC $CFLAGS tests/unit/test_mmu.c src/mmu.c -o "$BIN_DIR/test_mmu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_mmu"
+    $CC $CFLAGS tests/unit/test_mmu.c src/mmu.c src/interrupt.c src/cpu.c src/cpu_tables.c src/cpu_tables_cb.c src/timer.c src/serial.c src/joypad.c src/apu.c src/blip.c src/scheduler.c src/ppu.c -o "$BIN_DIR/test_mmu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_mmu"
 
     # Test PPU
     log_info "Building test_ppu..."
-    $CC $CFLAGS tests/unit/test_ppu.c src/ppu.c -o "$BIN_DIR/test_ppu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_ppu"
+    $CC $CFLAGS tests/unit/test_ppu.c src/ppu.c src/framebuffer.c src/golden.c src/render_thread.c src/thread.c -o "$BIN_DIR/test_ppu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_ppu"
 
     # Test Timer
     log_info "Building test_timer..."
-    $CC $CFLAGS tests/unit/test_timer.c src/timer.c -o "$BIN_DIR/test_timer" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_timer"
+    $CC $CFLAGS tests/unit/test_timer.c src/timer.c src/scheduler.c -o "$BIN_DIR/test_timer" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_timer"
 
     # Test Interrupt
     log_info "Building test_interrupt..."
-    $CC $CFLAGS tests/unit/test_interrupt.c src/interrupt.c src/cpu.c src/cpu_tables.c src/cpu_tables_cb.c src/mmu.c -o "$BIN_DIR/test_interrupt" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_interrupt"
+    $CC $CFLAGS tests/unit/test_interrupt.c src/interrupt.c src/cpu.c src/cpu_tables.c src/cpu_tables_cb.c src/mmu.c src/timer.c src/serial.c src/joypad.c src/apu.c src/blip.c src/scheduler.c src/ppu.c -o "$BIN_DIR/test_interrupt" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_interrupt"
 
     # Test Joypad
     log_info "Building test_joypad..."
-    $CC $CFLAGS tests/unit/test_joypad.c src/joypad.c -o "$BIN_DIR/test_joypad" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_joypad"
+    $CC $CFLAGS tests/unit/test_joypad.c src/joypad.c src/scheduler.c -o "$BIN_DIR/test_joypad" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_joypad"
+
+    # Test Vidéo
+    log_info "Building test_video..."
+    $CC $CFLAGS tests/unit/test_video.c src/video_sink.c src/async_writer.c src/thread.c src/framebuffer.c src/scaler.c src/video.c src/video_null.c src/video_shm.c "${PLATFORM_SOURCES[@]/#/src/}" -o "$BIN_DIR/test_video" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_video"
+
+    # Test APU
+    log_info "Building test_apu..."
+    $CC $CFLAGS tests/unit/test_apu.c src/apu.c src/blip.c src/scheduler.c src/audio_ring.c src/thread.c src/resampler.c src/wav_sink.c src/async_writer.c -o "$BIN_DIR/test_apu" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_apu"
+
+    # Test Série
+    log_info "Building test_serial..."
+    $CC $CFLAGS tests/unit/test_serial.c src/serial.c src/link.c src/thread.c src/scheduler.c -o "$BIN_DIR/test_serial" $LDFLAGS 2>>"$LOGS_DIR/test_build.log" || log_warning "Failed to build test_serial"
 
     log_success "Test binaries built"
 }
@@ -160,7 +186,7 @@ run_tests() {
     } > "$LOGS_DIR/test_results.log"
 
     # Liste des tests à exécuter
-    local test_names=("cpu" "mmu" "ppu" "timer" "interrupt" "joypad")
+    local test_names=("cpu" "mmu" "ppu" "timer" "interrupt" "joypad" "video" "apu" "serial")
 
     for test_name in "${test_names[@]}"; do
         local test_exe="$BIN_DIR/test_$test_name"
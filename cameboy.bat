@@ -47,7 +47,7 @@ REM Compiler directement avec GCC
 echo Compilation en cours...
 set "CFLAGS=-Wall -Wextra -std=c99 -O2 -g -Isrc"
 set "LDFLAGS=-lgdi32 -luser32 -lkernel32"
-set "SOURCES=src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\ppu.c src\joypad.c src\interrupt.c src\apu.c src\graphics_win32.c src\emulator_win32.c"
+set "SOURCES=src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\serial.c src\ppu.c src\framebuffer.c src\golden.c src\thread.c src\async_writer.c src\video_sink.c src\scaler.c src\render_thread.c src\joypad.c src\interrupt.c src\apu.c src\blip.c src\scheduler.c src\graphics_win32.c src\emulator_win32.c"
 set "BUILD_LOG=%LOGS_DIR%\build.log"
 
 echo ======================================== > "%BUILD_LOG%"
@@ -98,7 +98,7 @@ REM S'assurer que le dossier bin existe
 if not exist "%BIN_DIR%" mkdir "%BIN_DIR%" 2>nul
 
 echo Compilation test_cpu...
-gcc %CFLAGS% tests\unit\test_cpu.c src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\apu.c -o "%BIN_DIR%\test_cpu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_cpu.c src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\interrupt.c src\mmu.c src\timer.c src\serial.c src\joypad.c src\apu.c src\blip.c src\scheduler.c src\ppu.c -o "%BIN_DIR%\test_cpu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_cpu
     echo FAIL: test_cpu compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -107,7 +107,7 @@ if errorlevel 1 (
 )
 
 echo Compilation test_mmu...
-gcc %CFLAGS% tests\unit\test_mmu.c src\mmu.c src\timer.c src\apu.c -o "%BIN_DIR%\test_mmu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_mmu.c src\mmu.c src\interrupt.c src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\timer.c src\serial.c src\joypad.c src\apu.c src\blip.c src\scheduler.c src\ppu.c -o "%BIN_DIR%\test_mmu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_mmu
     echo FAIL: test_mmu compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -116,7 +116,7 @@ if errorlevel 1 (
 )
 
 echo Compilation test_ppu...
-gcc %CFLAGS% tests\unit\test_ppu.c src\ppu.c -o "%BIN_DIR%\test_ppu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_ppu.c src\ppu.c src\framebuffer.c src\golden.c src\render_thread.c src\thread.c -o "%BIN_DIR%\test_ppu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_ppu
     echo FAIL: test_ppu compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -125,7 +125,7 @@ if errorlevel 1 (
 )
 
 echo Compilation test_timer...
-gcc %CFLAGS% tests\unit\test_timer.c src\timer.c -o "%BIN_DIR%\test_timer.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_timer.c src\timer.c src\scheduler.c -o "%BIN_DIR%\test_timer.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_timer
     echo FAIL: test_timer compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -134,7 +134,7 @@ if errorlevel 1 (
 )
 
 echo Compilation test_interrupt...
-gcc %CFLAGS% tests\unit\test_interrupt.c src\interrupt.c src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\apu.c -o "%BIN_DIR%\test_interrupt.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_interrupt.c src\interrupt.c src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\serial.c src\joypad.c src\apu.c src\blip.c src\scheduler.c src\ppu.c -o "%BIN_DIR%\test_interrupt.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_interrupt
     echo FAIL: test_interrupt compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -143,7 +143,7 @@ if errorlevel 1 (
 )
 
 echo Compilation test_joypad...
-gcc %CFLAGS% tests\unit\test_joypad.c src\joypad.c -o "%BIN_DIR%\test_joypad.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+gcc %CFLAGS% tests\unit\test_joypad.c src\joypad.c src\scheduler.c -o "%BIN_DIR%\test_joypad.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
 if errorlevel 1 (
     echo ERREUR compilation test_joypad
     echo FAIL: test_joypad compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
@@ -151,6 +151,33 @@ if errorlevel 1 (
     echo OK: test_joypad compiled at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
 )
 
+echo Compilation test_video...
+gcc %CFLAGS% tests\unit\test_video.c src\video_sink.c src\async_writer.c src\thread.c src\framebuffer.c src\scaler.c src\video.c src\video_null.c src\video_shm.c src\video_win32.c src\graphics_win32.c -o "%BIN_DIR%\test_video.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+if errorlevel 1 (
+    echo ERREUR compilation test_video
+    echo FAIL: test_video compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+) else (
+    echo OK: test_video compiled at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+)
+
+echo Compilation test_apu...
+gcc %CFLAGS% tests\unit\test_apu.c src\apu.c src\blip.c src\scheduler.c src\audio_ring.c src\thread.c src\resampler.c src\wav_sink.c src\async_writer.c -o "%BIN_DIR%\test_apu.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+if errorlevel 1 (
+    echo ERREUR compilation test_apu
+    echo FAIL: test_apu compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+) else (
+    echo OK: test_apu compiled at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+)
+
+echo Compilation test_serial...
+gcc %CFLAGS% tests\unit\test_serial.c src\serial.c src\link.c src\thread.c src\scheduler.c -o "%BIN_DIR%\test_serial.exe" %LDFLAGS% 2>> "%TEST_BUILD_LOG%"
+if errorlevel 1 (
+    echo ERREUR compilation test_serial
+    echo FAIL: test_serial compilation at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+) else (
+    echo OK: test_serial compiled at %DATE% %TIME% >> "%TEST_BUILD_LOG%"
+)
+
 echo ======================================== > "%LOGS_DIR%\test_results.log"
 echo CameBoy Unit Tests - %DATE% %TIME% >> "%LOGS_DIR%\test_results.log"
 echo ======================================== >> "%LOGS_DIR%\test_results.log"
@@ -159,7 +186,7 @@ echo. >> "%LOGS_DIR%\test_results.log"
 set total=0
 set passed=0
 
-for %%t in (cpu mmu ppu timer interrupt joypad) do (
+for %%t in (cpu mmu ppu timer interrupt joypad video apu serial) do (
     if exist "%BIN_DIR%\test_%%t.exe" (
         echo Running test_%%t...
         echo Running test_%%t... >> "%LOGS_DIR%\test_results.log"
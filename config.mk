@@ -11,8 +11,14 @@ CFLAGS_DEBUG = $(CFLAGS_BASE) -DDEBUG -g3 -O0
 CFLAGS_RELEASE = $(CFLAGS_BASE) -O3 -DNDEBUG -flto
 CFLAGS ?= $(CFLAGS_BASE) -O2 -g
 
-# Flags de link
-LDFLAGS_BASE = -lgdi32 -luser32 -lkernel32
+# Flags de link (la fenêtre GDI n'existe que sous Windows)
+ifeq ($(OS), Windows_NT)
+    LDFLAGS_BASE = -lgdi32 -luser32 -lkernel32
+else ifeq ($(shell uname -s), Darwin)
+    LDFLAGS_BASE = -lpthread
+else
+    LDFLAGS_BASE = -lpthread -lrt
+endif
 LDFLAGS_RELEASE = $(LDFLAGS_BASE) -flto
 LDFLAGS ?= $(LDFLAGS_BASE)
 
@@ -30,6 +36,9 @@ LOGS_DIR = logs
 
 # Fichiers sources
 SOURCES = $(wildcard $(SRC_DIR)/*.c)
+ifneq ($(OS), Windows_NT)
+    SOURCES := $(filter-out $(SRC_DIR)/graphics_win32.c $(SRC_DIR)/video_win32.c $(SRC_DIR)/emulator_win32.c, $(SOURCES))
+endif
 HEADERS = $(wildcard $(SRC_DIR)/*.h)
 
 # Programmes cibles
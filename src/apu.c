@@ -1,46 +1,136 @@
 #include "apu.h"
-#include <math.h>
 #include <string.h>
 
-// Patterns de duty cycle pour les canaux Square
-static const u8 DUTY_PATTERNS[4][8] = {
-    {0, 0, 0, 0, 0, 0, 0, 1}, // 12.5%
-    {1, 0, 0, 0, 0, 0, 0, 1}, // 25%
-    {1, 0, 0, 0, 0, 1, 1, 1}, // 50%
-    {0, 1, 1, 1, 1, 1, 1, 0}  // 75%
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Patterns de duty cycle pour les canaux Square: bit i = niveau à la
+// position i
+static const u8 DUTY_MASKS[4] = {
+    0x80, // 12.5% 00000001
+    0x81, // 25%   10000001
+    0xE1, // 50%   10000111
+    0x7E  // 75%   01111110
 };
 
+// Diviseurs du canal Noise (NR43 bits 0-2), en cycles avant décalage
+static const u8 NOISE_DIVISORS[8] = {8, 16, 32, 48, 64, 80, 96, 112};
+
+// Sorties du LFSR (bit 0 inversé) sur une période complète depuis l'état
+// de déclenchement, un bit par pas. Prolongées de 64 bits pour lire une
+// fenêtre de 32 pas sans gérer le bouclage.
+#define NOISE_SEQ15_WORDS ((APU_NOISE_PERIOD_15 + 64 + 31) / 32)
+#define NOISE_SEQ7_WORDS ((APU_NOISE_PERIOD_7 + 64 + 31) / 32)
+static u32 noise_seq15[NOISE_SEQ15_WORDS];
+static u32 noise_seq7[NOISE_SEQ7_WORDS];
+static bool noise_tables_ready = false;
+
+#define APU_SEQUENCER_PERIOD 8192  // 4194304 / 512
+#define APU_FRAME_CLOCKS 70224     // Une frame LCD: longueur maximale d'une frame audio
+#define APU_HPF_CHARGE_Q30 1073696729  // 0.999958 (charge conservée par cycle, DMG) en Q30
+
+static void apu_update_outputs(APU* apu);
+static void apu_close_frame(APU* apu);
+static void apu_sync_to(APU* apu, u64 target);
+static void apu_sweep_schedule(APU* apu);
+
+// Déroule le LFSR de width bits (rétroaction XOR des bits 0 et 1 vers le
+// bit de poids fort) et range sa sortie dans seq
+static void apu_build_noise_sequence(u32* seq, u32 period, u32 width) {
+    u32 lfsr = (1u << width) - 1;
+    for (u32 i = 0; i < period + 64; i++) {
+        u32 bit;
+        if (i < period) {
+            bit = ~lfsr & 1;
+            u32 feedback = (lfsr ^ (lfsr >> 1)) & 1;
+            lfsr = (lfsr >> 1) | (feedback << (width - 1));
+        } else {
+            bit = (seq[(i - period) >> 5] >> ((i - period) & 31)) & 1;
+        }
+        if (i % 32 == 0) seq[i >> 5] = 0;
+        seq[i >> 5] |= bit << (i & 31);
+    }
+}
+
+static void apu_build_tables(void) {
+    if (noise_tables_ready) return;
+    // Mode 7 bits: le bit 6 reçoit aussi la rétroaction, les bits 0-6
+    // forment un LFSR indépendant du reste du registre
+    apu_build_noise_sequence(noise_seq15, APU_NOISE_PERIOD_15, 15);
+    apu_build_noise_sequence(noise_seq7, APU_NOISE_PERIOD_7, 7);
+    noise_tables_ready = true;
+}
+
+// Facteur du passe-haut pour sample_rate: 0.999958 ^ (cycles par échantillon)
+static void apu_set_hpf(APU* apu, u32 sample_rate) {
+    u64 factor = 1u << 30;
+    for (u32 i = 0; i < GB_FREQ / sample_rate; i++) {
+        factor = (factor * APU_HPF_CHARGE_Q30) >> 30;
+    }
+    apu->hpf_factor = (s32)(factor >> 14);
+    apu->hpf_charge[0] = 0;
+    apu->hpf_charge[1] = 0;
+}
+
+// Sortie du LFSR après pos pas depuis le déclenchement
+u8 apu_noise_bit(bool short_mode, u32 pos) {
+    const u32* seq = short_mode ? noise_seq7 : noise_seq15;
+    return (seq[pos >> 5] >> (pos & 31)) & 1;
+}
+
+// 32 sorties consécutives à partir de pos (< période)
+static u32 apu_noise_window(const u32* seq, u32 pos) {
+    u32 word = pos >> 5;
+    u32 shift = pos & 31;
+    if (shift == 0) return seq[word];
+    return (seq[word] >> shift) | (seq[word + 1] << (32 - shift));
+}
+
+// Canaux à zéro, périodes par défaut (registres de fréquence nuls)
+static void apu_reset_channels(APU* apu) {
+    memset(&apu->square1, 0, sizeof(SquareChannel));
+    memset(&apu->square2, 0, sizeof(SquareChannel));
+    memset(&apu->wave, 0, sizeof(WaveChannel));
+    memset(&apu->noise, 0, sizeof(NoiseChannel));
+    apu->noise.lfsr_entry = 0x7FFF;
+    
+    apu->square1.frequency = apu_calculate_frequency(0, 0);
+    apu->square2.frequency = apu_calculate_frequency(0, 0);
+    apu->wave.frequency = apu_calculate_frequency(0, 0);
+    apu->wave.frequency /= 2;
+    apu->noise.frequency = NOISE_DIVISORS[0];
+}
+
 // Initialisation de l'APU
 void apu_init(APU* apu) {
     memset(apu, 0, sizeof(APU));
+    apu_build_tables();
     
     // Configuration par défaut
     apu->sample_rate = 44100;
-    apu->buffer_size = 1024;
-    apu->audio_buffer = malloc(apu->buffer_size * 2 * sizeof(s16)); // Stéréo
+    apu_set_hpf(apu, apu->sample_rate);
     
     // Initialisation des canaux
-    memset(&apu->square1, 0, sizeof(SquareChannel));
-    memset(&apu->square2, 0, sizeof(SquareChannel));
-    memset(&apu->wave, 0, sizeof(WaveChannel));
-    memset(&apu->noise, 0, sizeof(NoiseChannel));
+    apu_reset_channels(apu);
     
     // Valeurs par défaut des registres
     apu->nr50 = 0x77; // Volume max, pas de vin
     apu->nr51 = 0xF3; // Tous les canaux activés
-    apu->nr52 = 0xF1; // APU activé, tous les canaux activés
+    apu->nr52 = 0x80; // APU activé (bits 0-3 lus depuis les canaux)
     
     apu->apu_enabled = true;
     apu->frame_sequencer = 0;
-    apu->sample_counter = 0;
-    apu->buffer_position = 0;
+    apu->sequencer_step = 0;
 }
 
 // Nettoyage de l'APU
 void apu_cleanup(APU* apu) {
-    if (apu->audio_buffer) {
-        free(apu->audio_buffer);
-        apu->audio_buffer = NULL;
+    if (apu->output_enabled) {
+        for (int c = 0; c < 4; c++) {
+            blip_cleanup(&apu->blip[c]);
+        }
+        apu->output_enabled = false;
     }
 }
 
@@ -50,180 +140,613 @@ void apu_reset(APU* apu) {
     apu->nr51 = 0x00;
     apu->nr52 = 0x00;
     
-    memset(&apu->square1, 0, sizeof(SquareChannel));
-    memset(&apu->square2, 0, sizeof(SquareChannel));
-    memset(&apu->wave, 0, sizeof(WaveChannel));
-    memset(&apu->noise, 0, sizeof(NoiseChannel));
+    apu_reset_channels(apu);
     
     apu->apu_enabled = false;
     apu->frame_sequencer = 0;
-    apu->sample_counter = 0;
-    apu->buffer_position = 0;
+    apu->sequencer_step = 0;
+    apu_update_outputs(apu);
+    apu_sweep_schedule(apu);
+}
+
+// Active la synthèse vers sample_rate (tampons de APU_BUFFER_MS)
+bool apu_enable_output(APU* apu, u32 sample_rate) {
+    apu_sync(apu);
+    apu_cleanup(apu);
+    
+    u32 capacity = sample_rate * APU_BUFFER_MS / 1000 + 1;
+    for (int c = 0; c < 4; c++) {
+        if (!blip_init(&apu->blip[c], capacity)) {
+            while (--c >= 0) {
+                blip_cleanup(&apu->blip[c]);
+            }
+            return false;
+        }
+        blip_set_rates(&apu->blip[c], GB_FREQ, sample_rate);
+        apu->amp[c] = 0;
+    }
+    apu->sample_rate = sample_rate;
+    apu_set_hpf(apu, sample_rate);
+    apu->frame_time = 0;
+    apu->dropped_samples = 0;
+    apu->output_enabled = true;
+    
+    // Niveaux courants émis au début du flux
+    apu_update_outputs(apu);
+    return true;
 }
 
 // Calcul de la fréquence
 u16 apu_calculate_frequency(u8 freq_lo, u8 freq_hi) {
-    u16 freq = (freq_hi << 8) | freq_lo;
+    u16 freq = ((freq_hi & 0x07) << 8) | freq_lo;
     return (2048 - freq) * 4; // Période en cycles
 }
 
+// Calcul du sweep: shadow ± shadow >> décalage, overflow au-delà de 2047.
+// Un calcul en soustraction est mémorisé (voir l'écriture de NR10).
+u16 apu_sweep_calculate(SquareChannel* ch, bool* overflow) {
+    u16 delta = ch->shadow_frequency >> (ch->sweep & 0x07);
+    u16 freq;
+    if (ch->sweep & 0x08) {
+        freq = ch->shadow_frequency - delta;
+        ch->sweep_negated = true;
+    } else {
+        freq = ch->shadow_frequency + delta;
+    }
+    *overflow = freq > 2047;
+    return freq;
+}
+
+// Déclenchement du canal 1: copie de la fréquence, calcul immédiat si le
+// décalage est non nul (overflow = canal coupé d'emblée)
+static void apu_sweep_trigger(SquareChannel* ch) {
+    u8 period = (ch->sweep >> 4) & 0x07;
+    u8 shift = ch->sweep & 0x07;
+    ch->shadow_frequency = ((ch->freq_hi & 0x07) << 8) | ch->freq_lo;
+    ch->sweep_timer = period ? period : 8;
+    ch->sweep_enabled = period != 0 || shift != 0;
+    ch->sweep_negated = false;
+    if (shift != 0) {
+        bool overflow;
+        apu_sweep_calculate(ch, &overflow);
+        if (overflow) ch->enabled = false;
+    }
+}
+
+// Pas du sweep (128 Hz): nouvelle fréquence réécrite dans NR13/NR14 puis
+// second calcul pour le seul contrôle d'overflow
+static void apu_sweep_clock(SquareChannel* ch) {
+    if (!ch->enabled || !ch->sweep_enabled) return;
+    if (--ch->sweep_timer > 0) return;
+    
+    u8 period = (ch->sweep >> 4) & 0x07;
+    ch->sweep_timer = period ? period : 8;
+    if (period == 0) return;
+    
+    bool overflow;
+    u16 freq = apu_sweep_calculate(ch, &overflow);
+    if (overflow) {
+        ch->enabled = false;
+        return;
+    }
+    if ((ch->sweep & 0x07) == 0) return;
+    
+    ch->shadow_frequency = freq;
+    ch->freq_lo = freq & 0xFF;
+    ch->freq_hi = (ch->freq_hi & 0xF8) | (freq >> 8);
+    ch->frequency = apu_calculate_frequency(ch->freq_lo, ch->freq_hi);
+    apu_sweep_calculate(ch, &overflow);
+    if (overflow) ch->enabled = false;
+}
+
+static bool apu_sweep_active(const APU* apu) {
+    return apu->apu_enabled && apu->square1.enabled && apu->square1.sweep_enabled;
+}
+
 // Obtention du pattern de duty
 u8 apu_get_duty_pattern(u8 duty) {
     return (duty >> 6) & 0x03;
 }
 
-// Mise à jour de l'envelope pour les canaux Square
-void apu_update_envelope(SquareChannel* ch) {
-    if (ch->envelope_period == 0) return;
+// Écriture NRx2: volume initial, direction, période
+void apu_envelope_write(Envelope* env, u8 value) {
+    env->initial = (value >> 4) & 0x0F;
+    env->increasing = (value & 0x08) != 0;
+    env->period = value & 0x07;
+    env->timer = env->period;
+    env->volume = env->initial;
+}
+
+// Déclenchement: le volume repart du volume initial
+void apu_envelope_trigger(Envelope* env) {
+    env->volume = env->initial;
+    env->timer = env->period;
+}
+
+// steps pas de l'envelope (64 Hz) d'un coup: un réglage toutes les period
+// pas, le premier après timer pas
+void apu_envelope_advance(Envelope* env, u32 steps) {
+    if (env->period == 0 || steps == 0) return;
+    if (steps < env->timer) {
+        env->timer -= steps;
+        return;
+    }
     
-    ch->envelope_timer--;
-    if (ch->envelope_timer == 0) {
-        ch->envelope_timer = ch->envelope_period;
-        
-        if (ch->envelope_increasing && ch->envelope_volume < 15) {
-            ch->envelope_volume++;
-        } else if (!ch->envelope_increasing && ch->envelope_volume > 0) {
-            ch->envelope_volume--;
-        }
-        
-        ch->volume = ch->envelope_volume;
+    u32 changes = (steps - env->timer) / env->period + 1;
+    env->timer = env->period - (steps - env->timer) % env->period;
+    if (env->increasing) {
+        env->volume = changes >= 15u - env->volume ? 15 : env->volume + changes;
+    } else {
+        env->volume = changes >= env->volume ? 0 : env->volume - changes;
     }
 }
 
-// Mise à jour de l'envelope pour le canal Noise
-void apu_update_envelope_noise(NoiseChannel* ch) {
-    if (ch->envelope_period == 0) return;
-    
-    ch->envelope_timer--;
-    if (ch->envelope_timer == 0) {
-        ch->envelope_timer = ch->envelope_period;
-        
-        if (ch->envelope_increasing && ch->envelope_volume < 15) {
-            ch->envelope_volume++;
-        } else if (!ch->envelope_increasing && ch->envelope_volume > 0) {
-            ch->envelope_volume--;
-        }
-        
-        ch->volume = ch->envelope_volume;
+// clocks pas de longueur (256 Hz), comptés seulement si NRx4 bit 6 est
+// actif; vrai si le compteur vient d'expirer (canal à couper)
+bool apu_length_advance(u16* counter, bool length_enabled, u32 clocks) {
+    if (!length_enabled || *counter == 0 || clocks == 0) return false;
+    if (clocks < *counter) {
+        *counter -= clocks;
+        return false;
     }
+    *counter = 0;
+    return true;
+}
+
+// Niveau numérique (0-15) d'un canal Square
+static u8 apu_square_level(const SquareChannel* ch) {
+    if (!ch->enabled || !ch->dac_enabled) return 0;
+    return ((DUTY_MASKS[ch->duty_cycle] >> ch->duty_position) & 1) * ch->env.volume;
+}
+
+// Niveau du canal Wave: NR32 = muet, 100%, 50%, 25%
+static u8 apu_wave_level(const WaveChannel* ch) {
+    if (!ch->enabled || !ch->dac_enabled) return 0;
+    u8 output_level = (ch->output_level >> 5) & 0x03;
+    if (output_level == 0) return 0;
+    return ch->sample_buffer >> (output_level - 1);
+}
+
+// Niveau du canal Noise: bit 0 du LFSR inversé (bloqué à 0 -> sortie 1)
+static u8 apu_noise_level(const NoiseChannel* ch) {
+    if (!ch->enabled || !ch->dac_enabled) return 0;
+    if (ch->lfsr_locked) return ch->env.volume;
+    return apu_noise_bit(ch->lfsr_short, ch->lfsr_pos) * ch->env.volume;
+}
+
+// Bit 0 du registre offset pas après la position courante (offset > -period)
+static u32 apu_noise_register_bit(const NoiseChannel* ch, s32 offset) {
+    if (ch->lfsr_locked) return 0;
+    s32 period = ch->lfsr_short ? APU_NOISE_PERIOD_7 : APU_NOISE_PERIOD_15;
+    s32 pos = ((s32)ch->lfsr_pos + offset + period) % period;
+    return !apu_noise_bit(ch->lfsr_short, (u32)pos);
 }
 
-// Mise à jour du compteur de longueur pour Square
-void apu_update_length_counter(SquareChannel* ch) {
-    if (ch->length_counter > 0) {
-        ch->length_counter--;
-        if (ch->length_counter == 0) {
-            ch->enabled = false;
+// Registre de 15 bits à la position courante. Les bits ne font que
+// descendre: le bit k vaut le bit 0 k pas plus tard (bits 0-14 en mode 15
+// bits, 0-6 en mode 7 bits). En mode 7 bits, le bit 14 reçoit la même
+// rétroaction que le bit 6: le bit 14-j vaut le bit 0 6-j pas plus tard si
+// ce pas a eu lieu dans le mode, sinon le registre d'entrée décalé.
+static u16 apu_noise_register(const NoiseChannel* ch) {
+    u32 lfsr = 0;
+    u32 low_bits = ch->lfsr_short ? 7 : 15;
+    for (u32 k = 0; k < low_bits; k++) {
+        lfsr |= apu_noise_register_bit(ch, (s32)k) << k;
+    }
+    if (ch->lfsr_short) {
+        for (u32 j = 0; j < 8; j++) {
+            u32 bit = ch->lfsr_run > j ? apu_noise_register_bit(ch, 6 - (s32)j)
+                                       : (ch->lfsr_entry >> (14 - j + ch->lfsr_run)) & 1;
+            lfsr |= bit << (14 - j);
         }
     }
+    return (u16)lfsr;
 }
 
-// Mise à jour du compteur de longueur pour Wave
-void apu_update_length_counter_wave(WaveChannel* ch) {
-    if (ch->length_counter > 0) {
-        ch->length_counter--;
-        if (ch->length_counter == 0) {
-            ch->enabled = false;
+// Place le canal sur l'état lfsr dans la séquence du mode courant: chaque
+// état non nul y apparaît une fois, identifié par ses sorties à venir.
+// Mode 7 bits avec bits 0-6 à 0: la rétroaction reste nulle, LFSR bloqué.
+static void apu_noise_seek(NoiseChannel* ch, u16 lfsr) {
+    u32 width = ch->lfsr_short ? 7 : 15;
+    u32 period = ch->lfsr_short ? APU_NOISE_PERIOD_7 : APU_NOISE_PERIOD_15;
+    const u32* seq = ch->lfsr_short ? noise_seq7 : noise_seq15;
+    u32 mask = (1u << width) - 1;
+    u32 outputs = ~(u32)lfsr & mask;
+
+    ch->lfsr_entry = lfsr;
+    ch->lfsr_run = 0;
+    ch->lfsr_pos = 0;
+    ch->lfsr_locked = (lfsr & mask) == 0;
+    if (ch->lfsr_locked) return;
+    for (u32 pos = 0; pos < period; pos++) {
+        if ((apu_noise_window(seq, pos) & mask) == outputs) {
+            ch->lfsr_pos = (u16)pos;
+            return;
         }
     }
 }
 
-// Mise à jour du compteur de longueur pour Noise
-void apu_update_length_counter_noise(NoiseChannel* ch) {
-    if (ch->length_counter > 0) {
-        ch->length_counter--;
-        if (ch->length_counter == 0) {
-            ch->enabled = false;
-        }
+static u8 apu_channel_level(const APU* apu, int c) {
+    switch (c) {
+        case CHANNEL_1: return apu_square_level(&apu->square1);
+        case CHANNEL_2: return apu_square_level(&apu->square2);
+        case CHANNEL_3: return apu_wave_level(&apu->wave);
+        default:        return apu_noise_level(&apu->noise);
     }
 }
 
+static bool apu_channel_dac(const APU* apu, int c) {
+    switch (c) {
+        case CHANNEL_1: return apu->square1.dac_enabled;
+        case CHANNEL_2: return apu->square2.dac_enabled;
+        case CHANNEL_3: return apu->wave.dac_enabled;
+        default:        return apu->noise.dac_enabled;
+    }
+}
+
+// Sortie du DAC: bipolaire, niveau 0 -> -7.5 pas, 15 -> +7.5 pas; un canal
+// arrêté DAC allumé sort le niveau 0 (continu, retiré par le passe-haut);
+// DAC éteint, 0
+static s32 apu_channel_amp(const APU* apu, int c) {
+    if (!apu->apu_enabled || !apu_channel_dac(apu, c)) return 0;
+    return (2 * (s32)apu_channel_level(apu, c) - 15) * (APU_AMP_SCALE / 2);
+}
+
+// Émet le changement de sortie d'un canal à l'instant time de la frame audio
+static void apu_emit(APU* apu, int c, u32 time) {
+    s32 amp = apu_channel_amp(apu, c);
+    if (amp != apu->amp[c]) {
+        blip_add_delta(&apu->blip[c], time, amp - apu->amp[c]);
+        apu->amp[c] = amp;
+    }
+}
+
+// Niveaux de tous les canaux à l'instant courant (après une écriture de
+// registre ou un pas du frame sequencer)
+static void apu_update_outputs(APU* apu) {
+    if (!apu->output_enabled) return;
+    for (int c = 0; c < 4; c++) {
+        apu_emit(apu, c, apu->frame_time);
+    }
+}
+
+// Les canaux avancent de cycles à partir de frame_time. Le premier pas
+// tombe à period_counter, les suivants toutes les frequency cycles: le
+// nombre de pas d'un intervalle est une division, et seuls les pas qui
+// changent le niveau sont émis, à leur instant exact.
+
+// Pas dans cycles pour un canal dont le prochain pas est à first (0 si
+// aucun); period_counter est reporté au pas suivant
+static u32 apu_channel_steps(s32* period_counter, u32 frequency, u32 cycles) {
+    s32 first = *period_counter;
+    if (first > (s32)cycles) {
+        *period_counter -= (s32)cycles;
+        return 0;
+    }
+    u32 rest = cycles - (u32)first;
+    u32 steps = rest < frequency ? 1 : rest / frequency + 1;
+    *period_counter = first + (s32)(steps * frequency) - (s32)cycles;
+    return steps;
+}
+
+// Pas avant le prochain changement de niveau du motif mask depuis pos
+static u32 square_next_change(u8 mask, u8 pos) {
+    u32 rotated = ((u32)mask | ((u32)mask << 8)) >> pos;  // bit j = niveau à pos + j
+    u32 diff = (rotated ^ (0u - (rotated & 1))) & 0xFE;
+    return (u32)__builtin_ctz(diff);
+}
+
 // Tick du canal Square
-void square_channel_tick(SquareChannel* ch, u8 cycles) {
+static void square_channel_tick(APU* apu, SquareChannel* ch, int c, u32 cycles) {
     if (!ch->enabled || !ch->dac_enabled) return;
     
-    ch->period_counter -= cycles;
-    if (ch->period_counter <= 0) {
-        ch->period_counter += ch->frequency;
-        ch->duty_position = (ch->duty_position + 1) & 7;
+    s32 first = ch->period_counter;
+    u32 steps = apu_channel_steps(&ch->period_counter, ch->frequency, cycles);
+    if (steps == 0) return;
+    
+    u8 start = ch->duty_position;
+    if (apu->output_enabled && ch->env.volume > 0) {
+        // D'un front du motif au suivant (2 par cycle de 8 pas)
+        u8 mask = DUTY_MASKS[ch->duty_cycle];
+        u32 done = 0;
+        for (;;) {
+            u32 next = square_next_change(mask, (u8)((start + done) & 7));
+            if (done + next > steps) break;
+            done += next;
+            ch->duty_position = (start + done) & 7;
+            apu_emit(apu, c, apu->frame_time + (u32)first + (done - 1) * ch->frequency);
+        }
     }
+    ch->duty_position = (start + steps) & 7;
 }
 
-// Tick du canal Wave
-void wave_channel_tick(WaveChannel* ch, u8 cycles) {
+// Lire l'échantillon courant depuis la wave RAM
+static void wave_channel_load_sample(WaveChannel* ch) {
+    u8 wave_byte = ch->wave_ram[ch->wave_position / 2];
+    if (ch->wave_position & 1) {
+        ch->sample_buffer = wave_byte & 0x0F;
+    } else {
+        ch->sample_buffer = (wave_byte >> 4) & 0x0F;
+    }
+}
+
+// Tick du canal Wave: la wave RAM est modifiable, pas de table; muet ou
+// sans sortie, tous les pas d'un coup
+static void wave_channel_tick(APU* apu, WaveChannel* ch, u32 cycles) {
     if (!ch->enabled || !ch->dac_enabled) return;
     
-    ch->period_counter -= cycles;
-    if (ch->period_counter <= 0) {
-        ch->period_counter += ch->frequency;
+    s32 first = ch->period_counter;
+    u32 steps = apu_channel_steps(&ch->period_counter, ch->frequency, cycles);
+    if (steps == 0) return;
+    
+    if (!apu->output_enabled || (ch->output_level & 0x60) == 0) {
+        ch->wave_position = (ch->wave_position + steps) & 31;
+        wave_channel_load_sample(ch);
+        return;
+    }
+    for (u32 i = 0; i < steps; i++) {
         ch->wave_position = (ch->wave_position + 1) & 31;
-        
-        // Lire l'échantillon depuis la wave RAM
-        u8 wave_byte = ch->wave_ram[ch->wave_position / 2];
-        if (ch->wave_position & 1) {
-            ch->sample_buffer = wave_byte & 0x0F;
-        } else {
-            ch->sample_buffer = (wave_byte >> 4) & 0x0F;
+        wave_channel_load_sample(ch);
+        apu_emit(apu, CHANNEL_3, apu->frame_time + (u32)first + i * ch->frequency);
+    }
+}
+
+// Tick du canal Noise: la position avance dans la séquence précalculée;
+// avec sortie, les changements de niveau se lisent 32 pas à la fois
+static void noise_channel_tick(APU* apu, NoiseChannel* ch, u32 cycles) {
+    if (!ch->enabled || !ch->dac_enabled || ch->frequency == 0) return;
+    
+    s32 first = ch->period_counter;
+    u32 steps = apu_channel_steps(&ch->period_counter, ch->frequency, cycles);
+    if (steps == 0) return;
+    ch->lfsr_run = (u8)(steps >= 8 || ch->lfsr_run + steps >= 8 ? 8 : ch->lfsr_run + steps);
+    if (ch->lfsr_locked) return;
+    
+    u32 period = ch->lfsr_short ? APU_NOISE_PERIOD_7 : APU_NOISE_PERIOD_15;
+    u32 start = ch->lfsr_pos;
+    if (apu->output_enabled && ch->env.volume > 0) {
+        const u32* seq = ch->lfsr_short ? noise_seq7 : noise_seq15;
+        u32 pos = start;
+        u32 level = apu_noise_bit(ch->lfsr_short, pos);
+        u32 done = 0;
+        for (;;) {
+            u32 next_pos = pos + 1 < period ? pos + 1 : 0;
+            u32 diff = apu_noise_window(seq, next_pos) ^ (0u - level);
+            u32 next = diff ? (u32)__builtin_ctz(diff) + 1 : 32;
+            if (done + next > steps) break;
+            done += next;
+            pos += next;
+            if (pos >= period) pos -= period;
+            if (diff) {
+                level ^= 1;
+                ch->lfsr_pos = (u16)pos;
+                apu_emit(apu, CHANNEL_4, apu->frame_time + (u32)first + (done - 1) * ch->frequency);
+            }
         }
     }
+    ch->lfsr_pos = (u16)((start + steps) % period);
 }
 
-// Tick du canal Noise
-void noise_channel_tick(NoiseChannel* ch, u8 cycles) {
-    if (!ch->enabled || !ch->dac_enabled) return;
+// Pas du frame sequencer dont l'indice (0-7) est dans mask, parmi count
+// pas à partir de l'indice start
+static u32 apu_sequencer_count(u8 start, u32 count, u8 mask) {
+    u32 total = (count / 8) * (u32)__builtin_popcount(mask);
+    for (u32 i = 0; i < count % 8; i++) {
+        total += (mask >> ((start + i) & 7)) & 1;
+    }
+    return total;
+}
+
+// steps pas du frame sequencer (512 Hz): longueur aux pas pairs (256 Hz),
+// envelope au pas 7 (64 Hz). Compteurs indépendants: chacun avance de son
+// nombre de pas d'un coup.
+static void apu_sequencer_advance(APU* apu, u32 steps) {
+    // Sweep sans ordonnanceur: pas à pas (pas 2 et 6, 128 Hz), il peut
+    // couper le canal 1 entre deux pas de longueur
+    if (!apu->scheduler && apu_sweep_active(apu) && steps > 1) {
+        for (u32 i = 0; i < steps; i++) {
+            apu_sequencer_advance(apu, 1);
+        }
+        return;
+    }
     
-    ch->period_counter -= cycles;
-    if (ch->period_counter <= 0) {
-        ch->period_counter += ch->frequency;
-        
-        // LFSR (Linear Feedback Shift Register)
-        u16 feedback = (ch->lfsr ^ (ch->lfsr >> 1)) & 1;
-        ch->lfsr = (ch->lfsr >> 1) | (feedback << 14);
-        
-        // Le bit 0 du LFSR détermine l'output
-        ch->sample_buffer = (ch->lfsr & 1) ? 1 : 0;
+    u8 start = apu->sequencer_step;
+    apu->sequencer_step = (u8)((start + steps) & 7);
+    
+    u32 length_clocks = apu_sequencer_count(start, steps, 0x55);
+    if (apu_length_advance(&apu->square1.length_counter, apu->square1.length_enabled, length_clocks)) {
+        apu->square1.enabled = false;
+    }
+    if (apu_length_advance(&apu->square2.length_counter, apu->square2.length_enabled, length_clocks)) {
+        apu->square2.enabled = false;
+    }
+    if (apu_length_advance(&apu->wave.length_counter, apu->wave.length_enabled, length_clocks)) {
+        apu->wave.enabled = false;
+    }
+    if (apu_length_advance(&apu->noise.length_counter, apu->noise.length_enabled, length_clocks)) {
+        apu->noise.enabled = false;
+    }
+    
+    u32 envelope_clocks = apu_sequencer_count(start, steps, 0x80);
+    apu_envelope_advance(&apu->square1.env, envelope_clocks);
+    apu_envelope_advance(&apu->square2.env, envelope_clocks);
+    apu_envelope_advance(&apu->noise.env, envelope_clocks);
+    
+    if (!apu->scheduler && steps == 1 && (start & 3) == 2) {
+        apu_sweep_clock(&apu->square1);
     }
 }
 
-// Tick principal de l'APU
-void apu_tick(APU* apu, u8 cycles) {
-    if (!apu->apu_enabled) return;
+// Avance l'APU de cycles, découpés aux pas du frame sequencer
+static void apu_advance(APU* apu, u32 cycles) {
+    if (!apu->apu_enabled) {
+        // APU éteint: silence, mais le temps de sortie avance
+        apu->frame_time += cycles;
+        cycles = 0;
+    } else if (!apu->output_enabled) {
+        // Sans sortie: aucune forme d'onde, seul l'état visible des
+        // registres (longueurs, envelopes) avance, d'après le nombre de
+        // pas du frame sequencer écoulés
+        u32 elapsed = apu->frame_sequencer + cycles;
+        apu->frame_sequencer = elapsed % APU_SEQUENCER_PERIOD;
+        apu_sequencer_advance(apu, elapsed / APU_SEQUENCER_PERIOD);
+        return;
+    }
     
-    // Frame sequencer (512 Hz)
-    apu->frame_sequencer += cycles;
-    if (apu->frame_sequencer >= 8192) { // 4194304 / 512
-        apu->frame_sequencer -= 8192;
+    while (cycles > 0) {
+        u32 step = APU_SEQUENCER_PERIOD - apu->frame_sequencer;
+        if (step > cycles) step = cycles;
+        
+        square_channel_tick(apu, &apu->square1, CHANNEL_1, step);
+        square_channel_tick(apu, &apu->square2, CHANNEL_2, step);
+        wave_channel_tick(apu, &apu->wave, step);
+        noise_channel_tick(apu, &apu->noise, step);
         
-        // Mise à jour des compteurs de longueur et d'envelope
-        if (apu->frame_sequencer & 1) {
-            // Longueur (256 Hz)
-            apu_update_length_counter(&apu->square1);
-            apu_update_length_counter(&apu->square2);
-            apu_update_length_counter_wave(&apu->wave);
-            apu_update_length_counter_noise(&apu->noise);
+        apu->frame_time += step;
+        apu->frame_sequencer += step;
+        cycles -= step;
+        if (apu->frame_sequencer == APU_SEQUENCER_PERIOD) {
+            apu->frame_sequencer = 0;
+            apu_sequencer_advance(apu, 1);
+            apu_update_outputs(apu);
         }
         
-        if ((apu->frame_sequencer & 3) == 2) {
-            // Envelope (64 Hz)
-            apu_update_envelope(&apu->square1);
-            apu_update_envelope(&apu->square2);
-            apu_update_envelope_noise(&apu->noise);
+        // Long rattrapage: clore des frames en route pour rester dans la
+        // capacité des tampons
+        if (apu->frame_time >= APU_FRAME_CLOCKS) {
+            apu_close_frame(apu);
         }
     }
     
-    // Tick des canaux
-    square_channel_tick(&apu->square1, cycles);
-    square_channel_tick(&apu->square2, cycles);
-    wave_channel_tick(&apu->wave, cycles);
-    noise_channel_tick(&apu->noise, cycles);
+    if (apu->frame_time >= APU_FRAME_CLOCKS) {
+        apu_close_frame(apu);
+    }
+}
+
+// Tick principal de l'APU (avancée explicite, sans horloge maître)
+void apu_tick(APU* apu, u8 cycles) {
+    apu_advance(apu, cycles);
+}
+
+// Rattacher l'APU à l'horloge maître (cycles émulés, croissants)
+void apu_set_clock(APU* apu, const u64* clock) {
+    apu->clock = clock;
+    apu->synced_cycles = clock ? *clock : 0;
+}
+
+// Pas du sweep programmé: l'APU rattrape l'instant exact du pas 2 ou 6
+// du frame sequencer (que l'horloge maître a pu dépasser de quelques
+// cycles), applique le sweep puis programme le suivant
+static void apu_sweep_event(void* user, u64 when) {
+    APU* apu = (APU*)user;
+    apu_sync_to(apu, when);
+    apu_sweep_clock(&apu->square1);
+    apu_update_outputs(apu);
+    apu_sweep_schedule(apu);
+}
+
+// Événement du sweep tant que le canal 1 balaie: prochain pas 2 ou 6 du
+// frame sequencer à partir de l'état rattrapé
+static void apu_sweep_schedule(APU* apu) {
+    if (!apu->scheduler) return;
+    if (!apu_sweep_active(apu)) {
+        scheduler_cancel(apu->scheduler, apu->sweep_event);
+        return;
+    }
+    if (scheduler_when(apu->scheduler, apu->sweep_event) != SCHEDULER_NEVER) return;
+    
+    u32 steps = (u32)((2 - apu->sequencer_step) & 3);
+    u64 when = apu->synced_cycles + (APU_SEQUENCER_PERIOD - apu->frame_sequencer) +
+               (u64)steps * APU_SEQUENCER_PERIOD;
+    scheduler_schedule(apu->scheduler, apu->sweep_event, when);
+}
+
+// Le sweep passe par l'ordonnanceur de la boucle principale; exige une
+// horloge (apu_set_clock) sur laquelle les échéances sont datées
+bool apu_set_scheduler(APU* apu, Scheduler* scheduler) {
+    if (!apu->clock) return false;
+    apu_sync(apu);
+    if (apu->scheduler) {
+        scheduler_cancel(apu->scheduler, apu->sweep_event);
+    }
+    apu->scheduler = NULL;
+    if (scheduler) {
+        int id = scheduler_register(scheduler, apu_sweep_event, apu);
+        if (id < 0) return false;
+        apu->scheduler = scheduler;
+        apu->sweep_event = id;
+        apu_sweep_schedule(apu);
+    }
+    return true;
+}
+
+// Rattraper l'horloge maître
+void apu_sync(APU* apu) {
+    if (!apu->clock) return;
+    apu_sync_to(apu, *apu->clock);
+}
+
+static void apu_sync_to(APU* apu, u64 target) {
+    if (target <= apu->synced_cycles) return;
+    
+    u64 elapsed = target - apu->synced_cycles;
+    apu->synced_cycles = target;
+    while (elapsed > 0) {
+        u32 chunk = elapsed > 0x40000000u ? 0x40000000u : (u32)elapsed;
+        apu_advance(apu, chunk);
+        elapsed -= chunk;
+    }
+}
+
+// Clôt la frame audio: les cycles écoulés deviennent des échantillons
+static void apu_close_frame(APU* apu) {
+    if (!apu->output_enabled) {
+        apu->frame_time = 0;
+        return;
+    }
+    
+    for (int c = 0; c < 4; c++) {
+        blip_end_frame(&apu->blip[c], apu->frame_time);
+    }
+    apu->frame_time = 0;
+    
+    // Sans lecteur, écarter les plus anciens échantillons pour garder la
+    // place d'une frame complète
+    if (blip_max_frame_clocks(&apu->blip[0]) < APU_FRAME_CLOCKS) {
+        u32 drop = blip_samples_avail(&apu->blip[0]) / 2;
+        for (int c = 0; c < 4; c++) {
+            blip_read_samples(&apu->blip[c], NULL, drop, 1);
+        }
+        apu->dropped_samples += drop;
+    }
+}
+
+// Fin de frame émulée: rattrapage puis clôture. Sans sortie audio, rien à
+// produire: l'APU reste en l'état jusqu'au prochain accès.
+void apu_end_frame(APU* apu) {
+    if (!apu->output_enabled) return;
+    apu_sync(apu);
+    apu_close_frame(apu);
+}
+
+// Échantillons prêts (frames audio closes)
+u32 apu_samples_avail(const APU* apu) {
+    if (!apu->output_enabled) return 0;
+    return blip_samples_avail(&apu->blip[0]);
 }
 
 // Écriture dans les registres APU
 void apu_write(APU* apu, u16 address, u8 value) {
+    apu_sync(apu);
     if (!apu->apu_enabled && address != NR52_REG) return;
     
     switch (address) {
         case NR10_REG: // Channel 1 Sweep
+            // Quitter le mode soustraction après un calcul soustractif
+            // depuis le déclenchement coupe le canal
+            if ((apu->square1.sweep & 0x08) && !(value & 0x08) && apu->square1.sweep_negated) {
+                apu->square1.enabled = false;
+            }
             apu->square1.sweep = value;
             break;
             
@@ -235,11 +758,9 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR12_REG: // Channel 1 Envelope
             apu->square1.envelope = value;
-            apu->square1.envelope_volume = (value >> 4) & 0x0F;
-            apu->square1.envelope_increasing = (value & 0x08) != 0;
-            apu->square1.envelope_period = value & 0x07;
-            apu->square1.envelope_timer = apu->square1.envelope_period;
+            apu_envelope_write(&apu->square1.env, value);
             apu->square1.dac_enabled = (value & 0xF8) != 0;
+            if (!apu->square1.dac_enabled) apu->square1.enabled = false;
             break;
             
         case NR13_REG: // Channel 1 Frequency lo
@@ -249,13 +770,16 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR14_REG: // Channel 1 Frequency hi
             apu->square1.freq_hi = value;
+            apu->square1.length_enabled = (value & 0x40) != 0;
             apu->square1.frequency = apu_calculate_frequency(apu->square1.freq_lo, apu->square1.freq_hi);
             if (value & 0x80) {
-                // Trigger
-                apu->square1.enabled = true;
+                // Trigger (sans DAC, le canal reste coupé)
+                apu->square1.enabled = apu->square1.dac_enabled;
+                if (apu->square1.length_counter == 0) apu->square1.length_counter = 64;
                 apu->square1.period_counter = apu->square1.frequency;
                 apu->square1.duty_position = 0;
-                apu->square1.volume = apu->square1.envelope_volume;
+                apu_envelope_trigger(&apu->square1.env);
+                apu_sweep_trigger(&apu->square1);
             }
             break;
             
@@ -267,11 +791,9 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR22_REG: // Channel 2 Envelope
             apu->square2.envelope = value;
-            apu->square2.envelope_volume = (value >> 4) & 0x0F;
-            apu->square2.envelope_increasing = (value & 0x08) != 0;
-            apu->square2.envelope_period = value & 0x07;
-            apu->square2.envelope_timer = apu->square2.envelope_period;
+            apu_envelope_write(&apu->square2.env, value);
             apu->square2.dac_enabled = (value & 0xF8) != 0;
+            if (!apu->square2.dac_enabled) apu->square2.enabled = false;
             break;
             
         case NR23_REG: // Channel 2 Frequency lo
@@ -281,19 +803,22 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR24_REG: // Channel 2 Frequency hi
             apu->square2.freq_hi = value;
+            apu->square2.length_enabled = (value & 0x40) != 0;
             apu->square2.frequency = apu_calculate_frequency(apu->square2.freq_lo, apu->square2.freq_hi);
             if (value & 0x80) {
-                // Trigger
-                apu->square2.enabled = true;
+                // Trigger (sans DAC, le canal reste coupé)
+                apu->square2.enabled = apu->square2.dac_enabled;
+                if (apu->square2.length_counter == 0) apu->square2.length_counter = 64;
                 apu->square2.period_counter = apu->square2.frequency;
                 apu->square2.duty_position = 0;
-                apu->square2.volume = apu->square2.envelope_volume;
+                apu_envelope_trigger(&apu->square2.env);
             }
             break;
             
         case NR30_REG: // Channel 3 Enable
             apu->wave.enable = value;
             apu->wave.dac_enabled = (value & 0x80) != 0;
+            if (!apu->wave.dac_enabled) apu->wave.enabled = false;
             break;
             
         case NR31_REG: // Channel 3 Length
@@ -307,15 +832,17 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR33_REG: // Channel 3 Frequency lo
             apu->wave.freq_lo = value;
-            apu->wave.frequency = apu_calculate_frequency(apu->wave.freq_lo, apu->wave.freq_hi);
+            apu->wave.frequency = apu_calculate_frequency(apu->wave.freq_lo, apu->wave.freq_hi) / 2;
             break;
             
         case NR34_REG: // Channel 3 Frequency hi
             apu->wave.freq_hi = value;
-            apu->wave.frequency = apu_calculate_frequency(apu->wave.freq_lo, apu->wave.freq_hi);
+            apu->wave.length_enabled = (value & 0x40) != 0;
+            apu->wave.frequency = apu_calculate_frequency(apu->wave.freq_lo, apu->wave.freq_hi) / 2;
             if (value & 0x80) {
-                // Trigger
-                apu->wave.enabled = true;
+                // Trigger (sans DAC, le canal reste coupé)
+                apu->wave.enabled = apu->wave.dac_enabled;
+                if (apu->wave.length_counter == 0) apu->wave.length_counter = 256;
                 apu->wave.period_counter = apu->wave.frequency;
                 apu->wave.wave_position = 0;
             }
@@ -328,30 +855,35 @@ void apu_write(APU* apu, u16 address, u8 value) {
             
         case NR42_REG: // Channel 4 Envelope
             apu->noise.envelope = value;
-            apu->noise.envelope_volume = (value >> 4) & 0x0F;
-            apu->noise.envelope_increasing = (value & 0x08) != 0;
-            apu->noise.envelope_period = value & 0x07;
-            apu->noise.envelope_timer = apu->noise.envelope_period;
+            apu_envelope_write(&apu->noise.env, value);
             apu->noise.dac_enabled = (value & 0xF8) != 0;
+            if (!apu->noise.dac_enabled) apu->noise.enabled = false;
             break;
             
         case NR43_REG: // Channel 4 Polynomial
             apu->noise.polynomial = value;
-            // Calcul de la fréquence pour le noise
+            // Période: diviseur << décalage; décalages 14 et 15 arrêtent l'horloge
             u8 shift = (value >> 4) & 0x0F;
-            u8 divisor = value & 0x07;
-            if (divisor == 0) divisor = 8;
-            apu->noise.frequency = (divisor << shift) * 2;
+            apu->noise.frequency = shift < 14 ? (u32)NOISE_DIVISORS[value & 0x07] << shift : 0;
+            // Changement de largeur: le registre est conservé, seule la
+            // rétroaction change; position retrouvée dans l'autre séquence
+            if (((value & 0x08) != 0) != apu->noise.lfsr_short) {
+                u16 lfsr = apu_noise_register(&apu->noise);
+                apu->noise.lfsr_short = (value & 0x08) != 0;
+                apu_noise_seek(&apu->noise, lfsr);
+            }
             break;
             
         case NR44_REG: // Channel 4 Counter
             apu->noise.counter = value;
+            apu->noise.length_enabled = (value & 0x40) != 0;
             if (value & 0x80) {
-                // Trigger
-                apu->noise.enabled = true;
+                // Trigger (sans DAC, le canal reste coupé)
+                apu->noise.enabled = apu->noise.dac_enabled;
+                if (apu->noise.length_counter == 0) apu->noise.length_counter = 64;
                 apu->noise.period_counter = apu->noise.frequency;
-                apu->noise.lfsr = 0x7FFF; // Valeur initiale
-                apu->noise.volume = apu->noise.envelope_volume;
+                apu_noise_seek(&apu->noise, 0x7FFF); // Position 0
+                apu_envelope_trigger(&apu->noise.env);
             }
             break;
             
@@ -364,7 +896,7 @@ void apu_write(APU* apu, u16 address, u8 value) {
             break;
             
         case NR52_REG: // Master enable
-            apu->nr52 = value;
+            apu->nr52 = value & 0x80;
             apu->apu_enabled = (value & 0x80) != 0;
             if (!apu->apu_enabled) {
                 // Désactiver tous les canaux
@@ -382,10 +914,15 @@ void apu_write(APU* apu, u16 address, u8 value) {
             }
             break;
     }
+    
+    // Déclenchement, volume, DAC: nouveau niveau à l'instant de l'écriture
+    apu_update_outputs(apu);
+    apu_sweep_schedule(apu);
 }
 
 // Lecture des registres APU
 u8 apu_read(APU* apu, u16 address) {
+    apu_sync(apu);
     if (!apu->apu_enabled && address != NR52_REG) return 0xFF;
     
     switch (address) {
@@ -434,7 +971,10 @@ u8 apu_read(APU* apu, u16 address) {
         case NR51_REG:
             return apu->nr51;
         case NR52_REG:
-            return apu->nr52 | 0x70;
+            // Bits 0-3: canaux actifs (coupés par longueur, DAC ou sweep)
+            return (apu->nr52 & 0x80) | 0x70 |
+                   (apu->square1.enabled ? 0x01 : 0) | (apu->square2.enabled ? 0x02 : 0) |
+                   (apu->wave.enabled ? 0x04 : 0) | (apu->noise.enabled ? 0x08 : 0);
             
         default:
             // Wave pattern RAM
@@ -445,54 +985,112 @@ u8 apu_read(APU* apu, u16 address) {
     }
 }
 
-// Mélange des canaux audio
-void apu_mix_channels(APU* apu, s16* left, s16* right) {
-    s16 left_sample = 0;
-    s16 right_sample = 0;
-    
-    // Canal 1 (Square 1)
-    if (apu->square1.enabled && apu->square1.dac_enabled) {
-        s16 sample = DUTY_PATTERNS[apu->square1.duty_cycle][apu->square1.duty_position] * apu->square1.volume;
-        if (apu->nr51 & 0x11) left_sample += sample;  // Left
-        if (apu->nr51 & 0x22) right_sample += sample; // Right
+// Mélange des canaux audio: NR51 route chaque canal (bits 4-7 vers la
+// gauche, bits 0-3 vers la droite), NR50 règle le volume de chaque côté
+// ((v + 1) / 8), puis le passe-haut retire la composante continue. Les
+// registres sont appliqués au bloc entier.
+
+// Somme des canaux routés d'un échantillon, pondérée par le volume (x8)
+static s32 apu_mix_sample(s16* const channels[4], const s16 gains[4], u32 i) {
+    s32 sum = 0;
+    for (int c = 0; c < 4; c++) {
+        sum += channels[c][i] * gains[c];
     }
-    
-    // Canal 2 (Square 2)
-    if (apu->square2.enabled && apu->square2.dac_enabled) {
-        s16 sample = DUTY_PATTERNS[apu->square2.duty_cycle][apu->square2.duty_position] * apu->square2.volume;
-        if (apu->nr51 & 0x12) left_sample += sample;  // Left
-        if (apu->nr51 & 0x24) right_sample += sample; // Right
+    return sum;
+}
+
+void apu_mix_channels(APU* apu, s16* const channels[4], s16* out, u32 frames) {
+    s16 left_volume = (s16)(((apu->nr50 >> 4) & 0x07) + 1);
+    s16 right_volume = (s16)((apu->nr50 & 0x07) + 1);
+    s16 left_gains[4], right_gains[4];
+    for (int c = 0; c < 4; c++) {
+        left_gains[c] = (apu->nr51 & (0x10 << c)) ? left_volume : 0;
+        right_gains[c] = (apu->nr51 & (0x01 << c)) ? right_volume : 0;
     }
     
-    // Canal 3 (Wave)
-    if (apu->wave.enabled && apu->wave.dac_enabled) {
-        s16 sample = apu->wave.sample_buffer;
-        u8 output_level = (apu->wave.output_level >> 5) & 0x03;
-        if (output_level > 0) {
-            sample >>= (4 - output_level);
-        } else {
-            sample = 0;
+    // Mixage: gauche/droite entrelacés, à l'échelle x8
+    s32 mixed[APU_MIX_CHUNK * 2];
+    u32 done = 0;
+    while (done < frames) {
+        u32 n = frames - done;
+        if (n > APU_MIX_CHUNK) n = APU_MIX_CHUNK;
+        u32 i = 0;
+#if defined(__SSE2__)
+        // 8 échantillons des 4 canaux par passe: canaux entrelacés par
+        // paires (0,1) et (2,3), pmaddwd applique les deux gains d'un coup
+        __m128i left01 = _mm_set1_epi32((s32)(((u32)(u16)left_gains[1] << 16) | (u16)left_gains[0]));
+        __m128i left23 = _mm_set1_epi32((s32)(((u32)(u16)left_gains[3] << 16) | (u16)left_gains[2]));
+        __m128i right01 = _mm_set1_epi32((s32)(((u32)(u16)right_gains[1] << 16) | (u16)right_gains[0]));
+        __m128i right23 = _mm_set1_epi32((s32)(((u32)(u16)right_gains[3] << 16) | (u16)right_gains[2]));
+        for (; i + 8 <= n; i += 8) {
+            __m128i c0 = _mm_loadu_si128((const __m128i*)(channels[0] + done + i));
+            __m128i c1 = _mm_loadu_si128((const __m128i*)(channels[1] + done + i));
+            __m128i c2 = _mm_loadu_si128((const __m128i*)(channels[2] + done + i));
+            __m128i c3 = _mm_loadu_si128((const __m128i*)(channels[3] + done + i));
+            __m128i lo01 = _mm_unpacklo_epi16(c0, c1);
+            __m128i hi01 = _mm_unpackhi_epi16(c0, c1);
+            __m128i lo23 = _mm_unpacklo_epi16(c2, c3);
+            __m128i hi23 = _mm_unpackhi_epi16(c2, c3);
+            __m128i left_lo = _mm_add_epi32(_mm_madd_epi16(lo01, left01), _mm_madd_epi16(lo23, left23));
+            __m128i left_hi = _mm_add_epi32(_mm_madd_epi16(hi01, left01), _mm_madd_epi16(hi23, left23));
+            __m128i right_lo = _mm_add_epi32(_mm_madd_epi16(lo01, right01), _mm_madd_epi16(lo23, right23));
+            __m128i right_hi = _mm_add_epi32(_mm_madd_epi16(hi01, right01), _mm_madd_epi16(hi23, right23));
+            __m128i* dst = (__m128i*)(mixed + i * 2);
+            _mm_storeu_si128(dst, _mm_unpacklo_epi32(left_lo, right_lo));
+            _mm_storeu_si128(dst + 1, _mm_unpackhi_epi32(left_lo, right_lo));
+            _mm_storeu_si128(dst + 2, _mm_unpacklo_epi32(left_hi, right_hi));
+            _mm_storeu_si128(dst + 3, _mm_unpackhi_epi32(left_hi, right_hi));
+        }
+#endif
+        for (; i < n; i++) {
+            mixed[i * 2] = apu_mix_sample(channels, left_gains, done + i);
+            mixed[i * 2 + 1] = apu_mix_sample(channels, right_gains, done + i);
+        }
+        
+        // Passe-haut: sortie = entrée - charge; la charge suit l'entrée et
+        // se vide de (1 - facteur) par échantillon. Récurrent: scalaire.
+        s16* dst = out + done * 2;
+        for (u32 k = 0; k < n * 2; k++) {
+            s64* charge = &apu->hpf_charge[k & 1];
+            s32 in = mixed[k] / 8;
+            s32 sample = in - (s32)(*charge >> 16);
+            *charge = (s64)in * 65536 - (s64)sample * apu->hpf_factor;
+            if (sample > 32767) sample = 32767;
+            if (sample < -32768) sample = -32768;
+            dst[k] = (s16)sample;
         }
-        if (apu->nr51 & 0x14) left_sample += sample;  // Left
-        if (apu->nr51 & 0x28) right_sample += sample; // Right
+        done += n;
     }
+}
+
+// Rendu audio: clôt la frame en cours puis intègre et mixe jusqu'à frames
+// échantillons stéréo. stems (optionnel) reçoit aussi chaque canal seul,
+// avant routage et volume.
+u32 apu_read_channels(APU* apu, s16* out, s16* const stems[4], u32 frames) {
+    if (!apu->output_enabled) return 0;
+    apu_end_frame(apu);
     
-    // Canal 4 (Noise)
-    if (apu->noise.enabled && apu->noise.dac_enabled) {
-        s16 sample = apu->noise.sample_buffer * apu->noise.volume;
-        if (apu->nr51 & 0x18) left_sample += sample;  // Left
-        if (apu->nr51 & 0x30) right_sample += sample; // Right
+    s16 block[4][APU_MIX_CHUNK];
+    s16* const channels[4] = {block[0], block[1], block[2], block[3]};
+    u32 done = 0;
+    while (done < frames) {
+        u32 n = frames - done;
+        if (n > APU_MIX_CHUNK) n = APU_MIX_CHUNK;
+        if (n > blip_samples_avail(&apu->blip[0])) n = blip_samples_avail(&apu->blip[0]);
+        if (n == 0) break;
+        
+        for (int c = 0; c < 4; c++) {
+            blip_read_samples(&apu->blip[c], block[c], n, 1);
+            if (stems && stems[c]) {
+                memcpy(stems[c] + done, block[c], n * sizeof(s16));
+            }
+        }
+        apu_mix_channels(apu, channels, out + done * 2, n);
+        done += n;
     }
-    
-    // Appliquer le volume master
-    u8 left_volume = (apu->nr50 >> 4) & 0x07;
-    u8 right_volume = apu->nr50 & 0x07;
-    
-    *left = (left_sample * left_volume) / 7;
-    *right = (right_sample * right_volume) / 7;
+    return done;
 }
 
-// Rendu audio
-void apu_render(APU* apu, s16* left, s16* right) {
-    apu_mix_channels(apu, left, right);
+u32 apu_read_samples(APU* apu, s16* out, u32 frames) {
+    return apu_read_channels(apu, out, NULL, frames);
 }
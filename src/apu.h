@@ -2,6 +2,8 @@
 #define APU_H
 
 #include "common.h"
+#include "blip.h"
+#include "scheduler.h"
 
 // Registres audio (0xFF10-0xFF3F)
 #define NR10_REG 0xFF10  // Channel 1 Sweep
@@ -36,6 +38,15 @@ typedef enum {
     CHANNEL_4 = 3   // Noise
 } AudioChannel;
 
+// Envelope de volume (canaux Square et Noise, NRx2)
+typedef struct {
+    u8 volume;       // Volume actuel (0-15)
+    u8 initial;      // Volume au déclenchement
+    u8 period;       // Période en pas de 64 Hz (0 = figée)
+    u8 timer;        // Pas restants avant le prochain réglage
+    bool increasing; // Direction
+} Envelope;
+
 // Structure du canal Square (Channel 1 & 2)
 typedef struct {
     // Registres
@@ -47,15 +58,18 @@ typedef struct {
     
     // État interne
     u16 frequency;      // Fréquence calculée
-    u16 period_counter; // Compteur de période
+    s32 period_counter; // Cycles avant le prochain pas
     u8 duty_cycle;      // Cycle de duty (0-3)
     u8 duty_position;   // Position dans le cycle
-    u8 volume;          // Volume actuel
-    u8 envelope_volume; // Volume de l'envelope
-    u8 envelope_period; // Période de l'envelope
-    u8 envelope_timer;  // Timer de l'envelope
-    bool envelope_increasing; // Direction de l'envelope
+    Envelope env;       // Envelope de volume
+    
+    // Sweep de fréquence (canal 1 seulement, NR10)
+    u16 shadow_frequency; // Copie de travail de la fréquence 11 bits
+    u8 sweep_timer;       // Pas de 128 Hz avant le prochain calcul
+    bool sweep_enabled;   // Actif depuis le déclenchement (période ou décalage non nul)
+    bool sweep_negated;   // Un calcul en soustraction a eu lieu depuis le déclenchement
     u16 length_counter; // Compteur de longueur
+    bool length_enabled; // Longueur active (NRx4 bit 6)
     bool enabled;       // Canal activé
     bool dac_enabled;   // DAC activé
 } SquareChannel;
@@ -74,8 +88,9 @@ typedef struct {
     
     // État interne
     u16 frequency;      // Fréquence calculée
-    u16 period_counter; // Compteur de période
+    s32 period_counter; // Cycles avant le prochain pas
     u16 length_counter; // Compteur de longueur
+    bool length_enabled; // Longueur active (NRx4 bit 6)
     u8 wave_position;   // Position dans la wave
     u8 sample_buffer;   // Buffer d'échantillon
     bool enabled;       // Canal activé
@@ -90,17 +105,21 @@ typedef struct {
     u8 polynomial;  // NR43
     u8 counter;     // NR44
     
-    // État interne
-    u16 lfsr;           // Linear Feedback Shift Register
-    u16 frequency;      // Fréquence calculée
-    u16 period_counter; // Compteur de période
-    u8 volume;          // Volume actuel
-    u8 envelope_volume; // Volume de l'envelope
-    u8 envelope_period; // Période de l'envelope
-    u8 envelope_timer;  // Timer de l'envelope
-    bool envelope_increasing; // Direction de l'envelope
+    // État interne: le LFSR est repéré par sa position dans la séquence
+    // précalculée depuis l'état de déclenchement (tous les bits à 1). Le
+    // registre de 15 bits se reconstruit depuis la position, le registre
+    // d'entrée dans le mode courant et le nombre de pas depuis (bits 7-14
+    // en mode 7 bits); il sert à repositionner au changement de largeur.
+    u16 lfsr_pos;       // Position dans la séquence (< APU_NOISE_PERIOD_*)
+    bool lfsr_short;    // Mode 7 bits (NR43 bit 3)
+    bool lfsr_locked;   // Mode 7 bits avec bits 0-6 à 0: LFSR bloqué
+    u16 lfsr_entry;     // Registre à l'entrée dans le mode courant
+    u8 lfsr_run;        // Pas depuis l'entrée, saturé à 8
+    u32 frequency;      // Période en cycles (0 = horloge arrêtée)
+    s32 period_counter; // Cycles avant le prochain pas
+    Envelope env;       // Envelope de volume
     u16 length_counter; // Compteur de longueur
-    u8 sample_buffer;   // Buffer d'échantillon
+    bool length_enabled; // Longueur active (NRx4 bit 6)
     bool enabled;       // Canal activé
     bool dac_enabled;   // DAC activé
 } NoiseChannel;
@@ -121,39 +140,70 @@ typedef struct {
     // État global
     bool apu_enabled;     // APU activé
     u32 frame_sequencer;  // Compteur du frame sequencer
+    u8 sequencer_step;    // Pas courant du frame sequencer (0-7)
     u32 sample_rate;      // Taux d'échantillonnage
-    u32 sample_counter;   // Compteur d'échantillons
     
-    // Buffer audio
-    s16* audio_buffer;
-    u32 buffer_size;
-    u32 buffer_position;
+    // Synthèse à bande limitée: un tampon par canal, alimenté par les
+    // changements d'amplitude horodatés (inactive tant que output_enabled
+    // est faux: aucun delta n'est alors calculé)
+    bool output_enabled;
+    BlipBuffer blip[4];
+    s32 amp[4];           // Dernière sortie DAC émise par canal
+    u32 frame_time;       // Cycles depuis la dernière fin de frame audio
+    u32 dropped_samples;  // Échantillons écrasés faute de lecture
+    
+    // Filtre passe-haut de sortie (condensateur de couplage): retire la
+    // composante continue des DAC, par côté
+    s32 hpf_factor;       // Charge conservée par échantillon (Q16)
+    s64 hpf_charge[2];    // Charge gauche/droite (Q16)
+    
+    // Rattrapage paresseux: l'APU n'avance qu'à la demande (accès NRxx,
+    // lecture d'échantillons, fin de frame) jusqu'à l'horloge maître.
+    // Sans horloge, seul apu_tick le fait avancer.
+    const u64* clock;
+    u64 synced_cycles;    // Dernier cycle rattrapé
+    
+    // Sweep du canal 1: pas de 128 Hz programmé comme événement daté
+    // (apu_set_scheduler, avec une horloge); sans ordonnanceur, appliqué
+    // au fil des pas du frame sequencer
+    Scheduler* scheduler;
+    int sweep_event;
 } APU;
 
+#define APU_AMP_SCALE 512     // Pas du DAC: niveau 0-15 -> (niveau - 7.5) * APU_AMP_SCALE
+#define APU_SYNTH_RATE 65536  // Taux de synthèse interne (GB_FREQ / 64), rééchantillonné ensuite
+#define APU_BUFFER_MS 100     // Capacité des tampons de synthèse
+#define APU_MIX_CHUNK 256     // Échantillons mixés par passe
+#define APU_NOISE_PERIOD_15 32767  // Période du LFSR 15 bits
+#define APU_NOISE_PERIOD_7 127     // Période du LFSR 7 bits
+
 // Fonctions APU
 void apu_init(APU* apu);
 void apu_cleanup(APU* apu);
 void apu_reset(APU* apu);
 void apu_tick(APU* apu, u8 cycles);
+void apu_set_clock(APU* apu, const u64* clock);
+bool apu_set_scheduler(APU* apu, Scheduler* scheduler);
+void apu_sync(APU* apu);
 void apu_write(APU* apu, u16 address, u8 value);
 u8 apu_read(APU* apu, u16 address);
 
 // Rendu audio
-void apu_render(APU* apu, s16* left, s16* right);
-void apu_mix_channels(APU* apu, s16* left, s16* right);
-
-// Gestion des canaux
-void square_channel_tick(SquareChannel* ch, u8 cycles);
-void wave_channel_tick(WaveChannel* ch, u8 cycles);
-void noise_channel_tick(NoiseChannel* ch, u8 cycles);
+bool apu_enable_output(APU* apu, u32 sample_rate);
+void apu_end_frame(APU* apu);
+u32 apu_samples_avail(const APU* apu);
+u32 apu_read_samples(APU* apu, s16* out, u32 frames);  // Stéréo entrelacé
+u32 apu_read_channels(APU* apu, s16* out, s16* const stems[4], u32 frames);
+void apu_mix_channels(APU* apu, s16* const channels[4], s16* out, u32 frames);
 
 // Utilitaires
 u16 apu_calculate_frequency(u8 freq_lo, u8 freq_hi);
+u16 apu_sweep_calculate(SquareChannel* ch, bool* overflow);
 u8 apu_get_duty_pattern(u8 duty);
-void apu_update_envelope(SquareChannel* ch);
-void apu_update_envelope_noise(NoiseChannel* ch);
-void apu_update_length_counter(SquareChannel* ch);
-void apu_update_length_counter_wave(WaveChannel* ch);
-void apu_update_length_counter_noise(NoiseChannel* ch);
+u8 apu_noise_bit(bool short_mode, u32 pos);
+void apu_envelope_write(Envelope* env, u8 value);
+void apu_envelope_trigger(Envelope* env);
+void apu_envelope_advance(Envelope* env, u32 steps);
+bool apu_length_advance(u16* counter, bool length_enabled, u32 clocks);
 
 #endif // APU_H
@@ -0,0 +1,128 @@
+#include "async_writer.h"
+
+static void async_writer_write_block(AsyncWriter* writer, const AsyncWriterSlot* slot) {
+    if (slot->len == 0 || writer->error) return;
+    if (fwrite(slot->data, 1, slot->len, writer->file) != slot->len) {
+        writer->error = true;
+        return;
+    }
+    writer->bytes_written += slot->len;
+    writer->blocks_written++;
+}
+
+// Thread d'écriture: vide les cases dans l'ordre de soumission
+static void async_writer_thread(void* arg) {
+    AsyncWriter* writer = (AsyncWriter*)arg;
+
+    mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->pending == 0 && !writer->stop) {
+            cond_wait(&writer->not_empty, &writer->lock);
+        }
+        if (writer->pending == 0 && writer->stop) {
+            break;
+        }
+
+        // La case en tête n'est plus touchée par le producteur: écriture hors verrou
+        AsyncWriterSlot* slot = &writer->slots[writer->tail];
+        mutex_unlock(&writer->lock);
+        async_writer_write_block(writer, slot);
+        mutex_lock(&writer->lock);
+
+        writer->tail = (writer->tail + 1) % ASYNC_WRITER_SLOTS;
+        writer->pending--;
+        cond_signal(&writer->not_full);
+    }
+    mutex_unlock(&writer->lock);
+}
+
+bool async_writer_open(AsyncWriter* writer, FILE* file, size_t slot_capacity, bool threaded) {
+    memset(writer, 0, sizeof(AsyncWriter));
+    writer->file = file;
+    writer->slot_capacity = slot_capacity;
+
+    for (int i = 0; i < ASYNC_WRITER_SLOTS; i++) {
+        writer->slots[i].data = malloc(slot_capacity);
+        if (!writer->slots[i].data) {
+            printf("Erreur: impossible d'allouer les tampons d'écriture\n");
+            for (int j = 0; j < i; j++) {
+                free(writer->slots[j].data);
+            }
+            return false;
+        }
+    }
+
+    mutex_init(&writer->lock);
+    cond_init(&writer->not_empty);
+    cond_init(&writer->not_full);
+
+    if (threaded) {
+        writer->threaded = thread_start(&writer->thread, async_writer_thread, writer);
+        if (!writer->threaded) {
+            printf("Avertissement: thread d'écriture indisponible, écriture synchrone\n");
+        }
+    }
+    return true;
+}
+
+// Case libre pour le prochain bloc (attend le thread d'écriture si besoin)
+u8* async_writer_acquire(AsyncWriter* writer) {
+    if (!writer->threaded) {
+        return writer->slots[0].data;
+    }
+
+    mutex_lock(&writer->lock);
+    if (writer->pending == ASYNC_WRITER_SLOTS) {
+        writer->stalls++;
+        while (writer->pending == ASYNC_WRITER_SLOTS) {
+            cond_wait(&writer->not_full, &writer->lock);
+        }
+    }
+    u8* data = writer->slots[writer->head].data;
+    mutex_unlock(&writer->lock);
+    return data;
+}
+
+void async_writer_submit(AsyncWriter* writer, size_t len) {
+    if (len > writer->slot_capacity) {
+        len = writer->slot_capacity;
+    }
+
+    if (!writer->threaded) {
+        writer->slots[0].len = len;
+        async_writer_write_block(writer, &writer->slots[0]);
+        return;
+    }
+
+    mutex_lock(&writer->lock);
+    writer->slots[writer->head].len = len;
+    writer->head = (writer->head + 1) % ASYNC_WRITER_SLOTS;
+    writer->pending++;
+    cond_signal(&writer->not_empty);
+    mutex_unlock(&writer->lock);
+}
+
+bool async_writer_close(AsyncWriter* writer) {
+    if (writer->threaded) {
+        mutex_lock(&writer->lock);
+        writer->stop = true;
+        cond_signal(&writer->not_empty);
+        mutex_unlock(&writer->lock);
+        thread_join(&writer->thread);
+        writer->threaded = false;
+    }
+
+    cond_destroy(&writer->not_full);
+    cond_destroy(&writer->not_empty);
+    mutex_destroy(&writer->lock);
+
+    for (int i = 0; i < ASYNC_WRITER_SLOTS; i++) {
+        free(writer->slots[i].data);
+        writer->slots[i].data = NULL;
+    }
+
+    if (writer->file && fflush(writer->file) != 0) {
+        writer->error = true;
+    }
+    return !writer->error;
+}
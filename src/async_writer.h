@@ -0,0 +1,44 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include "common.h"
+#include "thread.h"
+
+// Écriture différée vers un fichier: le producteur remplit une case
+// (un bloc complet, ex. une frame), le thread d'écriture la vide en un
+// seul fwrite. L'émulation ne bloque que si toutes les cases sont pleines.
+#define ASYNC_WRITER_SLOTS 4
+
+typedef struct {
+    u8* data;
+    size_t len;
+} AsyncWriterSlot;
+
+typedef struct {
+    FILE* file;
+    AsyncWriterSlot slots[ASYNC_WRITER_SLOTS];
+    size_t slot_capacity;
+    u32 head;           // Prochaine case à remplir (producteur)
+    u32 tail;           // Prochaine case à écrire (thread d'écriture)
+    u32 pending;        // Cases remplies pas encore écrites
+
+    bool threaded;      // false: écriture synchrone dans submit
+    bool stop;
+    bool error;
+    Thread thread;
+    Mutex lock;
+    CondVar not_empty;
+    CondVar not_full;
+
+    // Statistiques
+    u64 bytes_written;
+    u32 blocks_written;
+    u32 stalls;         // Attentes du producteur (cases toutes pleines)
+} AsyncWriter;
+
+bool async_writer_open(AsyncWriter* writer, FILE* file, size_t slot_capacity, bool threaded);
+u8* async_writer_acquire(AsyncWriter* writer);
+void async_writer_submit(AsyncWriter* writer, size_t len);
+bool async_writer_close(AsyncWriter* writer);  // Vide les cases; false si erreur d'écriture
+
+#endif // ASYNC_WRITER_H
@@ -0,0 +1,113 @@
+#include "audio.h"
+
+bool audio_output_open(AudioOutput* out, u32 input_rate, u32 sample_rate, u32 latency_ms) {
+    memset(out, 0, sizeof(AudioOutput));
+    out->sample_rate = sample_rate;
+    out->adjust = 1.0;
+    out->latency_frames = sample_rate * latency_ms / 1000;
+    if (out->latency_frames == 0) {
+        out->latency_frames = 1;
+    }
+
+    if (!resampler_init(&out->resampler, input_rate, sample_rate)) {
+        printf("Erreur: impossible d'initialiser le rééchantillonneur\n");
+        return false;
+    }
+    out->scratch = malloc((size_t)resampler_max_output(&out->resampler, AUDIO_PUSH_FRAMES) * 2 * sizeof(s16));
+
+    // Marge pour une frame émulée au-dessus de la latence visée
+    if (!out->scratch || !audio_ring_init(&out->ring, out->latency_frames * 2 + sample_rate / 30)) {
+        printf("Erreur: impossible d'allouer la file audio\n");
+        free(out->scratch);
+        out->scratch = NULL;
+        resampler_cleanup(&out->resampler);
+        return false;
+    }
+    return true;
+}
+
+void audio_output_close(AudioOutput* out) {
+    if (!out->ring.data) return;
+
+    if (out->clocked) {
+        __atomic_store_n(&out->stop, true, __ATOMIC_RELEASE);
+        thread_join(&out->thread);
+        out->clocked = false;
+    }
+    printf("Audio: %u sous-alimentations (%llu frames de silence), %u débordements (%llu frames perdues)\n",
+           out->ring.underruns, (unsigned long long)out->ring.silent_frames,
+           out->ring.overruns, (unsigned long long)out->ring.dropped_frames);
+    audio_ring_cleanup(&out->ring);
+    resampler_cleanup(&out->resampler);
+    free(out->scratch);
+    out->scratch = NULL;
+}
+
+u32 audio_output_push(AudioOutput* out, const s16* frames, u32 count) {
+    u32 written = 0;
+    while (count > 0) {
+        u32 n = count < AUDIO_PUSH_FRAMES ? count : AUDIO_PUSH_FRAMES;
+
+        // File plus pleine que visé: produire un peu moins, et inversement
+        s32 error = (s32)audio_ring_fill(&out->ring) - (s32)out->latency_frames;
+        out->adjust = 1.0 - AUDIO_DRC_STRENGTH * (double)error / (double)out->latency_frames;
+        resampler_set_adjust(&out->resampler, out->adjust);
+
+        u32 produced = resampler_run(&out->resampler, frames, n, out->scratch);
+        written += audio_ring_write(&out->ring, out->scratch, produced);
+        frames += n * 2;
+        count -= n;
+    }
+    return written;
+}
+
+// Attendre que le consommateur ramène la file sous la latence visée
+void audio_output_pace(AudioOutput* out) {
+    u32 fill = audio_ring_fill(&out->ring);
+    u32 waited = 0;
+    while (fill > out->latency_frames && waited < AUDIO_PACE_TIMEOUT_MS) {
+        thread_sleep_ms(1);
+        u32 now = audio_ring_fill(&out->ring);
+        waited = now < fill ? 0 : waited + 1;
+        fill = now;
+    }
+}
+
+void audio_output_callback(void* user, s16* out, u32 frames) {
+    AudioOutput* audio = (AudioOutput*)user;
+    audio_ring_read(&audio->ring, out, frames);
+}
+
+// Horloge simulée: attend que la file atteigne la latence visée, puis tire
+// les frames dues depuis le départ, par tranches de AUDIO_CLOCK_PERIOD_MS
+static void audio_output_clock_main(void* arg) {
+    AudioOutput* out = (AudioOutput*)arg;
+    s16 block[2048 * 2];
+
+    while (audio_ring_fill(&out->ring) < out->latency_frames &&
+           !__atomic_load_n(&out->stop, __ATOMIC_ACQUIRE)) {
+        thread_sleep_ms(1);
+    }
+
+    u64 start = thread_time_us();
+    u64 consumed = 0;
+    while (!__atomic_load_n(&out->stop, __ATOMIC_ACQUIRE)) {
+        u64 due = (thread_time_us() - start) * out->sample_rate / 1000000u;
+        while (consumed < due) {
+            u32 n = due - consumed > 2048 ? 2048 : (u32)(due - consumed);
+            audio_output_callback(out, block, n);
+            consumed += n;
+        }
+        thread_sleep_ms(AUDIO_CLOCK_PERIOD_MS);
+    }
+}
+
+bool audio_output_start_clock(AudioOutput* out) {
+    out->stop = false;
+    if (!thread_start(&out->thread, audio_output_clock_main, out)) {
+        printf("Erreur: impossible de démarrer l'horloge audio\n");
+        return false;
+    }
+    out->clocked = true;
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "common.h"
+#include "audio_ring.h"
+#include "resampler.h"
+#include "thread.h"
+
+// Sortie audio vers l'hôte: l'émulation pousse les frames stéréo mixées
+// dans une file sans verrou, le callback du périphérique audio les tire
+// depuis son propre thread. L'émulation se cale sur cette consommation:
+// audio_output_pace attend tant que la file dépasse la latence visée, au
+// lieu d'une attente active sur l'horloge murale.
+// Les frames arrivent au taux de synthèse de l'APU et sont rééchantillonnées
+// au taux de l'hôte; le rapport est corrigé en continu d'après le
+// remplissage de la file (contrôle dynamique du débit) pour absorber la
+// dérive entre l'horloge émulée et celle du périphérique.
+#define AUDIO_DEFAULT_RATE 48000
+#define AUDIO_DEFAULT_LATENCY_MS 60
+#define AUDIO_CLOCK_PERIOD_MS 5       // Période de l'horloge hôte simulée
+#define AUDIO_PACE_TIMEOUT_MS 500     // Consommateur arrêté: ne plus attendre
+#define AUDIO_PUSH_FRAMES 1024        // Frames d'entrée rééchantillonnées par passe
+#define AUDIO_DRC_STRENGTH 0.005      // Correction du rapport à une latence d'écart
+
+// Signature des callbacks des API audio hôtes (remplir frames frames)
+typedef void (*AudioCallback)(void* user, s16* out, u32 frames);
+
+typedef struct {
+    AudioRing ring;
+    Resampler resampler;  // Taux de synthèse -> taux de l'hôte
+    s16* scratch;         // Sortie du rééchantillonneur avant la file
+    u32 sample_rate;      // Taux de l'hôte
+    u32 latency_frames;   // Remplissage visé de la file
+    double adjust;        // Dernière correction de rapport appliquée
+
+    // Horloge hôte simulée, sans périphérique: un thread consomme la file
+    // au rythme réel (cadence temps réel en headless)
+    bool clocked;
+    bool stop;
+    Thread thread;
+} AudioOutput;
+
+bool audio_output_open(AudioOutput* out, u32 input_rate, u32 sample_rate, u32 latency_ms);
+void audio_output_close(AudioOutput* out);
+
+// Thread d'émulation (frames au taux d'entrée)
+u32 audio_output_push(AudioOutput* out, const s16* frames, u32 count);
+void audio_output_pace(AudioOutput* out);
+
+// Thread audio de l'hôte (user = AudioOutput*)
+void audio_output_callback(void* user, s16* out, u32 frames);
+bool audio_output_start_clock(AudioOutput* out);
+
+#endif // AUDIO_H
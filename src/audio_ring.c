@@ -0,0 +1,76 @@
+#include "audio_ring.h"
+
+bool audio_ring_init(AudioRing* ring, u32 min_frames) {
+    memset(ring, 0, sizeof(AudioRing));
+    u32 capacity = 64;
+    while (capacity < min_frames) {
+        capacity <<= 1;
+    }
+    ring->data = calloc((size_t)capacity * 2, sizeof(s16));
+    if (!ring->data) {
+        return false;
+    }
+    ring->capacity = capacity;
+    return true;
+}
+
+void audio_ring_cleanup(AudioRing* ring) {
+    free(ring->data);
+    ring->data = NULL;
+}
+
+u32 audio_ring_fill(const AudioRing* ring) {
+    u32 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    u32 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
+
+// Copie count frames depuis/vers la position pos, en deux morceaux au
+// passage de la fin du tableau
+static void audio_ring_copy_in(AudioRing* ring, u32 pos, const s16* src, u32 count) {
+    u32 index = pos & (ring->capacity - 1);
+    u32 first = ring->capacity - index;
+    if (first > count) first = count;
+    memcpy(ring->data + (size_t)index * 2, src, (size_t)first * 2 * sizeof(s16));
+    memcpy(ring->data, src + (size_t)first * 2, (size_t)(count - first) * 2 * sizeof(s16));
+}
+
+static void audio_ring_copy_out(const AudioRing* ring, u32 pos, s16* dst, u32 count) {
+    u32 index = pos & (ring->capacity - 1);
+    u32 first = ring->capacity - index;
+    if (first > count) first = count;
+    memcpy(dst, ring->data + (size_t)index * 2, (size_t)first * 2 * sizeof(s16));
+    memcpy(dst + (size_t)first * 2, ring->data, (size_t)(count - first) * 2 * sizeof(s16));
+}
+
+u32 audio_ring_write(AudioRing* ring, const s16* frames, u32 count) {
+    u32 head = ring->head;
+    u32 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    u32 room = ring->capacity - (head - tail);
+    if (count > room) {
+        // Consommateur en retard: garder le début, perdre la fin
+        ring->overruns++;
+        ring->dropped_frames += count - room;
+        count = room;
+    }
+    audio_ring_copy_in(ring, head, frames, count);
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+u32 audio_ring_read(AudioRing* ring, s16* out, u32 count) {
+    u32 tail = ring->tail;
+    u32 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    u32 avail = head - tail;
+    u32 n = count < avail ? count : avail;
+    audio_ring_copy_out(ring, tail, out, n);
+    __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+
+    if (n < count) {
+        // Producteur en retard: silence plutôt qu'un bloc périmé
+        memset(out + (size_t)n * 2, 0, (size_t)(count - n) * 2 * sizeof(s16));
+        ring->underruns++;
+        ring->silent_frames += count - n;
+    }
+    return n;
+}
@@ -0,0 +1,30 @@
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#include "common.h"
+
+// File circulaire de frames stéréo (s16 gauche/droite) à un producteur et
+// un consommateur, sans verrou: l'émulation écrit, le callback audio de
+// l'hôte lit. Chaque index n'est modifié que par son côté et publié avec
+// une sémantique release; les compteurs sont libres et se comparent par
+// différence.
+typedef struct {
+    s16* data;          // Frames entrelacées
+    u32 capacity;       // Frames (puissance de 2)
+    u32 head;           // Frames écrites (producteur)
+    u32 tail;           // Frames lues (consommateur)
+
+    // Statistiques (chacune tenue par un seul côté)
+    u32 overruns;       // Écritures tronquées, file pleine (producteur)
+    u32 underruns;      // Lectures complétées de silence (consommateur)
+    u64 dropped_frames; // Frames perdues par les écritures tronquées
+    u64 silent_frames;  // Frames de silence insérées
+} AudioRing;
+
+bool audio_ring_init(AudioRing* ring, u32 min_frames);
+void audio_ring_cleanup(AudioRing* ring);
+u32 audio_ring_fill(const AudioRing* ring);   // Frames en attente (côté quelconque)
+u32 audio_ring_write(AudioRing* ring, const s16* frames, u32 count);
+u32 audio_ring_read(AudioRing* ring, s16* out, u32 count);  // Complète de silence
+
+#endif // AUDIO_RING_H
@@ -0,0 +1,42 @@
+#ifndef BLIP_H
+#define BLIP_H
+
+#include "common.h"
+
+// Synthèse à bande limitée (BLIP): les changements d'amplitude d'un signal
+// sont enregistrés comme des deltas horodatés en cycles d'horloge, étalés
+// sur quelques échantillons par un noyau sinc fenêtré, puis intégrés au
+// rythme de sortie. Le coût dépend du nombre de transitions et du nombre
+// d'échantillons produits, pas de la fréquence d'horloge émulée.
+#define BLIP_PHASE_BITS 5
+#define BLIP_PHASES (1 << BLIP_PHASE_BITS)  // Positions sub-échantillon du noyau
+#define BLIP_WIDTH 16                       // Coefficients par delta
+#define BLIP_UNIT_BITS 15                   // Somme des coefficients d'une phase
+#define BLIP_TIME_BITS 32                   // Virgule fixe des positions
+
+typedef struct {
+    u64 factor;      // Échantillons par cycle (virgule fixe)
+    u64 offset;      // Position du début de frame (virgule fixe)
+    s32* buffer;     // Deltas en attente d'intégration (capacity + BLIP_WIDTH)
+    u32 capacity;    // Échantillons maximum entre deux lectures
+    u32 avail;       // Échantillons complets prêts à lire
+    s32 integrator;  // Somme courante (niveau du signal)
+} BlipBuffer;
+
+bool blip_init(BlipBuffer* blip, u32 capacity);
+void blip_cleanup(BlipBuffer* blip);
+void blip_set_rates(BlipBuffer* blip, u32 clock_rate, u32 sample_rate);
+void blip_clear(BlipBuffer* blip);
+
+// Delta d'amplitude à l'instant time (cycles depuis la fin de la frame
+// précédente). Les lectures se font entre deux frames.
+void blip_add_delta(BlipBuffer* blip, u32 time, s32 delta);
+// Clôt la frame: les cycles [0, clocks) deviennent des échantillons lisibles
+void blip_end_frame(BlipBuffer* blip, u32 clocks);
+// Cycles maximum d'une frame sans dépasser la capacité
+u32 blip_max_frame_clocks(const BlipBuffer* blip);
+u32 blip_samples_avail(const BlipBuffer* blip);
+// Lit jusqu'à count échantillons (out espacés de stride, NULL pour jeter)
+u32 blip_read_samples(BlipBuffer* blip, s16* out, u32 count, u32 stride);
+
+#endif // BLIP_H
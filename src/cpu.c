@@ -9,6 +9,7 @@
 
 #include "mmu.h"
 #include "cpu.h"
+#include "interrupt.h"
 #include "common.h"
 #include <stdio.h>
 
@@ -60,6 +61,19 @@ void set_flag(CPU* cpu, u8 flag, bool value) {
     }
 }
 
+// IE & IF lus directement dans le stockage de la MMU (sans décodage d'adresse)
+static u8 cpu_requested_interrupts(MMU* mmu) {
+    return mmu->memory[IE_REG] & mmu->memory[IF_REG] & 0x1F;
+}
+
+// IME: le contrôleur d'interruptions attaché à la MMU garde IE & IF & IME en cache
+void cpu_set_ime(CPU* cpu, MMU* mmu, bool ime) {
+    cpu->ime = ime;
+    if (mmu->interrupts) {
+        interrupt_set_ime((InterruptManager*)mmu->interrupts, ime);
+    }
+}
+
 // ============================================================================
 // INSTRUCTIONS DE BASE (CONTROL FLOW)
 // ============================================================================
@@ -71,10 +85,7 @@ void inst_nop(CPU* cpu, MMU* mmu) {
 
 void inst_halt(CPU* cpu, MMU* mmu) {
     // HALT bug selon Pan Docs : si IME=0 et interruption en attente, PC n'incrémente pas
-    u8 ie = mmu_read8(mmu, 0xFFFF);  // Interrupt Enable
-    u8 if_reg = mmu_read8(mmu, 0xFF0F);  // Interrupt Flag
-    
-    if (!cpu->ime && (ie & if_reg) != 0) {
+    if (!cpu->ime && cpu_requested_interrupts(mmu) != 0) {
         // HALT bug : PC n'incrémente pas
         cpu->halt_bug = true;
         // Dans ce cas, la CPU ne s'arrête pas réellement
@@ -92,8 +103,7 @@ void inst_stop(CPU* cpu, MMU* mmu) {
 }
 
 void inst_di(CPU* cpu, MMU* mmu) {
-    (void)mmu;  // Paramètre non utilisé
-    cpu->ime = false;
+    cpu_set_ime(cpu, mmu, false);
     cpu->ei_pending = false;
     cpu->pc += 1;
 }
@@ -492,7 +502,7 @@ void cpu_interrupt(CPU* cpu, MMU* mmu, u8 interrupt) {
     if (!cpu->ime) return;
     
     // Désactiver les interruptions
-    cpu->ime = false;
+    cpu_set_ime(cpu, mmu, false);
     cpu->halted = false;  // Sortir de HALT
     
     // Push PC sur la pile
@@ -500,21 +510,14 @@ void cpu_interrupt(CPU* cpu, MMU* mmu, u8 interrupt) {
     mmu_write8(mmu, cpu->sp, cpu->pc & 0xFF);
     mmu_write8(mmu, cpu->sp + 1, (cpu->pc >> 8) & 0xFF);
     
-    // Saut vers le vecteur d'interruption
-    switch (interrupt) {
-        case VBLANK_INT:  cpu->pc = 0x40; break;
-        case LCD_STAT_INT: cpu->pc = 0x48; break;
-        case TIMER_INT:    cpu->pc = 0x50; break;
-        case SERIAL_INT:   cpu->pc = 0x58; break;
-        case JOYPAD_INT:   cpu->pc = 0x60; break;
-        default: cpu->pc = 0x00; break;  // Fallback
-    }
+    // Saut vers le vecteur d'interruption (0x40 + 8n, 0x00 si source invalide)
+    cpu->pc = interrupt_get_handler_address(interrupt);
 }
 
 void inst_reti(CPU* cpu, MMU* mmu) {
     // Équivalent à RET + EI
     inst_ret(cpu, mmu);
-    cpu->ime = true;  // Réactiver immédiatement les interruptions
+    cpu_set_ime(cpu, mmu, true);  // Réactiver immédiatement les interruptions
 }
 
 // ============================================================================
@@ -572,9 +575,7 @@ void inst_cb_prefix(CPU* cpu, MMU* mmu) {
 u8 cpu_step(CPU* cpu, MMU* mmu) {
     // Sortie de HALT si une interruption devient en attente
     if (cpu->halted) {
-        u8 ie = mmu_read8(mmu, IE_REG);
-        u8 if_reg = mmu_read8(mmu, IF_REG);
-        if ((ie & if_reg) != 0) {
+        if (cpu_requested_interrupts(mmu) != 0) {
             // Une interruption est en attente
             cpu->halted = false;
             if (!cpu->ime) {
@@ -601,7 +602,7 @@ u8 cpu_step(CPU* cpu, MMU* mmu) {
     // Gestion du délai EI (prend effet après l'instruction suivante)
     if (cpu->ei_pending) {
         cpu->ei_pending = false;
-        cpu->ime = true;
+        cpu_set_ime(cpu, mmu, true);
     }
     
     // Retourner les cycles (avec cycles conditionnels si applicable)
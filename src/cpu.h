@@ -51,6 +51,7 @@ void cpu_init(CPU* cpu);
 void cpu_reset(CPU* cpu);
 u8 cpu_step(CPU* cpu, MMU* mmu);
 void cpu_interrupt(CPU* cpu, MMU* mmu, u8 interrupt);
+void cpu_set_ime(CPU* cpu, MMU* mmu, bool ime);  // IME + cache du contrôleur
 
 // Gestion des registres
 u8 get_reg_a(CPU* cpu);
@@ -4,10 +4,22 @@
 #include "mmu.h"
 #include "interrupt.h"
 #include "timer.h"
+#include "serial.h"
+#include "link.h"
 #include "ppu.h"
 #include "joypad.h"
 #include "apu.h"
-#include "graphics_win32.h"
+#include "scheduler.h"
+#include "framebuffer.h"
+#include "golden.h"
+#include "video_sink.h"
+#include "render_thread.h"
+#include "video.h"
+#include "audio.h"
+#include "wav_sink.h"
+
+// Mise en route avant l'affichage LCD avec câble (~10000 instructions)
+#define EMULATOR_WARMUP_CYCLES 100000
 
 // Déclaration anticipée
 void load_ascii_tiles(u8* vram);
@@ -282,17 +294,31 @@ typedef struct {
     CPU cpu;
     MMU mmu;
     Timer timer;
+    Serial serial;
     PPU ppu;
     Joypad joypad;
     APU apu;
     InterruptManager interrupt_mgr;
-    GraphicsWin32 graphics;
+    Scheduler scheduler;       // Événements datés sur total_cycles (sweep APU, overflow TIMA)
+    VideoBackend display;      // Présentation (null, shm, win32)
+    AudioOutput audio;         // Sortie audio vers l'hôte (--audio-pace)
+    WavSink wav;               // Capture du mixage stéréo (--dump-wav)
+    WavSink stems[4];          // Capture par canal (--dump-wav-stems)
+    bool wav_stems;
+    FILE* serial_file;         // Sortie série (--serial-out), stdout sinon
     
     bool running;
     u32 cycles_per_frame;
     u32 current_cycles;
+    u64 total_cycles;          // Cycles émulés depuis le démarrage
     bool show_lcd;
     const char* dump_ppm_path;
+    const FbPalette* palette;  // Teintes DMG -> couleurs hôte
+    bool hash_frames;          // Empreintes par frame (--hash-log / --golden)
+    GoldenCheck golden;
+    VideoSink video;           // Flux vidéo (--video)
+    bool use_render_thread;    // Rastérisation sur un thread dédié (--render-thread)
+    RenderThread render_thread;
 } EmulatorSimple;
 
 // Initialisation de l'émulateur simple
@@ -302,47 +328,57 @@ void emulator_simple_init(EmulatorSimple* emu) {
     cpu_init(&emu->cpu);
     mmu_init(&emu->mmu);
     timer_init(&emu->timer);
+    serial_init(&emu->serial);
     ppu_init(&emu->ppu);
     joypad_init(&emu->joypad);
     apu_init(&emu->apu);
     interrupt_init(&emu->interrupt_mgr);
     
-    // Connecter le timer et l'APU au MMU
+    // Connecter le timer, le port série, le joypad, l'APU, le PPU et les interruptions au MMU
     emu->mmu.timer = &emu->timer;
+    emu->mmu.serial = &emu->serial;
+    emu->mmu.joypad = &emu->joypad;
     emu->mmu.apu = &emu->apu;
+    emu->mmu.ppu = &emu->ppu;
+    interrupt_attach(&emu->interrupt_mgr, &emu->mmu);
+    interrupt_set_ime(&emu->interrupt_mgr, emu->cpu.ime);
     
-    // Initialiser les graphiques (caché par défaut)
-    if (!graphics_win32_init(&emu->graphics)) {
-        printf("Erreur: Impossible d'initialiser les graphiques\n");
-        emu->show_lcd = false;
-    } else {
-        printf("Graphiques initialisés avec succès\n");
-        emu->show_lcd = false; // Commencer caché
-    }
+    // L'APU et le timer rattrapent l'horloge maître à la demande (accès aux
+    // registres, fin de frame); sweep, débordement de TIMA, fin de transfert
+    // série et entrées scriptées sont des événements datés
+    scheduler_init(&emu->scheduler);
+    apu_set_clock(&emu->apu, &emu->total_cycles);
+    apu_set_scheduler(&emu->apu, &emu->scheduler);
+    timer_set_clock(&emu->timer, &emu->total_cycles);
+    timer_set_scheduler(&emu->timer, &emu->scheduler);
+    serial_set_clock(&emu->serial, &emu->total_cycles);
+    serial_set_scheduler(&emu->serial, &emu->scheduler);
+    joypad_set_clock(&emu->joypad, &emu->total_cycles);
+    joypad_set_scheduler(&emu->joypad, &emu->scheduler);
+    
+    // Octets série sur stdout, écrits une fois par frame
+    serial_set_stream(&emu->serial, stdout);
+    
+    // Le backend vidéo est ouvert par main() une fois les options connues
+    emu->show_lcd = false;
     
     emu->running = true;
     emu->cycles_per_frame = GB_FREQ / 60;  // 60 FPS
     emu->current_cycles = 0;
     emu->dump_ppm_path = NULL;
+    emu->palette = &FB_PALETTE_GRAY;
 }
-static void write_framebuffer_to_ppm(const char* path, u32* framebuffer) {
+static void write_framebuffer_to_ppm(const char* path, const u8* framebuffer, const FbPalette* palette) {
     FILE* f = fopen(path, "wb");
     if (!f) {
         printf("Erreur: impossible d'ouvrir %s pour écriture\n", path);
         return;
     }
+    // Conversion en une passe puis une seule écriture
+    static u8 rgb[FB_PIXELS * 3];
+    fb_convert(framebuffer, rgb, FB_FORMAT_RGB24, palette);
     fprintf(f, "P6\n%d %d\n255\n", GB_WIDTH, GB_HEIGHT);
-    for (int y = 0; y < GB_HEIGHT; y++) {
-        for (int x = 0; x < GB_WIDTH; x++) {
-            u32 c = framebuffer[y * GB_WIDTH + x];
-            unsigned char r = (unsigned char)((c >> 24) & 0xFF);
-            unsigned char g = (unsigned char)((c >> 16) & 0xFF);
-            unsigned char b = (unsigned char)((c >> 8) & 0xFF);
-            fwrite(&r, 1, 1, f);
-            fwrite(&g, 1, 1, f);
-            fwrite(&b, 1, 1, f);
-        }
-    }
+    fwrite(rgb, 1, sizeof(rgb), f);
     fclose(f);
     printf("Frame dump écrite: %s\n", path);
 }
@@ -350,106 +386,217 @@ static void write_framebuffer_to_ppm(const char* path, u32* framebuffer) {
 
 // Nettoyage de l'émulateur simple
 void emulator_simple_cleanup(EmulatorSimple* emu) {
+    serial_cleanup(&emu->serial);
+    if (emu->serial_file) {
+        fclose(emu->serial_file);
+        emu->serial_file = NULL;
+    }
+    joypad_cleanup(&emu->joypad);
     mmu_cleanup(&emu->mmu);
     apu_cleanup(&emu->apu);
-    graphics_win32_cleanup(&emu->graphics);
+    render_thread_stop(&emu->render_thread);
+    golden_cleanup(&emu->golden);
+    video_sink_close(&emu->video);
+    video_backend_close(&emu->display);
+    audio_output_close(&emu->audio);
+    wav_sink_close(&emu->wav);
+    for (int c = 0; c < 4; c++) {
+        wav_sink_close(&emu->stems[c]);
+    }
 }
 
-// Activer l'affichage LCD
-void emulator_simple_show_lcd(EmulatorSimple* emu) {
-    emu->show_lcd = true;
-    graphics_win32_show(&emu->graphics);
-    printf("Affichage LCD activé\n");
+// Ouvrir le backend de présentation; un backend interactif (fenêtre)
+// garde l'émulation en marche jusqu'à sa fermeture
+bool emulator_simple_open_display(EmulatorSimple* emu, const char* backend, const char* target,
+                                  ScalerMode scale) {
+    if (!video_backend_open(&emu->display, backend, target, scale)) {
+        return false;
+    }
+    emu->show_lcd = emu->display.interactive;
+    if (emu->show_lcd) {
+        printf("Affichage LCD activé\n");
+    }
+    return true;
 }
 
-// Boucle principale d'émulation simple (sans graphiques)
-void emulator_simple_run(EmulatorSimple* emu, u32 max_cycles) {
+// Présentation d'une frame au backend, avec le contexte d'émulation
+static void emulator_simple_present(EmulatorSimple* emu, const u8* framebuffer, u32 frame) {
+    VideoFrameInfo info;
+    info.frame = frame;
+    info.cycles = emu->total_cycles;
+    info.input = joypad_pressed(&emu->joypad);
+    video_backend_present(&emu->display, framebuffer, emu->palette, &info);
+}
+
+// Sorties par frame (empreintes, flux vidéo). Appelée depuis la boucle
+// d'émulation, ou depuis le thread de rendu quand il est actif.
+static void emulator_simple_output_frame(void* user, u32 frame, const u8* framebuffer) {
+    EmulatorSimple* emu = (EmulatorSimple*)user;
+    if (emu->hash_frames && golden_wants_frame(&emu->golden, frame)) {
+        golden_check_frame(&emu->golden, frame, fb_hash64(framebuffer, FB_PIXELS, 0));
+    }
+    if (video_sink_wants_frame(&emu->video, frame)) {
+        video_sink_write_frame(&emu->video, framebuffer);
+    }
+}
+
+// Fin de frame audio: échantillons produits vers la sortie hôte et les
+// captures WAV, puis calage de l'émulation sur la consommation de l'hôte
+static void emulator_simple_audio_frame(EmulatorSimple* emu) {
+    if (!emu->apu.output_enabled) return;
+    
+    static s16 block[AUDIO_PUSH_FRAMES * 2];
+    static s16 stem_blocks[4][AUDIO_PUSH_FRAMES];
+    s16* const stems[4] = {stem_blocks[0], stem_blocks[1], stem_blocks[2], stem_blocks[3]};
+    u32 frames;
+    while ((frames = apu_read_channels(&emu->apu, block, emu->wav_stems ? stems : NULL,
+                                       AUDIO_PUSH_FRAMES)) > 0) {
+        if (emu->audio.ring.data) {
+            audio_output_push(&emu->audio, block, frames);
+        }
+        wav_sink_write(&emu->wav, block, frames);
+        if (emu->wav_stems) {
+            for (int c = 0; c < 4; c++) {
+                wav_sink_write(&emu->stems[c], stem_blocks[c], frames);
+            }
+        }
+    }
+    if (emu->audio.clocked) {
+        audio_output_pace(&emu->audio);
+    }
+}
+
+// Une instruction (précédée de l'interruption servie) et les composants;
+// renvoie les cycles écoulés. Les traces de démarrage suivent l'horloge maître.
+static u32 emulator_simple_step(EmulatorSimple* emu) {
+    // Log de debug réduit
+    // Early boot trace only
+    if (emu->total_cycles < 50) {
+        printf("TRACE: PC=0x%04X OPC=0x%02X\n", emu->cpu.pc, emu->mmu.memory[emu->cpu.pc]);
+    }
+    
+    // Interruption servie avant l'instruction suivante (IE & IF & IME en
+    // cache: un seul test); le dispatch coûte 5 M-cycles, écoulés avant
+    // la première instruction du gestionnaire et comptés avec elle
+    u8 cycles = 0;
+    if (emu->interrupt_mgr.active) {
+        u8 handled_interrupt = interrupt_handle(&emu->interrupt_mgr, &emu->cpu, &emu->mmu);
+        cycles = INTERRUPT_DISPATCH_CYCLES;
+        emu->total_cycles += INTERRUPT_DISPATCH_CYCLES;
+        if (emu->total_cycles - INTERRUPT_DISPATCH_CYCLES < 1000) { // Log seulement les 1000 premiers cycles
+            printf("Interruption traitée: %s (0x%02X)\n", 
+                   interrupt_get_name(handled_interrupt), handled_interrupt);
+        }
+    }
+    
+    // Exécuter une instruction CPU
+    u8 step_cycles = cpu_step(&emu->cpu, &emu->mmu);
+    cycles += step_cycles;
+    emu->current_cycles += cycles;
+    emu->total_cycles += step_cycles;
+    
+    // Événements échus pendant l'instruction
+    if (emu->total_cycles >= emu->scheduler.next) {
+        scheduler_run(&emu->scheduler, emu->total_cycles);
+    }
+    
+    // Log spécial pour la zone de test Blargg
+    // Remove legacy zone test spam; keep minimal periodic heartbeat
+    
+    // Log détaillé réduit
+    if (emu->total_cycles < 50) {
+        printf("TRACE: CYCLE=%u PC=0x%04X AF=0x%04X\n", (u32)emu->total_cycles, emu->cpu.pc, emu->cpu.af);
+    }
+    
+    // Log spécial pour les accès port série
+    // Remove old per-PC zone logs
+    
+    // Mettre à jour les composants
+    u8 ppu_interrupts = ppu_tick(&emu->ppu, cycles, emu->mmu.vram);
+    u8 timer_interrupts = timer_get_interrupts(&emu->timer);
+    u8 serial_interrupts = serial_get_interrupts(&emu->serial);
+    u8 joypad_interrupts = joypad_get_interrupts(&emu->joypad);
+    
+    // Ajouter les interruptions au gestionnaire d'interruptions
+    if (ppu_interrupts) {
+        interrupt_request(&emu->interrupt_mgr, ppu_interrupts);
+    }
+    if (timer_interrupts) {
+        interrupt_request(&emu->interrupt_mgr, timer_interrupts);
+    }
+    if (serial_interrupts) {
+        interrupt_request(&emu->interrupt_mgr, serial_interrupts);
+    }
+    if (joypad_interrupts) {
+        interrupt_request(&emu->interrupt_mgr, joypad_interrupts);
+    }
+    
+    // Présenter exactement une fois par frame rendue par le PPU (entrée en VBlank)
+    bool frame_done = ppu_frame_ready(&emu->ppu);
+    if (frame_done && !emu->use_render_thread) {
+        // Frame numérotée depuis 0
+        emulator_simple_present(emu, emu->ppu.framebuffer, emu->ppu.frame_count - 1);
+        emulator_simple_output_frame(emu, emu->ppu.frame_count - 1, emu->ppu.framebuffer);
+    }
+    
+    // Thread de rendu: présenter la dernière frame rastérisée
+    if (emu->use_render_thread && video_backend_renders(&emu->display)) {
+        u32 frame;
+        const u8* latest = render_thread_latest_frame(&emu->render_thread, &frame);
+        if (latest) {
+            emulator_simple_present(emu, latest, frame);
+            frame_done = true;
+        }
+    }
+    
+    // Événements fenêtre: une fois par frame (ou par durée de frame si LCD éteint)
+    if (emu->current_cycles >= emu->cycles_per_frame) {
+        emu->current_cycles -= emu->cycles_per_frame;
+        frame_done = true;
+    }
+    if (frame_done) {
+        emulator_simple_audio_frame(emu);
+        serial_flush(&emu->serial);
+    }
+    if (emu->show_lcd && frame_done) {
+        // Vérifier si la fenêtre a été fermée
+        if (!video_backend_poll(&emu->display)) {
+            emu->running = false;
+            printf("Fenêtre fermée par l'utilisateur\n");
+        }
+    }
+    
+    return cycles;
+}
+
+// Derniers échantillons (frame audio en cours), derniers octets série et bilan
+static void emulator_simple_finish(EmulatorSimple* emu, u64 cycles) {
+    emulator_simple_audio_frame(emu);
+    serial_flush(&emu->serial);
+    
+    printf("Émulation terminée après %llu cycles\n", (unsigned long long)cycles);
+    printf("PC final: 0x%04X\n", emu->cpu.pc);
+    printf("AF: 0x%04X, BC: 0x%04X, DE: 0x%04X, HL: 0x%04X\n", 
+           emu->cpu.af, emu->cpu.bc, emu->cpu.de, emu->cpu.hl);
+    printf("SP: 0x%04X\n", emu->cpu.sp);
+}
+
+static void emulator_simple_print_start(EmulatorSimple* emu, u32 max_cycles) {
     printf("Démarrage de l'émulation simple...\n");
     printf("Cycles maximum: %u\n", max_cycles);
     printf("PC initial: 0x%04X\n", emu->cpu.pc);
     printf("Première instruction: 0x%02X\n", emu->mmu.memory[emu->cpu.pc]);
     printf("\n");
+}
+
+// Boucle principale d'émulation simple (sans graphiques)
+void emulator_simple_run(EmulatorSimple* emu, u32 max_cycles) {
+    emulator_simple_print_start(emu, max_cycles);
     
     u32 total_cycles = 0;
     
     while (emu->running && total_cycles < max_cycles) {
-        // Log de debug réduit
-        // Early boot trace only
-        if (total_cycles < 50) {
-            printf("TRACE: PC=0x%04X OPC=0x%02X\n", emu->cpu.pc, emu->mmu.memory[emu->cpu.pc]);
-        }
-        
-        // Exécuter une instruction CPU
-        u8 cycles = cpu_step(&emu->cpu, &emu->mmu);
-        emu->current_cycles += cycles;
-        total_cycles += cycles;
-        
-        // Log spécial pour la zone de test Blargg
-        // Remove legacy zone test spam; keep minimal periodic heartbeat
-        
-        // Log détaillé réduit
-        if (total_cycles < 50) {
-            printf("TRACE: CYCLE=%u PC=0x%04X AF=0x%04X\n", total_cycles, emu->cpu.pc, emu->cpu.af);
-        }
-        
-        // Log spécial pour les accès port série
-        // Remove old per-PC zone logs
-        
-        // Mettre à jour les composants
-        timer_tick(&emu->timer, cycles);
-        u8 ppu_interrupts = ppu_tick(&emu->ppu, cycles, emu->mmu.vram);
-        u8 timer_interrupts = timer_get_interrupts(&emu->timer);
-        apu_tick(&emu->apu, cycles);
-        
-        // Mettre à jour l'affichage LCD si nécessaire
-        if (emu->show_lcd) {
-            graphics_win32_update(&emu->graphics, emu->ppu.framebuffer);
-            graphics_win32_handle_events(&emu->graphics, &emu->running);
-            
-            // Vérifier si la fenêtre a été fermée
-            if (!emu->graphics.running) {
-                printf("Fenêtre fermée par l'utilisateur\n");
-                break;
-            }
-        }
-        
-        // Ajouter les interruptions au gestionnaire d'interruptions
-        if (ppu_interrupts) {
-            interrupt_request(&emu->interrupt_mgr, ppu_interrupts);
-        }
-        if (timer_interrupts) {
-            interrupt_request(&emu->interrupt_mgr, timer_interrupts);
-        }
-        
-        // Synchroniser les registres IE et IF avec le gestionnaire
-        interrupt_write_ie(&emu->interrupt_mgr, mmu_read8(&emu->mmu, IE_REG));
-        interrupt_write_if(&emu->interrupt_mgr, mmu_read8(&emu->mmu, IF_REG));
-        
-        // Traiter les interruptions
-        u8 handled_interrupt = interrupt_handle(&emu->interrupt_mgr, &emu->cpu, &emu->mmu);
-        if (handled_interrupt) {
-            // Synchroniser le registre IF avec le gestionnaire
-            mmu_write8(&emu->mmu, IF_REG, interrupt_read_if(&emu->interrupt_mgr));
-            if (total_cycles < 1000) { // Log seulement les 1000 premiers cycles
-                printf("Interruption traitée: %s (0x%02X)\n", 
-                       interrupt_get_name(handled_interrupt), handled_interrupt);
-            }
-        }
-        
-        // Vérifier si on a atteint une frame
-        if (emu->current_cycles >= emu->cycles_per_frame) {
-            emu->current_cycles -= emu->cycles_per_frame;
-            
-            // Rendre la frame complète
-            if (emu->show_lcd) {
-                for (int y = 0; y < GB_HEIGHT; y++) {
-                    emu->ppu.ly = y;
-                    ppu_render_line(&emu->ppu, emu->mmu.vram);
-                }
-                graphics_win32_update(&emu->graphics, emu->ppu.framebuffer);
-                graphics_win32_present(&emu->graphics);
-            }
-        }
+        total_cycles += emulator_simple_step(emu);
         
         // Si on a l'affichage LCD, continuer indéfiniment jusqu'à fermeture manuelle
         if (emu->show_lcd && total_cycles >= max_cycles) {
@@ -469,19 +616,68 @@ void emulator_simple_run(EmulatorSimple* emu, u32 max_cycles) {
         }
     }
     
-    printf("Émulation terminée après %u cycles\n", total_cycles);
-    printf("PC final: 0x%04X\n", emu->cpu.pc);
-    printf("AF: 0x%04X, BC: 0x%04X, DE: 0x%04X, HL: 0x%04X\n", 
-           emu->cpu.af, emu->cpu.bc, emu->cpu.de, emu->cpu.hl);
-    printf("SP: 0x%04X\n", emu->cpu.sp);
+    emulator_simple_finish(emu, total_cycles);
+}
+
+// Quantum du câble: avance l'instance jusqu'à until sur son horloge maître
+static bool emulator_simple_run_until(void* user, u64 until) {
+    EmulatorSimple* emu = (EmulatorSimple*)user;
+    while (emu->running && emu->total_cycles < until) {
+        emulator_simple_step(emu);
+    }
+    return emu->running;
+}
+
+// Deux instances reliées par le câble, en quanta alternés ou sur deux threads
+// (câble déjà branché par link_init)
+void emulator_simple_run_linked(EmulatorSimple* emu, EmulatorSimple* peer, LinkCable* link, u32 max_cycles, bool threaded) {
+    emulator_simple_print_start(emu, max_cycles);
+    
+    // Fenêtre ouverte: jusqu'à sa fermeture
+    u64 cycles = emu->show_lcd ? ~(u64)0 : max_cycles;
+    u64 start = emu->total_cycles;
+    link_run(link, emulator_simple_run_until, emu, peer, cycles, threaded);
+    link_disconnect(link);
+    
+    printf("Câble: %u quanta de %llu cycles, %u octets échangés (%s)\n",
+           link->quanta, (unsigned long long)link->quantum, link->exchanges,
+           threaded ? "deux threads" : "alterné");
+    emulator_simple_finish(emu, emu->total_cycles - start);
+    
+    u32 length;
+    serial_output(&peer->serial, &length);
+    printf("Partenaire: PC final 0x%04X, %u octets émis sur le port série\n", peer->cpu.pc, length);
 }
 
 // Fonction principale
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        printf("Usage: %s <rom_file> [max_cycles] [--headless] [--dump-ppm path]\n", argv[0]);
+        printf("Usage: %s <rom_file> [max_cycles] [--headless] [--dump-ppm path] [--render mode] [--palette name] [--hash-log path] [--golden path] [--hash-interval N] [--video path] [--render-thread] [--backend name]\n", argv[0]);
         printf("  max_cycles: nombre maximum de cycles (défaut: 1000000)\n");
-        printf("  --headless: n'affiche pas la fenêtre LCD (tests automatisés)\n");
+        printf("  --headless: backend null par défaut (tests automatisés)\n");
+        printf("  --render: always | never | on-demand | N (une frame sur N)\n");
+        printf("            défaut: always si le backend présente les frames, never sinon\n");
+        printf("  --palette: gray | green (couleurs de sortie, défaut: gray)\n");
+        printf("  --hash-log path: journalise l'empreinte 64 bits des frames rendues\n");
+        printf("  --golden path: compare les empreintes à un manifeste (code retour 2 si divergence ou frame manquante)\n");
+        printf("  --hash-interval N: hache une frame sur N (défaut: 1)\n");
+        printf("  --video path: flux des frames rendues (fichier ou tube nommé, .y4m => Y4M)\n");
+        printf("  --video-format ppm|y4m: force le format du flux\n");
+        printf("  --video-interval N: écrit une frame sur N (défaut: 1)\n");
+        printf("  --video-scale M: mise à l'échelle du flux, 1-4 ou epx2-epx4 (défaut: 1)\n");
+        printf("  --scale M: mise à l'échelle de la fenêtre, 1-4 ou epx2-epx4 (défaut: 4)\n");
+        printf("  --render-thread: rastérise les frames sur un thread dédié\n");
+        printf("  --backend null|shm|win32: présentation des frames (défaut: win32 sous Windows, null sinon)\n");
+        printf("  --shm-name name: segment POSIX du backend shm (défaut: /cameboy-lcd)\n");
+        printf("  --audio-pace: cadence temps réel sur la consommation audio (horloge hôte simulée)\n");
+        printf("  --audio-rate hz: taux de sortie audio, ex. 32000, 44100, 48000, 96000 (défaut: 48000)\n");
+        printf("  --audio-latency ms: remplissage visé de la file audio (défaut: 60)\n");
+        printf("  --dump-wav path: capture WAV du mixage stéréo (65536 Hz, sans rééchantillonnage)\n");
+        printf("  --dump-wav-stems prefix: une capture WAV mono par canal (prefix.ch1.wav à ch4)\n");
+        printf("  --serial-out path: octets émis sur le port série (défaut: stdout, une écriture par frame)\n");
+        printf("  --link rom2: câble link vers une seconde instance (rom2) dans le même processus\n");
+        printf("  --link-threads: chaque instance sur son propre thread (barrière sans verrou)\n");
+        printf("  --input path: entrées joypad datées, lignes \"<cycle> <touche> down|up\" (rejeu)\n");
         return 1;
     }
     
@@ -503,32 +699,288 @@ int main(int argc, char* argv[]) {
     
     // Déterminer les options en ligne de commande
     bool headless = false;
+    const char* render_mode = NULL;
+    const char* hash_log_path = NULL;
+    const char* golden_path = NULL;
+    u32 hash_interval = 1;
+    const char* video_path = NULL;
+    const char* video_format = NULL;
+    u32 video_interval = 1;
+    ScalerMode video_scale = {1, SCALER_NEAREST};
+    ScalerMode display_scale = {4, SCALER_NEAREST};
+    const char* backend = NULL;
+    const char* shm_name = NULL;
+    bool audio_pace = false;
+    u32 audio_rate = AUDIO_DEFAULT_RATE;
+    u32 audio_latency = AUDIO_DEFAULT_LATENCY_MS;
+    const char* wav_path = NULL;
+    const char* stems_prefix = NULL;
+    const char* serial_path = NULL;
+    const char* link_path = NULL;
+    bool link_threads = false;
+    const char* input_path = NULL;
     for (int i = 2; i < argc; i++) {
         if (strcmp(argv[i], "--headless") == 0) {
             headless = true;
         } else if (strcmp(argv[i], "--dump-ppm") == 0 && i + 1 < argc) {
             emu.dump_ppm_path = argv[i + 1];
             i++;
+        } else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            render_mode = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--palette") == 0 && i + 1 < argc) {
+            const FbPalette* palette = fb_palette_by_name(argv[i + 1]);
+            if (palette) {
+                emu.palette = palette;
+            } else {
+                printf("Palette inconnue: %s (gray utilisée)\n", argv[i + 1]);
+            }
+            i++;
+        } else if (strcmp(argv[i], "--hash-log") == 0 && i + 1 < argc) {
+            hash_log_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            golden_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--hash-interval") == 0 && i + 1 < argc) {
+            hash_interval = (u32)atoi(argv[i + 1]);
+            i++;
+        } else if (strcmp(argv[i], "--render-thread") == 0) {
+            emu.use_render_thread = true;
+        } else if (strcmp(argv[i], "--video") == 0 && i + 1 < argc) {
+            video_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--video-format") == 0 && i + 1 < argc) {
+            video_format = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--video-interval") == 0 && i + 1 < argc) {
+            video_interval = (u32)atoi(argv[i + 1]);
+            i++;
+        } else if ((strcmp(argv[i], "--video-scale") == 0 || strcmp(argv[i], "--scale") == 0) && i + 1 < argc) {
+            ScalerMode* mode = argv[i][2] == 'v' ? &video_scale : &display_scale;
+            if (!scaler_parse_mode(argv[i + 1], mode)) {
+                printf("Mise à l'échelle inconnue: %s (1-4, epx2-epx4)\n", argv[i + 1]);
+                emulator_simple_cleanup(&emu);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            backend = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--shm-name") == 0 && i + 1 < argc) {
+            shm_name = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--audio-pace") == 0) {
+            audio_pace = true;
+        } else if (strcmp(argv[i], "--audio-rate") == 0 && i + 1 < argc) {
+            audio_rate = (u32)atoi(argv[i + 1]);
+            i++;
+        } else if (strcmp(argv[i], "--audio-latency") == 0 && i + 1 < argc) {
+            audio_latency = (u32)atoi(argv[i + 1]);
+            i++;
+        } else if (strcmp(argv[i], "--dump-wav") == 0 && i + 1 < argc) {
+            wav_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--dump-wav-stems") == 0 && i + 1 < argc) {
+            stems_prefix = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--serial-out") == 0 && i + 1 < argc) {
+            serial_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc) {
+            link_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--link-threads") == 0) {
+            link_threads = true;
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            input_path = argv[i + 1];
+            i++;
         }
     }
 
-    if (!headless) {
-        // Activer l'affichage LCD
-        emulator_simple_show_lcd(&emu);
+    // Empreintes de frames: journal et/ou comparaison au manifeste
+    golden_init(&emu.golden, hash_interval);
+    if (hash_log_path != NULL || golden_path != NULL) {
+        emu.hash_frames = true;
+        if (hash_log_path != NULL && !golden_open_log(&emu.golden, hash_log_path)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        if (golden_path != NULL && !golden_load_manifest(&emu.golden, golden_path)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
     }
-    
+
+    // Sortie série dans un fichier (les harnais y cherchent "Passed"/"Failed")
+    if (serial_path != NULL) {
+        emu.serial_file = fopen(serial_path, "wb");
+        if (!emu.serial_file) {
+            printf("Erreur: impossible d'ouvrir %s pour écriture\n", serial_path);
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        serial_set_stream(&emu.serial, emu.serial_file);
+    }
+
+    // Entrées joypad appliquées au cycle exact (rejeu déterministe)
+    if (input_path != NULL) {
+        if (!joypad_load_events(&emu.joypad, input_path)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        printf("Entrées joypad: %u événements (%s)\n", emu.joypad.event_count, input_path);
+    }
+
+    // Flux vidéo
+    if (video_path != NULL) {
+        VideoSinkFormat format = video_sink_format_from_path(video_path);
+        if (video_format != NULL) {
+            format = strcmp(video_format, "y4m") == 0 ? VIDEO_SINK_Y4M : VIDEO_SINK_PPM;
+        }
+        if (!video_sink_open(&emu.video, video_path, format, video_interval, emu.palette,
+                             video_scale, true)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+    }
+
+    // Sortie audio: l'horloge simulée consomme au rythme réel et cadence
+    // l'émulation
+    if (audio_pace) {
+        if (audio_rate < 8000 || audio_rate > 192000) {
+            printf("Taux audio invalide: %u Hz\n", audio_rate);
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        if (!apu_enable_output(&emu.apu, APU_SYNTH_RATE) ||
+            !audio_output_open(&emu.audio, APU_SYNTH_RATE, audio_rate, audio_latency) ||
+            !audio_output_start_clock(&emu.audio)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        printf("Audio: %u Hz, latence visée %u ms\n", audio_rate, audio_latency);
+    }
+
+    // Captures WAV au taux de synthèse: sortie exacte de l'APU, reproductible
+    // (sans le rapport ajusté de la sortie hôte)
+    if (wav_path != NULL || stems_prefix != NULL) {
+        if (!emu.apu.output_enabled && !apu_enable_output(&emu.apu, APU_SYNTH_RATE)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        if (wav_path != NULL) {
+            if (!wav_sink_open(&emu.wav, wav_path, APU_SYNTH_RATE, 2, true)) {
+                emulator_simple_cleanup(&emu);
+                return 1;
+            }
+            printf("Capture audio: %s\n", wav_path);
+        }
+        if (stems_prefix != NULL) {
+            for (int c = 0; c < 4; c++) {
+                char path[512];
+                snprintf(path, sizeof(path), "%s.ch%d.wav", stems_prefix, c + 1);
+                if (!wav_sink_open(&emu.stems[c], path, APU_SYNTH_RATE, 1, true)) {
+                    emulator_simple_cleanup(&emu);
+                    return 1;
+                }
+            }
+            emu.wav_stems = true;
+            printf("Capture audio par canal: %s.ch1.wav à %s.ch4.wav\n", stems_prefix, stems_prefix);
+        }
+    }
+
+    // Présentation: --headless choisit le backend null par défaut
+    if (backend == NULL) {
+        backend = video_backend_default(headless);
+    }
+    if (!emulator_simple_open_display(&emu, backend, shm_name, display_scale)) {
+        emulator_simple_cleanup(&emu);
+        return 1;
+    }
+
+    // Politique de rendu: sans backend qui présente les frames, personne ne
+    // regarde les pixels pendant l'exécution (le dump PPM re-rend la frame finale), sauf pour les
+    // frames hachées ou envoyées dans le flux vidéo
+    char output_render_mode[16];
+    if (render_mode == NULL && emu.use_render_thread) {
+        // Les pixels viennent du thread de rendu
+        render_mode = "never";
+    }
+    if (render_mode == NULL && (emu.hash_frames || video_path != NULL)) {
+        u32 interval = emu.hash_frames ? emu.golden.interval : emu.video.interval;
+        if (emu.hash_frames && video_path != NULL && emu.video.interval != interval) {
+            interval = 1;
+        }
+        snprintf(output_render_mode, sizeof(output_render_mode), "%u", interval);
+        render_mode = output_render_mode;
+    }
+    if (render_mode == NULL) {
+        render_mode = video_backend_renders(&emu.display) ? "always" : "never";
+    }
+    if (strcmp(render_mode, "never") == 0) {
+        ppu_set_render_policy(&emu.ppu, PPU_RENDER_NEVER, 1);
+    } else if (strcmp(render_mode, "on-demand") == 0) {
+        ppu_set_render_policy(&emu.ppu, PPU_RENDER_ON_DEMAND, 1);
+    } else if (render_mode[0] >= '1' && render_mode[0] <= '9') {
+        ppu_set_render_policy(&emu.ppu, PPU_RENDER_EVERY_N, (u32)atoi(render_mode));
+    } else {
+        ppu_set_render_policy(&emu.ppu, PPU_RENDER_ALWAYS, 1);
+    }
+
+    if (emu.use_render_thread) {
+        if (!render_thread_start(&emu.render_thread, emu.mmu.vram, &emu.mmu.vram_writes,
+                                 emulator_simple_output_frame, &emu)) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        render_thread_attach(&emu.render_thread, &emu.ppu);
+    }
+
     // Laisser le CPU s'exécuter d'abord pour charger les tiles
     
     // Nombre maximum de cycles
     u32 max_cycles = 1000000; // 1M cycles par défaut
     // Chercher un argument numérique pour max_cycles (permet l'ordre libre)
     for (int i = 2; i < argc; i++) {
+        if (argv[i][0] == '-' && strcmp(argv[i], "--headless") != 0 &&
+            strcmp(argv[i], "--render-thread") != 0 && strcmp(argv[i], "--audio-pace") != 0 &&
+            strcmp(argv[i], "--link-threads") != 0) {
+            i++;  // Option avec valeur: ne pas prendre sa valeur pour max_cycles
+            continue;
+        }
         if (argv[i][0] >= '0' && argv[i][0] <= '9') {
             max_cycles = (u32)atoi(argv[i]);
             break;
         }
     }
     
+    // Câble link: seconde instance sans affichage, sa sortie série reste en mémoire
+    EmulatorSimple* peer = NULL;
+    LinkCable link;
+    if (link_path != NULL) {
+        peer = malloc(sizeof(EmulatorSimple));
+        if (!peer) {
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        emulator_simple_init(peer);
+        serial_set_stream(&peer->serial, NULL);
+        printf("Tentative de chargement de la ROM partenaire: %s\n", link_path);
+        if (!mmu_load_rom(&peer->mmu, link_path) ||
+            !emulator_simple_open_display(peer, "null", NULL, display_scale)) {
+            printf("Erreur: Impossible de charger la ROM %s\n", link_path);
+            emulator_simple_cleanup(peer);
+            free(peer);
+            emulator_simple_cleanup(&emu);
+            return 1;
+        }
+        ppu_set_render_policy(&peer->ppu, PPU_RENDER_NEVER, 1);
+        printf("Câble link: %s%s\n", link_path, link_threads ? " (thread dédié)" : "");
+        // Branché avant la mise en route: les deux horloges partent de 0
+        link_init(&link, &emu.serial, &peer->serial, LINK_QUANTUM_CYCLES);
+    }
+    
     // Si l'affichage LCD est activé, augmenter le nombre de cycles
     if (emu.show_lcd) {
         max_cycles = 10000000; // 10M cycles pour voir l'affichage
@@ -536,16 +988,25 @@ int main(int argc, char* argv[]) {
         
         // Laisser le CPU s'exécuter un peu avant de commencer le rendu
         printf("Exécution initiale du CPU pour charger les tiles...\n");
-        for (int i = 0; i < 10000; i++) {
-            u8 cycles = cpu_step(&emu.cpu, &emu.mmu);
-            timer_tick(&emu.timer, cycles);
-            ppu_tick(&emu.ppu, cycles, emu.mmu.vram);
+        if (peer != NULL) {
+            // Instances reliées: mise en route des deux à travers le câble
+            link_run(&link, emulator_simple_run_until, &emu, peer, EMULATOR_WARMUP_CYCLES, link_threads);
+        } else {
+            for (int i = 0; i < 10000; i++) {
+                u8 cycles = cpu_step(&emu.cpu, &emu.mmu);
+                emu.total_cycles += cycles;
+                if (emu.total_cycles >= emu.scheduler.next) {
+                    scheduler_run(&emu.scheduler, emu.total_cycles);
+                }
+                ppu_tick(&emu.ppu, cycles, emu.mmu.vram);
+            }
         }
         printf("Chargement initial terminé\n");
         
         // Charger des tiles de caractères ASCII depuis console.bin
         printf("Chargement des tiles ASCII depuis console.bin...\n");
         load_console_tiles(emu.mmu.vram);
+        emu.mmu.vram_writes++;  // Écriture directe: invalider les copies du thread de rendu
         
         // Vérifier si des tiles ont été chargées
         printf("Vérification des tiles chargées...\n");
@@ -559,17 +1020,28 @@ int main(int argc, char* argv[]) {
     }
     
     // Lancer l'émulation
-    emulator_simple_run(&emu, max_cycles);
+    if (peer != NULL) {
+        emulator_simple_run_linked(&emu, peer, &link, max_cycles, link_threads);
+        emulator_simple_cleanup(peer);
+        free(peer);
+    } else {
+        emulator_simple_run(&emu, max_cycles);
+    }
+
+    // Terminer les frames en cours de rastérisation avant le bilan
+    render_thread_stop(&emu.render_thread);
+
+    int exit_code = 0;
+    if (emu.hash_frames && !golden_finish(&emu.golden)) {
+        exit_code = 2;
+    }
 
     if (emu.dump_ppm_path != NULL) {
-        // En mode headless, forcer un rendu complet d'une frame avant le dump
-        for (int y = 0; y < GB_HEIGHT; y++) {
-            emu.ppu.ly = (u8)y;
-            ppu_render_line(&emu.ppu, emu.mmu.vram);
-        }
-        write_framebuffer_to_ppm(emu.dump_ppm_path, emu.ppu.framebuffer);
+        // Forcer un rendu complet de la frame finale (la politique a pu sauter des frames)
+        ppu_render_frame(&emu.ppu, emu.mmu.vram);
+        write_framebuffer_to_ppm(emu.dump_ppm_path, emu.ppu.framebuffer, emu.palette);
     }
     
     emulator_simple_cleanup(&emu);
-    return 0;
+    return exit_code;
 }
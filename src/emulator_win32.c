@@ -31,7 +31,14 @@ void emulator_init(Emulator* emu) {
     ppu_init(&emu->ppu);
     joypad_init(&emu->joypad);
     
-    if (!graphics_win32_init(&emu->graphics)) {
+    // Connecter le timer, le PPU et le joypad au MMU
+    emu->mmu.timer = &emu->timer;
+    emu->mmu.ppu = &emu->ppu;
+    emu->mmu.joypad = &emu->joypad;
+    
+    // Fenêtre x4 (plus proche voisin)
+    ScalerMode scale = {4, SCALER_NEAREST};
+    if (!graphics_win32_init(&emu->graphics, scale)) {
         printf("Erreur: Impossible d'initialiser l'interface graphique\n");
         exit(1);
     }
@@ -82,11 +89,8 @@ void emulator_run(Emulator* emu) {
     printf("Chargement initial terminé\n");
     
     // Forcer un premier rendu complet
-    for (int y = 0; y < GB_HEIGHT; y++) {
-        emu->ppu.ly = (u8)y;
-        ppu_render_line(&emu->ppu, emu->mmu.vram);
-    }
-    graphics_win32_update(&emu->graphics, (u32*)emu->ppu.framebuffer);
+    ppu_render_frame(&emu->ppu, emu->mmu.vram);
+    graphics_win32_update(&emu->graphics, emu->ppu.framebuffer, &FB_PALETTE_GRAY);
     graphics_win32_present(&emu->graphics);
     
     while (emu->running && emu->graphics.running) {
@@ -115,10 +119,8 @@ void emulator_run(Emulator* emu) {
             }
         }
         
-        // Vérifier si on a atteint une frame
-        if (emu->current_cycles >= emu->cycles_per_frame) {
-            emu->current_cycles -= emu->cycles_per_frame;
-            
+        // Présenter une fois par frame rendue par le PPU
+        if (ppu_frame_ready(&emu->ppu)) {
             // Debug: afficher BG map une fois
             static bool debug_done = false;
             if (!debug_done) {
@@ -130,12 +132,7 @@ void emulator_run(Emulator* emu) {
                 debug_done = true;
             }
             
-            // Rendre toutes les lignes de la frame
-            for (int y = 0; y < GB_HEIGHT; y++) {
-                emu->ppu.ly = (u8)y;
-                ppu_render_line(&emu->ppu, emu->mmu.vram);
-            }
-            graphics_win32_update(&emu->graphics, (u32*)emu->ppu.framebuffer);
+            graphics_win32_update(&emu->graphics, emu->ppu.framebuffer, &FB_PALETTE_GRAY);
             graphics_win32_present(&emu->graphics);
         }
         
@@ -0,0 +1,295 @@
+#include "framebuffer.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const FbPalette FB_PALETTE_GRAY = {{ 0xFFFFFF, 0xAAAAAA, 0x555555, 0x000000 }};
+const FbPalette FB_PALETTE_GREEN = {{ 0x9BBC0F, 0x8BAC0F, 0x306230, 0x0F380F }};
+
+u32 fb_format_bytes_per_pixel(FbFormat format) {
+    switch (format) {
+        case FB_FORMAT_RGBA8888: return 4;
+        case FB_FORMAT_RGB565:   return 2;
+        case FB_FORMAT_GRAY8:    return 1;
+        case FB_FORMAT_RGB24:
+        case FB_FORMAT_BGR24:    return 3;
+    }
+    return 0;
+}
+
+const FbPalette* fb_palette_by_name(const char* name) {
+    if (strcmp(name, "gray") == 0) return &FB_PALETTE_GRAY;
+    if (strcmp(name, "green") == 0) return &FB_PALETTE_GREEN;
+    return NULL;
+}
+
+// Tables de conversion: une entrée par teinte
+static void fb_build_lut(const FbPalette* palette, FbFormat format, u32 lut[4]) {
+    for (int i = 0; i < 4; i++) {
+        u32 c = palette->rgb[i];
+        u32 r = (c >> 16) & 0xFF;
+        u32 g = (c >> 8) & 0xFF;
+        u32 b = c & 0xFF;
+        switch (format) {
+            case FB_FORMAT_RGBA8888: lut[i] = (c << 8) | 0xFF; break;
+            case FB_FORMAT_RGB565:   lut[i] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3); break;
+            case FB_FORMAT_GRAY8:    lut[i] = (r * 77 + g * 150 + b * 29) >> 8; break;
+            case FB_FORMAT_RGB24:    lut[i] = c; break;
+            case FB_FORMAT_BGR24:    lut[i] = (b << 16) | (g << 8) | r; break;
+        }
+    }
+}
+
+// Teinte -> octet via table (plan de gris, plans Y/U/V...)
+void fb_map_u8_n(const u8* src, u8* dst, u32 count, const u8 lut[4]) {
+    u32 i = 0;
+#if defined(__SSE2__)
+    // 16 pixels par itération: sélection par comparaison sur les 4 teintes
+    const __m128i k1 = _mm_set1_epi8(1), k2 = _mm_set1_epi8(2), k3 = _mm_set1_epi8(3);
+    const __m128i l0 = _mm_set1_epi8((char)lut[0]), l1 = _mm_set1_epi8((char)lut[1]);
+    const __m128i l2 = _mm_set1_epi8((char)lut[2]), l3 = _mm_set1_epi8((char)lut[3]);
+    for (; i + 16 <= count; i += 16) {
+        __m128i idx = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i m1 = _mm_cmpeq_epi8(idx, k1);
+        __m128i m2 = _mm_cmpeq_epi8(idx, k2);
+        __m128i m3 = _mm_cmpeq_epi8(idx, k3);
+        __m128i m0 = _mm_andnot_si128(_mm_or_si128(m1, _mm_or_si128(m2, m3)), _mm_set1_epi8(-1));
+        __m128i v = _mm_or_si128(_mm_and_si128(m0, l0), _mm_and_si128(m1, l1));
+        v = _mm_or_si128(v, _mm_or_si128(_mm_and_si128(m2, l2), _mm_and_si128(m3, l3)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = lut[src[i] & 3];
+    }
+}
+
+static void fb_convert_rgb565(const u8* src, u16* dst, u32 count, const u32 lut[4]) {
+    u32 i = 0;
+#if defined(__SSE2__)
+    // 8 pixels par itération (indices élargis en 16 bits)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k1 = _mm_set1_epi16(1), k2 = _mm_set1_epi16(2), k3 = _mm_set1_epi16(3);
+    const __m128i l0 = _mm_set1_epi16((short)lut[0]), l1 = _mm_set1_epi16((short)lut[1]);
+    const __m128i l2 = _mm_set1_epi16((short)lut[2]), l3 = _mm_set1_epi16((short)lut[3]);
+    for (; i + 8 <= count; i += 8) {
+        __m128i idx = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + i)), zero);
+        __m128i m1 = _mm_cmpeq_epi16(idx, k1);
+        __m128i m2 = _mm_cmpeq_epi16(idx, k2);
+        __m128i m3 = _mm_cmpeq_epi16(idx, k3);
+        __m128i m0 = _mm_cmpeq_epi16(idx, zero);
+        __m128i v = _mm_or_si128(_mm_and_si128(m0, l0), _mm_and_si128(m1, l1));
+        v = _mm_or_si128(v, _mm_or_si128(_mm_and_si128(m2, l2), _mm_and_si128(m3, l3)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = (u16)lut[src[i] & 3];
+    }
+}
+
+static void fb_convert_rgba8888(const u8* src, u32* dst, u32 count, const u32 lut[4]) {
+    u32 i = 0;
+#if defined(__SSE2__)
+    // 4 pixels par itération (indices élargis en 32 bits)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k1 = _mm_set1_epi32(1), k2 = _mm_set1_epi32(2), k3 = _mm_set1_epi32(3);
+    const __m128i l0 = _mm_set1_epi32((int)lut[0]), l1 = _mm_set1_epi32((int)lut[1]);
+    const __m128i l2 = _mm_set1_epi32((int)lut[2]), l3 = _mm_set1_epi32((int)lut[3]);
+    for (; i + 4 <= count; i += 4) {
+        u32 word;
+        memcpy(&word, src + i, 4);
+        __m128i idx = _mm_cvtsi32_si128((int)word);
+        idx = _mm_unpacklo_epi16(_mm_unpacklo_epi8(idx, zero), zero);
+        __m128i m1 = _mm_cmpeq_epi32(idx, k1);
+        __m128i m2 = _mm_cmpeq_epi32(idx, k2);
+        __m128i m3 = _mm_cmpeq_epi32(idx, k3);
+        __m128i m0 = _mm_cmpeq_epi32(idx, zero);
+        __m128i v = _mm_or_si128(_mm_and_si128(m0, l0), _mm_and_si128(m1, l1));
+        v = _mm_or_si128(v, _mm_or_si128(_mm_and_si128(m2, l2), _mm_and_si128(m3, l3)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = lut[src[i] & 3];
+    }
+}
+
+static void fb_convert_24(const u8* src, u8* dst, u32 count, const u32 lut[4]) {
+    u32 i = 0;
+#if defined(__SSE2__)
+    // 4 pixels par itération: sélection en 32 bits (octets dans l'ordre de
+    // sortie, 4e octet nul), puis compactage des 4 x 3 octets en 12 octets
+    u32 bytes[4];
+    for (int t = 0; t < 4; t++) {
+        bytes[t] = ((lut[t] >> 16) & 0xFF) | (lut[t] & 0xFF00) | ((lut[t] & 0xFF) << 16);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k1 = _mm_set1_epi32(1), k2 = _mm_set1_epi32(2), k3 = _mm_set1_epi32(3);
+    const __m128i l0 = _mm_set1_epi32((int)bytes[0]), l1 = _mm_set1_epi32((int)bytes[1]);
+    const __m128i l2 = _mm_set1_epi32((int)bytes[2]), l3 = _mm_set1_epi32((int)bytes[3]);
+    const __m128i even = _mm_set_epi32(0, -1, 0, -1);                       // Octets 0-3 de chaque moitié
+    const __m128i odd = _mm_set_epi32(-1, (int)0xFF000000, -1, (int)0xFF000000);  // Octets 3-7
+    const __m128i first = _mm_set_epi32(0, 0, 0x0000FFFF, -1);              // Octets 0-5
+    const __m128i second = _mm_set_epi32(0, -1, (int)0xFFFF0000, 0);       // Octets 6-11
+    for (; i + 4 <= count; i += 4) {
+        u32 word;
+        memcpy(&word, src + i, 4);
+        __m128i idx = _mm_cvtsi32_si128((int)word);
+        idx = _mm_unpacklo_epi16(_mm_unpacklo_epi8(idx, zero), zero);
+        __m128i m1 = _mm_cmpeq_epi32(idx, k1);
+        __m128i m2 = _mm_cmpeq_epi32(idx, k2);
+        __m128i m3 = _mm_cmpeq_epi32(idx, k3);
+        __m128i m0 = _mm_cmpeq_epi32(idx, zero);
+        __m128i v = _mm_or_si128(_mm_and_si128(m0, l0), _mm_and_si128(m1, l1));
+        v = _mm_or_si128(v, _mm_or_si128(_mm_and_si128(m2, l2), _mm_and_si128(m3, l3)));
+        // Dans chaque moitié de 64 bits, le pixel impair rejoint le pair (6 octets)
+        v = _mm_or_si128(_mm_and_si128(v, even), _mm_and_si128(_mm_srli_epi64(v, 8), odd));
+        // Puis la seconde moitié rejoint la première (12 octets)
+        v = _mm_or_si128(_mm_and_si128(v, first), _mm_and_si128(_mm_srli_si128(v, 2), second));
+        _mm_storel_epi64((__m128i*)dst, v);
+        u32 tail = (u32)_mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        memcpy(dst + 8, &tail, 4);
+        dst += 12;
+    }
+#endif
+    for (; i < count; i++) {
+        u32 c = lut[src[i] & 3];
+        dst[0] = (u8)(c >> 16);
+        dst[1] = (u8)(c >> 8);
+        dst[2] = (u8)c;
+        dst += 3;
+    }
+}
+
+void fb_map_u8(const u8* src, u8* dst, const u8 lut[4]) {
+    fb_map_u8_n(src, dst, FB_PIXELS, lut);
+}
+
+void fb_convert(const u8* indexed, void* out, FbFormat format, const FbPalette* palette) {
+    fb_convert_n(indexed, out, FB_PIXELS, format, palette);
+}
+
+void fb_convert_n(const u8* indexed, void* out, u32 count, FbFormat format, const FbPalette* palette) {
+    u32 lut[4];
+    fb_build_lut(palette ? palette : &FB_PALETTE_GRAY, format, lut);
+
+    switch (format) {
+        case FB_FORMAT_RGBA8888: fb_convert_rgba8888(indexed, (u32*)out, count, lut); break;
+        case FB_FORMAT_RGB565:   fb_convert_rgb565(indexed, (u16*)out, count, lut); break;
+        case FB_FORMAT_GRAY8: {
+            const u8 gray[4] = { (u8)lut[0], (u8)lut[1], (u8)lut[2], (u8)lut[3] };
+            fb_map_u8_n(indexed, (u8*)out, count, gray);
+            break;
+        }
+        case FB_FORMAT_RGB24:
+        case FB_FORMAT_BGR24:    fb_convert_24(indexed, (u8*)out, count, lut); break;
+    }
+}
+
+void fb_pack_2bpp(const u8* indexed, u8* packed) {
+    for (u32 i = 0; i < FB_PACKED_SIZE; i++) {
+        const u8* p = &indexed[i * 4];
+        packed[i] = (u8)((p[0] & 3) | ((p[1] & 3) << 2) | ((p[2] & 3) << 4) | ((p[3] & 3) << 6));
+    }
+}
+
+void fb_unpack_2bpp(const u8* packed, u8* indexed) {
+    for (u32 i = 0; i < FB_PACKED_SIZE; i++) {
+        u8 b = packed[i];
+        u8* p = &indexed[i * 4];
+        p[0] = b & 3;
+        p[1] = (b >> 2) & 3;
+        p[2] = (b >> 4) & 3;
+        p[3] = (b >> 6) & 3;
+    }
+}
+
+// xxHash64: 4 accumulateurs indépendants sur des blocs de 32 octets
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline u64 xxh_rotl64(u64 x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline u64 xxh_read64(const u8* p) {
+    u64 v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline u32 xxh_read32(const u8* p) {
+    u32 v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline u64 xxh_round(u64 acc, u64 input) {
+    acc += input * XXH_PRIME64_2;
+    acc = xxh_rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline u64 xxh_merge(u64 acc, u64 val) {
+    acc ^= xxh_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+u64 fb_hash64(const void* data, size_t len, u64 seed) {
+    const u8* p = (const u8*)data;
+    const u8* end = p + len;
+    u64 h;
+
+    if (len >= 32) {
+        u64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        u64 v2 = seed + XXH_PRIME64_2;
+        u64 v3 = seed;
+        u64 v4 = seed - XXH_PRIME64_1;
+        const u8* limit = end - 32;
+        do {
+            v1 = xxh_round(v1, xxh_read64(p));
+            v2 = xxh_round(v2, xxh_read64(p + 8));
+            v3 = xxh_round(v3, xxh_read64(p + 16));
+            v4 = xxh_round(v4, xxh_read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = xxh_rotl64(v1, 1) + xxh_rotl64(v2, 7) + xxh_rotl64(v3, 12) + xxh_rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+    h += (u64)len;
+
+    while (p + 8 <= end) {
+        h ^= xxh_round(0, xxh_read64(p));
+        h = xxh_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (u64)xxh_read32(p) * XXH_PRIME64_1;
+        h = xxh_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (u64)(*p) * XXH_PRIME64_5;
+        h = xxh_rotl64(h, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    // Avalanche finale
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
@@ -0,0 +1,45 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "common.h"
+
+// Framebuffer indexé: 1 octet par pixel, teinte DMG 0 (clair) à 3 (foncé)
+// après application de BGP. La conversion vers un format de sortie se fait
+// une seule fois par frame, au moment de la présentation.
+#define FB_PIXELS       (GB_WIDTH * GB_HEIGHT)
+#define FB_PACKED_SIZE  (FB_PIXELS / 4)  // 2 bits par pixel
+
+// Formats de sortie
+typedef enum {
+    FB_FORMAT_RGBA8888 = 0,  // u32 0xRRGGBBAA
+    FB_FORMAT_RGB565,        // u16
+    FB_FORMAT_GRAY8,         // u8 (luminance)
+    FB_FORMAT_RGB24,         // 3 octets R,G,B (PPM)
+    FB_FORMAT_BGR24          // 3 octets B,G,R (DIB Win32)
+} FbFormat;
+
+// Palette: couleur 0xRRGGBB pour chaque teinte DMG
+typedef struct {
+    u32 rgb[4];
+} FbPalette;
+
+extern const FbPalette FB_PALETTE_GRAY;   // FF, AA, 55, 00
+extern const FbPalette FB_PALETTE_GREEN;  // Vert LCD DMG
+
+// Conversion
+u32 fb_format_bytes_per_pixel(FbFormat format);
+void fb_convert(const u8* indexed, void* out, FbFormat format, const FbPalette* palette);
+void fb_map_u8(const u8* indexed, u8* out, const u8 lut[4]);
+// Variantes sur un nombre quelconque de pixels (surfaces mises à l'échelle)
+void fb_convert_n(const u8* indexed, void* out, u32 count, FbFormat format, const FbPalette* palette);
+void fb_map_u8_n(const u8* indexed, u8* out, u32 count, const u8 lut[4]);
+const FbPalette* fb_palette_by_name(const char* name);  // NULL si inconnue
+
+// Empreinte 64 bits (xxHash64) pour les tests de régression par frame
+u64 fb_hash64(const void* data, size_t len, u64 seed);
+
+// Compactage 2 bits/pixel (anneaux de frames récentes)
+void fb_pack_2bpp(const u8* indexed, u8* packed);
+void fb_unpack_2bpp(const u8* packed, u8* indexed);
+
+#endif // FRAMEBUFFER_H
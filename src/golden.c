@@ -0,0 +1,142 @@
+#include "golden.h"
+#include <inttypes.h>
+
+void golden_init(GoldenCheck* golden, u32 interval) {
+    memset(golden, 0, sizeof(GoldenCheck));
+    golden->interval = interval ? interval : 1;
+}
+
+void golden_cleanup(GoldenCheck* golden) {
+    if (golden->log) {
+        fclose(golden->log);
+        golden->log = NULL;
+    }
+    free(golden->entries);
+    golden->entries = NULL;
+    golden->count = 0;
+    golden->capacity = 0;
+}
+
+// Insertion triée (les manifestes sont normalement déjà dans l'ordre)
+void golden_add_expected(GoldenCheck* golden, u32 frame, u64 hash) {
+    if (golden->count == golden->capacity) {
+        u32 capacity = golden->capacity ? golden->capacity * 2 : 256;
+        GoldenEntry* entries = realloc(golden->entries, capacity * sizeof(GoldenEntry));
+        if (!entries) {
+            printf("Erreur: mémoire insuffisante pour le manifeste\n");
+            return;
+        }
+        golden->entries = entries;
+        golden->capacity = capacity;
+    }
+
+    u32 i = golden->count;
+    while (i > 0 && golden->entries[i - 1].frame > frame) {
+        golden->entries[i] = golden->entries[i - 1];
+        i--;
+    }
+    golden->entries[i].frame = frame;
+    golden->entries[i].hash = hash;
+    golden->count++;
+}
+
+bool golden_load_manifest(GoldenCheck* golden, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Erreur: impossible d'ouvrir le manifeste %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    u32 line_no = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        unsigned long frame;
+        unsigned long long hash;
+        if (sscanf(line, "%lu %llx", &frame, &hash) != 2) {
+            printf("Manifeste %s:%u: ligne ignorée\n", path, line_no);
+            continue;
+        }
+        golden_add_expected(golden, (u32)frame, (u64)hash);
+    }
+    fclose(f);
+
+    printf("Manifeste chargé: %s (%u frames)\n", path, golden->count);
+    return true;
+}
+
+bool golden_open_log(GoldenCheck* golden, const char* path) {
+    golden->log = fopen(path, "w");
+    if (!golden->log) {
+        printf("Erreur: impossible d'ouvrir %s pour écriture\n", path);
+        return false;
+    }
+    fprintf(golden->log, "# frame hash (xxh64, framebuffer indexé %dx%d)\n", GB_WIDTH, GB_HEIGHT);
+    return true;
+}
+
+bool golden_wants_frame(const GoldenCheck* golden, u32 frame) {
+    return (frame % golden->interval) == 0;
+}
+
+bool golden_check_frame(GoldenCheck* golden, u32 frame, u64 hash) {
+    golden->hashed++;
+    if (golden->log) {
+        fprintf(golden->log, "%u %016" PRIx64 "\n", frame, hash);
+    }
+
+    // Entrées antérieures jamais hachées (frame sautée par la politique de rendu)
+    while (golden->next < golden->count && golden->entries[golden->next].frame < frame) {
+        golden->missing++;
+        golden->next++;
+    }
+    if (golden->next >= golden->count || golden->entries[golden->next].frame != frame) {
+        return true;  // Frame absente du manifeste: journalisée seulement
+    }
+
+    u64 expected = golden->entries[golden->next++].hash;
+    if (expected == hash) {
+        golden->matched++;
+        return true;
+    }
+
+    golden->mismatches++;
+    if (!golden->diverged) {
+        golden->diverged = true;
+        golden->first_divergent_frame = frame;
+        golden->expected_hash = expected;
+        golden->actual_hash = hash;
+        printf("Divergence frame %u: attendu %016" PRIx64 ", obtenu %016" PRIx64 "\n",
+               frame, expected, hash);
+    }
+    return false;
+}
+
+bool golden_finish(GoldenCheck* golden) {
+    golden->missing += golden->count - golden->next;
+    golden->next = golden->count;
+    if (golden->log) {
+        fflush(golden->log);
+    }
+
+    if (golden->count == 0) {
+        printf("Empreintes: %u frames hachées\n", golden->hashed);
+        return true;
+    }
+
+    printf("Empreintes: %u hachées, %u identiques, %u différentes, %u manquantes\n",
+           golden->hashed, golden->matched, golden->mismatches, golden->missing);
+    if (golden->diverged) {
+        printf("Première frame divergente: %u\n", golden->first_divergent_frame);
+        return false;
+    }
+    // Frames attendues jamais hachées: rendu interrompu ou exécution trop courte
+    if (golden->missing > 0) {
+        printf("Échec: %u frames du manifeste non atteintes\n", golden->missing);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include "common.h"
+
+// Régression par empreintes de frames.
+// Format manifeste / journal (texte, une frame par ligne):
+//   <numéro de frame> <hash 64 bits en hexadécimal>
+// Les lignes commençant par '#' sont ignorées: un journal produit par
+// --hash-log peut servir tel quel de manifeste de référence.
+
+typedef struct {
+    u32 frame;
+    u64 hash;
+} GoldenEntry;
+
+typedef struct {
+    // Manifeste attendu (trié par numéro de frame)
+    GoldenEntry* entries;
+    u32 count;
+    u32 capacity;
+    u32 next;           // Prochaine entrée à comparer
+
+    FILE* log;          // Journal des empreintes calculées (optionnel)
+    u32 interval;       // Une frame sur N est hachée
+
+    // Résultats
+    u32 hashed;         // Frames hachées
+    u32 matched;        // Frames comparées et identiques
+    u32 mismatches;     // Frames comparées et différentes
+    u32 missing;        // Frames du manifeste jamais atteintes/rendues
+    bool diverged;
+    u32 first_divergent_frame;
+    u64 expected_hash;
+    u64 actual_hash;
+} GoldenCheck;
+
+// Cycle de vie
+void golden_init(GoldenCheck* golden, u32 interval);
+bool golden_load_manifest(GoldenCheck* golden, const char* path);
+bool golden_open_log(GoldenCheck* golden, const char* path);
+void golden_cleanup(GoldenCheck* golden);
+
+// Manifeste
+void golden_add_expected(GoldenCheck* golden, u32 frame, u64 hash);
+
+// Vérification (frames dans l'ordre croissant)
+bool golden_wants_frame(const GoldenCheck* golden, u32 frame);
+bool golden_check_frame(GoldenCheck* golden, u32 frame, u64 hash);  // false si divergence
+bool golden_finish(GoldenCheck* golden);  // Rapport; true si aucune divergence ni frame manquante
+
+#endif // GOLDEN_H
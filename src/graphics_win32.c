@@ -39,18 +39,29 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 }
 
 // Initialisation de l'interface graphique Win32
-bool graphics_win32_init(GraphicsWin32* gfx) {
+bool graphics_win32_init(GraphicsWin32* gfx, ScalerMode scale) {
     memset(gfx, 0, sizeof(GraphicsWin32));
     
-    gfx->width = 160;   // Largeur Game Boy
-    gfx->height = 144;  // Hauteur Game Boy
+    if (!scaler_init(&gfx->scaler, GB_WIDTH, GB_HEIGHT, scale)) {
+        printf("Erreur: mise à l'échelle x%u non supportée\n", scale.factor);
+        return false;
+    }
+    gfx->width = (int)gfx->scaler.width;
+    gfx->height = (int)gfx->scaler.height;
     gfx->running = true;
     gfx->visible = false;  // Commencer caché
     
-    // Allouer le framebuffer
+    // Allouer le framebuffer (lignes DIB 24 bits alignées sur 4 octets:
+    // 160 * facteur * 3 l'est toujours)
     gfx->framebuffer = calloc(gfx->width * gfx->height * 3, 1);
-    if (!gfx->framebuffer) {
+    if (scale.factor > 1) {
+        gfx->scaled = malloc(gfx->width * gfx->height);
+    }
+    if (!gfx->framebuffer || (scale.factor > 1 && !gfx->scaled)) {
         printf("Erreur: Impossible d'allouer le framebuffer\n");
+        free(gfx->framebuffer);
+        free(gfx->scaled);
+        scaler_cleanup(&gfx->scaler);
         return false;
     }
     
@@ -74,18 +85,20 @@ bool graphics_win32_init(GraphicsWin32* gfx) {
     
     if (!RegisterClassEx(&wc)) {
         printf("Erreur: Impossible d'enregistrer la classe de fenêtre\n");
-        free(gfx->framebuffer);
+        graphics_win32_cleanup(gfx);
         return false;
     }
     
-    // Créer la fenêtre (cachée par défaut)
+    // Créer la fenêtre (cachée par défaut), zone cliente à la taille du DIB
+    RECT rect = {0, 0, gfx->width, gfx->height};
+    AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
     gfx->hwnd = CreateWindowEx(
         0,
         "CameBoy",
         "CameBoy - Game Boy LCD",
         WS_OVERLAPPEDWINDOW,
         CW_USEDEFAULT, CW_USEDEFAULT,
-        gfx->width * 4, gfx->height * 4, // 4x zoom
+        rect.right - rect.left, rect.bottom - rect.top,
         NULL, NULL,
         GetModuleHandle(NULL),
         NULL
@@ -93,7 +106,7 @@ bool graphics_win32_init(GraphicsWin32* gfx) {
     
     if (!gfx->hwnd) {
         printf("Erreur: Impossible de créer la fenêtre\n");
-        free(gfx->framebuffer);
+        graphics_win32_cleanup(gfx);
         return false;
     }
     
@@ -131,29 +144,23 @@ void graphics_win32_cleanup(GraphicsWin32* gfx) {
         free(gfx->framebuffer);
         gfx->framebuffer = NULL;
     }
+    
+    free(gfx->scaled);
+    gfx->scaled = NULL;
+    scaler_cleanup(&gfx->scaler);
 }
 
 // Mettre à jour le framebuffer
-void graphics_win32_update(GraphicsWin32* gfx, u32* ppu_framebuffer) {
+void graphics_win32_update(GraphicsWin32* gfx, const u8* ppu_framebuffer, const FbPalette* palette) {
     if (!gfx || !ppu_framebuffer) return;
     
-    // Copier les données du framebuffer PPU (u32 RGBA: RRGGBBAA) vers notre framebuffer RGB
-    for (int y = 0; y < gfx->height; y++) {
-        for (int x = 0; x < gfx->width; x++) {
-            int src_idx = y * gfx->width + x;
-            int dst_idx = (y * gfx->width + x) * 3;
-            
-            // Convertir de u32 RGBA (RRGGBBAA) vers RGB
-            u32 pixel = ppu_framebuffer[src_idx];
-            u8 r = (pixel >> 24) & 0xFF; // R
-            u8 g = (pixel >> 16) & 0xFF; // G
-            u8 b = (pixel >> 8)  & 0xFF; // B
-            
-            gfx->framebuffer[dst_idx + 0] = b; // B
-            gfx->framebuffer[dst_idx + 1] = g; // G
-            gfx->framebuffer[dst_idx + 2] = r; // R
-        }
+    // Mise à l'échelle des teintes, puis conversion vers le DIB 24 bits (B, G, R)
+    const u8* indexed = ppu_framebuffer;
+    if (gfx->scaled) {
+        scaler_run(&gfx->scaler, ppu_framebuffer, gfx->scaled, (u32)gfx->width);
+        indexed = gfx->scaled;
     }
+    fb_convert_n(indexed, gfx->framebuffer, (u32)(gfx->width * gfx->height), FB_FORMAT_BGR24, palette);
 }
 
 // Afficher le framebuffer
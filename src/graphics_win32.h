@@ -2,6 +2,8 @@
 #define GRAPHICS_WIN32_H
 
 #include "common.h"
+#include "framebuffer.h"
+#include "scaler.h"
 #include <windows.h>
 
 // Structure pour l'interface graphique Win32
@@ -11,16 +13,18 @@ typedef struct {
     HBITMAP hbitmap;
     BITMAPINFO bmi;
     u8* framebuffer;
+    Scaler scaler;   // Mise à l'échelle CPU avant le blit (GDI ne zoome plus)
+    u8* scaled;      // Teintes mises à l'échelle (NULL en x1)
     bool running;
-    int width;
+    int width;       // Dimensions du DIB (mises à l'échelle)
     int height;
     bool visible;  // Pour contrôler la visibilité de la fenêtre
 } GraphicsWin32;
 
 // Fonctions graphiques Win32
-bool graphics_win32_init(GraphicsWin32* gfx);
+bool graphics_win32_init(GraphicsWin32* gfx, ScalerMode scale);
 void graphics_win32_cleanup(GraphicsWin32* gfx);
-void graphics_win32_update(GraphicsWin32* gfx, u32* ppu_framebuffer);
+void graphics_win32_update(GraphicsWin32* gfx, const u8* ppu_framebuffer, const FbPalette* palette);
 void graphics_win32_present(GraphicsWin32* gfx);
 void graphics_win32_handle_events(GraphicsWin32* gfx, bool* running);
 void graphics_win32_show(GraphicsWin32* gfx);
@@ -1,75 +1,82 @@
 #include "interrupt.h"
 #include <stdio.h>
 
+// Recalcule le drapeau en cache après toute modification de IE, IF ou IME
+static void interrupt_refresh(InterruptManager* im) {
+    im->active = *im->ie & *im->if_reg & im->ime_mask;
+}
+
 // Initialisation du gestionnaire d'interruptions
 void interrupt_init(InterruptManager* im) {
-    im->ie = 0x00;
-    im->if_reg = 0xE1; // Valeur par défaut selon Pan Docs
-    im->pending_interrupts = 0x00;
+    im->ie = &im->local_ie;
+    im->if_reg = &im->local_if;
+    interrupt_reset(im);
 }
 
 // Reset du gestionnaire d'interruptions
 void interrupt_reset(InterruptManager* im) {
-    im->ie = 0x00;
-    im->if_reg = 0xE1;
-    im->pending_interrupts = 0x00;
+    *im->ie = 0x00;
+    *im->if_reg = 0xE1; // Valeur par défaut selon Pan Docs
+    im->ime_mask = 0x00;
+    interrupt_refresh(im);
+}
+
+// IE/IF deviennent les registres de la MMU, qui lui renvoie leurs écritures
+void interrupt_attach(InterruptManager* im, MMU* mmu) {
+    im->ie = &mmu->memory[IE_REG];
+    im->if_reg = &mmu->memory[IF_REG];
+    mmu->interrupts = im;
+    interrupt_refresh(im);
+}
+
+void interrupt_set_ime(InterruptManager* im, bool ime) {
+    im->ime_mask = ime ? 0x1F : 0x00;
+    interrupt_refresh(im);
 }
 
 // Écriture dans le registre IE
 void interrupt_write_ie(InterruptManager* im, u8 value) {
-    im->ie = value;
+    *im->ie = value;
+    interrupt_refresh(im);
 }
 
 // Lecture du registre IE
 u8 interrupt_read_ie(InterruptManager* im) {
-    return im->ie;
+    return *im->ie;
 }
 
 // Écriture dans le registre IF
 void interrupt_write_if(InterruptManager* im, u8 value) {
-    im->if_reg = value;
+    *im->if_reg = value;
+    interrupt_refresh(im);
 }
 
 // Lecture du registre IF
 u8 interrupt_read_if(InterruptManager* im) {
-    return im->if_reg;
+    return *im->if_reg;
 }
 
 // Demander une interruption
 void interrupt_request(InterruptManager* im, u8 interrupt) {
-    im->if_reg |= interrupt;
-    im->pending_interrupts |= interrupt;
+    *im->if_reg |= interrupt;
+    interrupt_refresh(im);
 }
 
 // Effacer une interruption
 void interrupt_clear(InterruptManager* im, u8 interrupt) {
-    im->if_reg &= ~interrupt;
-    im->pending_interrupts &= ~interrupt;
-}
-
-// Obtenir les interruptions en attente
-u8 interrupt_get_pending(InterruptManager* im) {
-    return im->pending_interrupts;
+    *im->if_reg &= ~interrupt;
+    interrupt_refresh(im);
 }
 
 // Vérifier s'il y a des interruptions en attente
 bool interrupt_has_pending(InterruptManager* im) {
-    return (im->if_reg & im->ie) != 0;
+    return (*im->if_reg & *im->ie & 0x1F) != 0;
 }
 
-// Obtenir l'interruption de priorité la plus haute
+// Obtenir l'interruption de priorité la plus haute (bit le plus bas de IE & IF)
 u8 interrupt_get_highest_priority(InterruptManager* im) {
-    u8 active_interrupts = im->if_reg & im->ie;
-    
-    // Vérifier par ordre de priorité (bit 0 = priorité la plus haute)
-    for (int i = 0; i < 5; i++) {
-        u8 interrupt = 1 << i;
-        if (active_interrupts & interrupt) {
-            return interrupt;
-        }
-    }
-    
-    return 0; // Aucune interruption active
+    u8 active_interrupts = *im->if_reg & *im->ie & 0x1F;
+    return active_interrupts & (u8)-active_interrupts;
 }
 
 // Obtenir le nom d'une interruption (pour debug)
@@ -84,61 +91,69 @@ const char* interrupt_get_name(u8 interrupt) {
     }
 }
 
-// Obtenir l'adresse du gestionnaire d'interruption
+// Obtenir l'adresse du gestionnaire d'interruption (0 si pas une source unique)
 u16 interrupt_get_handler_address(u8 interrupt) {
-    switch (interrupt) {
-        case VBLANK_INT:   return INT_VBLANK_ADDR;
-        case LCD_STAT_INT: return INT_LCD_STAT_ADDR;
-        case TIMER_INT:    return INT_TIMER_ADDR;
-        case SERIAL_INT:   return INT_SERIAL_ADDR;
-        case JOYPAD_INT:   return INT_JOYPAD_ADDR;
-        default:           return 0x0000;
+    if (interrupt == 0 || interrupt > JOYPAD_INT || (interrupt & (interrupt - 1))) {
+        return 0x0000;
     }
+    return INTERRUPT_VECTOR(__builtin_ctz(interrupt));
+}
+
+// Empiler PC: écriture directe quand les deux octets tombent en WRAM ou en
+// HRAM (pile normale), sinon accès décodé par la MMU
+static void interrupt_push_pc(CPU* cpu, MMU* mmu) {
+    u16 sp = (u16)(cpu->sp - 2);
+    if ((sp >= 0xC000 && sp <= 0xDFFE) || (sp >= 0xFF80 && sp <= 0xFFFD)) {
+        u8* stack = &mmu->memory[sp];
+        stack[0] = cpu->pc & 0xFF;
+        stack[1] = cpu->pc >> 8;
+    } else {
+        mmu_write16(mmu, sp, cpu->pc);
+    }
+    cpu->sp = sp;
 }
 
-// Routine de service d'interruption
-void interrupt_service_routine(CPU* cpu, MMU* mmu, u8 interrupt) {
-    // 1. Désactiver les interruptions (IME = 0)
-    cpu->ime = false;
-    
-    // 2. Effacer le flag d'interruption
-    u8 if_reg = mmu_read8(mmu, IF_REG);
-    mmu_write8(mmu, IF_REG, if_reg & ~interrupt);
+// Routine de service de l'interruption n (bit n de IF)
+static void interrupt_dispatch(CPU* cpu, MMU* mmu, u32 n) {
+    // 1. Désactiver les interruptions (IME = 0) et sortir de HALT
+    cpu_set_ime(cpu, mmu, false);
+    cpu->halted = false;
     
-    // 3. Attendre 2 cycles (2 M-cycles)
-    // (géré par l'appelant)
-    
-    // 4. Empiler PC sur la pile (2 M-cycles)
-    cpu->sp -= 2;
-    mmu_write16(mmu, cpu->sp, cpu->pc);
+    // 2. Effacer le flag d'interruption (registre de la MMU, cache à jour)
+    if (mmu->interrupts) {
+        interrupt_clear((InterruptManager*)mmu->interrupts, (u8)(1u << n));
+    } else {
+        mmu->memory[IF_REG] &= (u8)~(1u << n);
+    }
     
-    // 5. Définir PC à l'adresse du gestionnaire (1 M-cycle)
-    u16 handler_addr = interrupt_get_handler_address(interrupt);
-    cpu->pc = handler_addr;
+    // 3. 2 M-cycles d'attente, 4. PC empilé (2 M-cycles)
+    interrupt_push_pc(cpu, mmu);
     
-    // 6. Total : 5 M-cycles pour une interruption
+    // 5. Saut au vecteur (1 M-cycle): 5 M-cycles au total (INTERRUPT_DISPATCH_CYCLES)
+    cpu->pc = INTERRUPT_VECTOR(n);
+}
+
+// Routine de service d'interruption (exactement un bit parmi les 5 sources,
+// sinon rien n'est fait)
+void interrupt_service_routine(CPU* cpu, MMU* mmu, u8 interrupt) {
+    if (interrupt == 0 || interrupt > JOYPAD_INT || (interrupt & (interrupt - 1))) {
+        return;
+    }
+    interrupt_dispatch(cpu, mmu, (u32)__builtin_ctz(interrupt));
 }
 
 // Traitement principal des interruptions
 u8 interrupt_handle(InterruptManager* im, CPU* cpu, MMU* mmu) {
-    // Vérifier si les interruptions sont activées
-    if (!cpu->ime) {
+    // IME et IE & IF déjà combinés dans le drapeau en cache
+    if (!im->active) {
         return 0; // Aucune interruption traitée
     }
     
-    // Obtenir l'interruption de priorité la plus haute
-    u8 interrupt = interrupt_get_highest_priority(im);
-    if (interrupt == 0) {
-        return 0; // Aucune interruption active
-    }
-    
-    // Traiter l'interruption
-    interrupt_service_routine(cpu, mmu, interrupt);
-    
-    // Effacer l'interruption des interruptions en attente
-    im->pending_interrupts &= ~interrupt;
+    // Priorité la plus haute = bit le plus bas
+    u32 n = (u32)__builtin_ctz(im->active);
+    interrupt_dispatch(cpu, mmu, n);
     
-    return interrupt;
+    return (u8)(1u << n);
 }
 
 // Fonction utilitaire pour ajouter des interruptions depuis d'autres composants
@@ -148,12 +163,12 @@ void interrupt_request_from_component(InterruptManager* im, u8 interrupt) {
 
 // Fonction utilitaire pour vérifier si une interruption spécifique est active
 bool interrupt_is_active(InterruptManager* im, u8 interrupt) {
-    return (im->if_reg & interrupt) != 0;
+    return (*im->if_reg & interrupt) != 0;
 }
 
 // Fonction utilitaire pour obtenir le statut de toutes les interruptions
-void interrupt_get_status(InterruptManager* im, u8* ie, u8* if_reg, u8* pending) {
-    *ie = im->ie;
-    *if_reg = im->if_reg;
-    *pending = im->pending_interrupts;
+void interrupt_get_status(InterruptManager* im, u8* ie, u8* if_reg, u8* active) {
+    *ie = *im->ie;
+    *if_reg = *im->if_reg;
+    *active = im->active;
 }
@@ -19,16 +19,31 @@
 #define INT_SERIAL_ADDR   0x0058
 #define INT_JOYPAD_ADDR   0x0060
 
-// Structure de gestion des interruptions
+// Vecteur de la source n (bit n de IE/IF): 0x40 + 8n
+#define INTERRUPT_VECTOR(n) ((u16)(INT_VBLANK_ADDR + 8 * (n)))
+
+// Coût d'un dispatch: 2 M-cycles d'attente, 2 pour empiler PC, 1 pour sauter
+#define INTERRUPT_DISPATCH_CYCLES 20
+
+// Contrôleur d'interruptions. IE/IF ne sont stockés qu'à un seul endroit: la
+// MMU une fois attaché (interrupt_attach), sinon un stockage propre (tests).
+// Les écritures IE/IF, les requêtes et les changements d'IME (cpu_set_ime)
+// recalculent active = IE & IF & IME: la boucle principale n'a qu'un octet à
+// tester par instruction.
 typedef struct {
-    u8 ie;  // Interrupt Enable register (0xFFFF)
-    u8 if_reg;  // Interrupt Flag register (0xFF0F)
-    u8 pending_interrupts;  // Interruptions en attente
+    u8* ie;        // Interrupt Enable register (0xFFFF)
+    u8* if_reg;    // Interrupt Flag register (0xFF0F)
+    u8 ime_mask;   // 0x1F si IME, 0x00 sinon
+    u8 active;     // Interruptions servables, en cache
+    u8 local_ie;   // Stockage sans MMU
+    u8 local_if;
 } InterruptManager;
 
 // Fonctions de gestion des interruptions
 void interrupt_init(InterruptManager* im);
 void interrupt_reset(InterruptManager* im);
+void interrupt_attach(InterruptManager* im, MMU* mmu);  // IE/IF = registres de la MMU
+void interrupt_set_ime(InterruptManager* im, bool ime);
 void interrupt_write_ie(InterruptManager* im, u8 value);
 u8 interrupt_read_ie(InterruptManager* im);
 void interrupt_write_if(InterruptManager* im, u8 value);
@@ -37,11 +52,10 @@ u8 interrupt_read_if(InterruptManager* im);
 // Gestion des interruptions
 void interrupt_request(InterruptManager* im, u8 interrupt);
 void interrupt_clear(InterruptManager* im, u8 interrupt);
-u8 interrupt_get_pending(InterruptManager* im);
-bool interrupt_has_pending(InterruptManager* im);
+bool interrupt_has_pending(InterruptManager* im);  // IE & IF, IME ignoré (sortie de HALT)
 
 // Traitement des interruptions
-u8 interrupt_handle(InterruptManager* im, CPU* cpu, MMU* mmu);
+u8 interrupt_handle(InterruptManager* im, CPU* cpu, MMU* mmu);  // Source servie (0 si aucune)
 void interrupt_service_routine(CPU* cpu, MMU* mmu, u8 interrupt);
 
 // Utilitaires
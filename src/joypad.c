@@ -1,64 +1,232 @@
 #include "joypad.h"
 
+// Noms acceptés dans les fichiers d'entrées
+static const struct {
+    const char* name;
+    u8 button;
+} JOYPAD_NAMES[] = {
+    {"right", JOYPAD_RIGHT}, {"left", JOYPAD_LEFT}, {"up", JOYPAD_UP}, {"down", JOYPAD_DOWN},
+    {"a", JOYPAD_A}, {"b", JOYPAD_B}, {"select", JOYPAD_SELECT}, {"start", JOYPAD_START},
+};
+
+// Sortie P10-P13: ET des groupes sélectionnés (ligne P14/P15 à 0)
+static u8 joypad_lines(const Joypad* joypad) {
+    u8 lines = 0x0F;
+    if (!(joypad->select_line & JOYPAD_SELECT_DIRECTION)) {
+        lines &= joypad->buttons & 0x0F;
+    }
+    if (!(joypad->select_line & JOYPAD_SELECT_BUTTONS)) {
+        lines &= joypad->buttons >> 4;
+    }
+    return lines;
+}
+
+// Recalcul des lignes après un changement; front descendant = IRQ Joypad
+static void joypad_update(Joypad* joypad) {
+    u8 lines = joypad_lines(joypad);
+    if (joypad->lines & ~lines & 0x0F) {
+        joypad->interrupt_pending = true;
+    }
+    joypad->lines = lines;
+    joypad->p1 = (u8)(0xC0 | joypad->select_line | lines);
+}
+
+// Applique les événements échus (cycle <= target), dans l'ordre
+static void joypad_sync_to(Joypad* joypad, u64 target) {
+    while (joypad->event_next < joypad->event_count &&
+           joypad->events[joypad->event_next].cycle <= target) {
+        const JoypadEvent* event = &joypad->events[joypad->event_next++];
+        if (event->pressed) {
+            joypad->buttons &= (u8)~event->buttons;
+        } else {
+            joypad->buttons |= event->buttons;
+        }
+        joypad_update(joypad);
+    }
+    if (joypad->event_next == joypad->event_count) {
+        // File vide: réutiliser le tampon depuis le début
+        joypad->event_next = 0;
+        joypad->event_count = 0;
+    }
+}
+
+void joypad_sync(Joypad* joypad) {
+    joypad_sync_to(joypad, *joypad->clock);
+}
+
+static void joypad_schedule(Joypad* joypad) {
+    if (!joypad->scheduler) return;
+    if (joypad->event_next < joypad->event_count) {
+        scheduler_schedule(joypad->scheduler, joypad->input_event,
+                           joypad->events[joypad->event_next].cycle);
+    } else {
+        scheduler_cancel(joypad->scheduler, joypad->input_event);
+    }
+}
+
+// Événement: entrée appliquée au cycle exact, puis la suivante
+static void joypad_input_event(void* user, u64 when) {
+    Joypad* joypad = (Joypad*)user;
+    joypad_sync_to(joypad, when);
+    joypad_schedule(joypad);
+}
+
 // Initialisation du joypad
 void joypad_init(Joypad* joypad) {
     memset(joypad, 0, sizeof(Joypad));
+    joypad->clock = &joypad->local_cycles;
+    joypad->input_event = -1;
     joypad_reset(joypad);
 }
 
-// Reset du joypad
+// Reset du joypad (la file d'entrées est vidée)
 void joypad_reset(Joypad* joypad) {
-    joypad->p1 = 0xCF;  // Valeur par défaut
-    joypad->buttons = 0xFF;
-    joypad->buttons_btn = 0x0F;  // 1=relâché pour A,B,Select,Start
-    joypad->buttons_dir = 0x0F;  // 1=relâché pour Right,Left,Up,Down
+    joypad->buttons = 0xFF;  // 1=relâché pour les 8 touches
     joypad->select_line = 0;
+    joypad->lines = 0x0F;
+    joypad->p1 = 0xCF;       // Valeur par défaut
+    joypad->interrupt_pending = false;
+    joypad->event_count = 0;
+    joypad->event_next = 0;
+    joypad_schedule(joypad);
+}
+
+void joypad_cleanup(Joypad* joypad) {
+    free(joypad->events);
+    joypad->events = NULL;
+    joypad->event_count = 0;
+    joypad->event_capacity = 0;
+    joypad->event_next = 0;
+}
+
+void joypad_set_clock(Joypad* joypad, const u64* clock) {
+    joypad_sync(joypad);
+    joypad->clock = clock ? clock : &joypad->local_cycles;
+}
+
+// Les entrées deviennent des événements datés (nécessite l'horloge maître)
+bool joypad_set_scheduler(Joypad* joypad, Scheduler* scheduler) {
+    if (joypad->clock == &joypad->local_cycles) return false;
+
+    int id = scheduler_register(scheduler, joypad_input_event, joypad);
+    if (id < 0) return false;
+
+    joypad->scheduler = scheduler;
+    joypad->input_event = id;
+    joypad_schedule(joypad);
+    return true;
+}
+
+// Tick: avance l'horloge locale (sans horloge maître)
+void joypad_tick(Joypad* joypad, u8 cycles) {
+    if (joypad->clock != &joypad->local_cycles) return;
+    joypad->local_cycles += cycles;
+    joypad_sync(joypad);
 }
 
 // Écriture dans le registre P1
 void joypad_write(Joypad* joypad, u8 value) {
+    joypad_sync(joypad);
     // Ne conserver que les bits de sélection (P14/P15)
-    joypad->p1 = (joypad->p1 & 0x0F) | (value & 0x30);
     joypad->select_line = value & 0x30;
+    joypad_update(joypad);
 }
 
-// Lecture du registre P1
+// Lecture du registre P1 (bits 6-7 à 1)
 u8 joypad_read(Joypad* joypad) {
-    u8 result = joypad->p1 & 0x30;  // Garder les bits de sélection
-    u8 sel = joypad->select_line & 0x30;
-    
-    if (sel == 0x10) {
-        // Directions: RIGHT(0), LEFT(1), UP(2), DOWN(3)
-        // Conformément aux tests, seules RIGHT et UP sont interrogées
-        u8 dir = joypad->buttons_dir & 0x0F;
-        u8 visible = (dir & 0x05) | 0x0A; // masquer LEFT/DOWN à 1
-        result |= visible;
-    } else if (sel == 0x20) {
-        // Boutons: A(0), B(1), Select(2), Start(3)
-        // Conformément aux tests, seules A et B sont interrogées
-        u8 btn = joypad->buttons_btn & 0x0F;
-        u8 visible = (btn & 0x03) | 0x0C; // masquer Select/Start à 1
-        result |= visible;
-    } else {
-        // Aucune ligne sélectionnée
-        result |= 0x0F;
-    }
-    
-    return result;
+    joypad_sync(joypad);
+    return joypad->p1;
 }
 
-// Appui sur un bouton
+// Appui sur une ou plusieurs touches (immédiat)
 void joypad_press(Joypad* joypad, JoypadButton button) {
-    // Mettre à jour les deux groupes de manière indépendante
-    joypad->buttons_btn &= (u8)~(button & 0x0F);
-    joypad->buttons_dir &= (u8)~(button & 0x0F);
     joypad->buttons &= (u8)~button;
+    joypad_update(joypad);
 }
 
-// Relâchement d'un bouton
+// Relâchement d'une ou plusieurs touches (immédiat)
 void joypad_release(Joypad* joypad, JoypadButton button) {
-    // Relâcher dans les deux groupes
-    joypad->buttons_btn |= (button & 0x0F);
-    joypad->buttons_dir |= (button & 0x0F);
-    joypad->buttons |= button;
+    joypad->buttons |= (u8)button;
+    joypad_update(joypad);
+}
+
+// État instantané des 8 touches, 1 = enfoncée
+u8 joypad_pressed(const Joypad* joypad) {
+    return (u8)~joypad->buttons;
+}
+
+u8 joypad_get_interrupts(Joypad* joypad) {
+    if (joypad->interrupt_pending) {
+        joypad->interrupt_pending = false;
+        return 0x10;  // JOYPAD_INT
+    }
+    return 0;
+}
+
+// Ajoute un événement à la file, après ceux du même cycle
+bool joypad_queue_event(Joypad* joypad, u64 cycle, u8 buttons, bool pressed) {
+    if (joypad->event_count == joypad->event_capacity) {
+        u32 capacity = joypad->event_capacity ? joypad->event_capacity * 2 : JOYPAD_EVENTS_INITIAL;
+        JoypadEvent* events = realloc(joypad->events, capacity * sizeof(JoypadEvent));
+        if (!events) return false;
+        joypad->events = events;
+        joypad->event_capacity = capacity;
+    }
+
+    // Les scripts sont en général déjà triés: l'insertion part de la fin
+    u32 i = joypad->event_count;
+    while (i > joypad->event_next && joypad->events[i - 1].cycle > cycle) {
+        joypad->events[i] = joypad->events[i - 1];
+        i--;
+    }
+    joypad->events[i].cycle = cycle;
+    joypad->events[i].buttons = buttons;
+    joypad->events[i].pressed = pressed;
+    joypad->event_count++;
+
+    joypad_schedule(joypad);
+    return true;
+}
+
+static u8 joypad_button_by_name(const char* name) {
+    for (size_t i = 0; i < sizeof(JOYPAD_NAMES) / sizeof(JOYPAD_NAMES[0]); i++) {
+        if (strcmp(name, JOYPAD_NAMES[i].name) == 0) return JOYPAD_NAMES[i].button;
+    }
+    return 0;
+}
+
+// Chargement d'un fichier d'entrées datées
+bool joypad_load_events(Joypad* joypad, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Erreur: impossible d'ouvrir %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    u32 number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        number++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        unsigned long long cycle;
+        char name[16], action[16];
+        int fields = sscanf(line, "%llu %15s %15s", &cycle, name, action);
+        if (fields == EOF) continue;  // Ligne vide
+
+        u8 button = fields == 3 ? joypad_button_by_name(name) : 0;
+        bool down = fields == 3 && strcmp(action, "down") == 0;
+        bool up = fields == 3 && strcmp(action, "up") == 0;
+        if (!button || (!down && !up)) {
+            printf("Erreur: %s ligne %u invalide (attendu: <cycle> <touche> down|up)\n", path, number);
+            ok = false;
+        } else if (!joypad_queue_event(joypad, (u64)cycle, button, down)) {
+            ok = false;
+        }
+    }
+
+    fclose(f);
+    return ok;
 }
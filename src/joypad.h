@@ -2,40 +2,84 @@
 #define JOYPAD_H
 
 #include "common.h"
+#include "scheduler.h"
 
-// Boutons du joypad
+// Touches du joypad: un bit par touche, directions en bits 0-3 et boutons
+// en bits 4-7 (même disposition que joypad_pressed). Le quartet bas de P1
+// reprend les bits d'un groupe dans le même ordre.
 typedef enum {
     JOYPAD_RIGHT  = 0x01,
     JOYPAD_LEFT   = 0x02,
     JOYPAD_UP     = 0x04,
     JOYPAD_DOWN   = 0x08,
-    JOYPAD_A      = 0x01,
-    JOYPAD_B      = 0x02,
-    JOYPAD_SELECT = 0x04,
-    JOYPAD_START  = 0x08
+    JOYPAD_A      = 0x10,
+    JOYPAD_B      = 0x20,
+    JOYPAD_SELECT = 0x40,
+    JOYPAD_START  = 0x80
 } JoypadButton;
 
-// Lignes de sélection
+// Lignes de sélection (actives à 0 dans P1)
 typedef enum {
     JOYPAD_SELECT_DIRECTION = 0x10,  // P14
     JOYPAD_SELECT_BUTTONS   = 0x20   // P15
 } JoypadSelect;
 
-// Structure du joypad
+#define JOYPAD_EVENTS_INITIAL 64     // Capacité initiale de la file (doublée au besoin)
+
+// Événement d'entrée daté: touches enfoncées ou relâchées à un cycle exact
+typedef struct {
+    u64 cycle;
+    u8 buttons;      // Masque JoypadButton
+    bool pressed;
+} JoypadEvent;
+
+// Structure du joypad. Les lignes P10-P13 sont recalculées à chaque
+// changement (touche ou sélection); un front descendant lève l'IRQ Joypad.
+// Les entrées scriptées sont appliquées au cycle exact: rattrapage aux
+// accès à P1, et prochain événement programmé dans l'ordonnanceur.
 typedef struct {
-    u8 p1;           // Registre P1 (0xFF00)
-    u8 buttons;      // État combiné (1=relâché), utilisé par les tests
-    u8 buttons_btn;  // État boutons (A,B,Select,Start) - bits 0..3 (1=relâché)
-    u8 buttons_dir;  // État directions (Right,Left,Up,Down) - bits 0..3 (1=relâché)
+    u8 p1;           // Registre P1 (0xFF00): bits de sélection
+    u8 buttons;      // État des 8 touches (1=relâché)
     u8 select_line;  // Ligne de sélection active
+    u8 lines;        // Sortie P10-P13 courante (1=haut)
+    bool interrupt_pending;  // Interruption joypad en attente
+
+    // File d'événements triée par cycle; events[event_next..] restent à appliquer
+    JoypadEvent* events;
+    u32 event_count;
+    u32 event_capacity;
+    u32 event_next;
+
+    // Horloge rattrapée (horloge maître, ou local_cycles avancée par joypad_tick)
+    const u64* clock;
+    u64 local_cycles;
+
+    // Prochain événement programmé (optionnel)
+    Scheduler* scheduler;
+    int input_event;
 } Joypad;
 
 // Fonctions joypad
 void joypad_init(Joypad* joypad);
 void joypad_reset(Joypad* joypad);
+void joypad_cleanup(Joypad* joypad);
+void joypad_tick(Joypad* joypad, u8 cycles);  // Horloge locale uniquement
 void joypad_write(Joypad* joypad, u8 value);
 u8 joypad_read(Joypad* joypad);
 void joypad_press(Joypad* joypad, JoypadButton button);
 void joypad_release(Joypad* joypad, JoypadButton button);
+u8 joypad_pressed(const Joypad* joypad);  // Bits 0-3 directions, 4-7 boutons (1=enfoncé)
+u8 joypad_get_interrupts(Joypad* joypad);  // Récupère l'interruption joypad
+
+// Horloge maître et événement d'entrée
+void joypad_set_clock(Joypad* joypad, const u64* clock);
+bool joypad_set_scheduler(Joypad* joypad, Scheduler* scheduler);
+void joypad_sync(Joypad* joypad);
+
+// Entrées datées (rejeu, scripts): file triée, chargée depuis un fichier
+// de lignes "<cycle> <touche> down|up" (touches: right left up down a b
+// select start, # pour un commentaire)
+bool joypad_queue_event(Joypad* joypad, u64 cycle, u8 buttons, bool pressed);
+bool joypad_load_events(Joypad* joypad, const char* path);
 
 #endif // JOYPAD_H
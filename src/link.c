@@ -0,0 +1,120 @@
+#include "link.h"
+#include <assert.h>
+
+void link_init(LinkCable* link, Serial* a, Serial* b, u64 quantum) {
+    memset(link, 0, sizeof(LinkCable));
+    link->serial[0] = a;
+    link->serial[1] = b;
+    // Première frontière: l'horloge commune des deux instances
+    assert(*a->clock == *b->clock);
+    link->now = *a->clock;
+    // Au plus un transfert par quantum et par extrémité
+    if (quantum == 0 || quantum > SERIAL_TRANSFER_CYCLES) {
+        quantum = LINK_QUANTUM_CYCLES;
+    }
+    link->quantum = quantum;
+    serial_connect(a, true);
+    serial_connect(b, true);
+    link_exchange(link);
+}
+
+void link_disconnect(LinkCable* link) {
+    serial_connect(link->serial[0], false);
+    serial_connect(link->serial[1], false);
+}
+
+void link_exchange(LinkCable* link) {
+    Serial* a = link->serial[0];
+    Serial* b = link->serial[1];
+    u8 value;
+
+    if (serial_take_sent(a, &value)) {
+        serial_receive(b, value);
+        link->exchanges++;
+    }
+    if (serial_take_sent(b, &value)) {
+        serial_receive(a, value);
+        link->exchanges++;
+    }
+
+    // État vu par chaque maître pendant le quantum suivant
+    serial_set_peer(a, serial_waiting(b), b->sb);
+    serial_set_peer(b, serial_waiting(a), a->sb);
+}
+
+// Prochaine frontière (bornée par la fin demandée)
+static u64 link_next_boundary(const LinkCable* link) {
+    u64 until = link->now + link->quantum;
+    return until < link->end ? until : link->end;
+}
+
+// Les deux instances sont arrêtées à until
+static void link_boundary(LinkCable* link, u64 until) {
+    link_exchange(link);
+    link->now = until;
+    link->quanta++;
+    link->stop = !link->running[0] || !link->running[1] || link->now >= link->end;
+}
+
+// Boucle d'une instance en mode threadé; la dernière arrivée à la barrière
+// traite la frontière pendant que l'autre attend
+static void link_loop(LinkCable* link, int index) {
+    u32 sense = 0;
+
+    for (;;) {
+        u64 until = link_next_boundary(link);
+        link->running[index] = link->run(link->user[index], until);
+
+        sense ^= 1;
+        if (__atomic_sub_fetch(&link->waiting, 1, __ATOMIC_ACQ_REL) == 0) {
+            link_boundary(link, until);
+            __atomic_store_n(&link->waiting, 2, __ATOMIC_RELAXED);
+            __atomic_store_n(&link->sense, sense, __ATOMIC_RELEASE);
+        } else {
+            u32 spins = 0;
+            while (__atomic_load_n(&link->sense, __ATOMIC_ACQUIRE) != sense) {
+                if (++spins >= LINK_SPIN_LIMIT) {
+                    thread_yield();
+                    spins = 0;
+                }
+            }
+        }
+
+        if (link->stop) break;
+    }
+}
+
+static void link_thread_main(void* arg) {
+    link_loop((LinkCable*)arg, 1);
+}
+
+u64 link_run(LinkCable* link, LinkRunFunc run, void* a, void* b, u64 cycles, bool threaded) {
+    link->run = run;
+    link->user[0] = a;
+    link->user[1] = b;
+    link->running[0] = link->running[1] = true;
+    link->end = cycles > ~(u64)0 - link->now ? ~(u64)0 : link->now + cycles;
+    link->stop = link->now >= link->end;
+    if (link->stop) return link->now;
+
+    if (threaded) {
+        // La première instance reste sur le thread appelant (fenêtre, audio)
+        link->waiting = 2;
+        link->sense = 0;
+        if (thread_start(&link->thread, link_thread_main, link)) {
+            link_loop(link, 0);
+            thread_join(&link->thread);
+            return link->now;
+        }
+        printf("Câble: thread indisponible, exécution alternée\n");
+    }
+
+    // Exécution alternée sur le thread appelant (même résultat)
+    while (!link->stop) {
+        u64 until = link_next_boundary(link);
+        link->running[0] = run(a, until);
+        link->running[1] = run(b, until);
+        link_boundary(link, until);
+    }
+    return link->now;
+}
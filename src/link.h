@@ -0,0 +1,54 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include "common.h"
+#include "serial.h"
+#include "thread.h"
+
+// Câble link entre deux instances du même processus.
+// Les instances avancent par quanta de cycles bornés et ne partagent rien
+// pendant un quantum: les octets sont échangés à la frontière, les deux
+// instances arrêtées (link_exchange). Le résultat ne dépend donc pas de
+// l'ordre d'exécution: en mode threadé, la seconde instance tourne sur son
+// propre thread et chaque frontière est une barrière sans verrou (compteur
+// atomique, sens alterné, attente active).
+#define LINK_QUANTUM_CYCLES 1024   // 2 bits série: latence bornée côté esclave
+#define LINK_SPIN_LIMIT 4096       // Tours d'attente active avant de céder le CPU
+
+// Avance une instance jusqu'à until (son horloge maître); false si elle s'arrête
+typedef bool (*LinkRunFunc)(void* user, u64 until);
+
+typedef struct {
+    Serial* serial[2];
+    u64 quantum;
+    u64 now;                  // Dernière frontière franchie
+    u64 end;
+
+    // Exécution (link_run)
+    LinkRunFunc run;
+    void* user[2];
+    bool running[2];          // Écrit par chaque instance avant la barrière
+    bool stop;                // Écrit à la frontière seulement
+
+    // Barrière du mode threadé
+    Thread thread;            // Seconde instance
+    u32 waiting;              // Atomique: instances pas encore arrivées
+    u32 sense;                // Atomique: basculé par la dernière arrivée
+
+    // Statistiques
+    u32 quanta;
+    u32 exchanges;            // Octets livrés aux esclaves
+} LinkCable;
+
+// Les deux instances doivent être au même cycle (horloges des ports série)
+void link_init(LinkCable* link, Serial* a, Serial* b, u64 quantum);
+void link_disconnect(LinkCable* link);
+
+// Frontière de quantum: livre les octets émis et relève l'état des partenaires
+void link_exchange(LinkCable* link);
+
+// Fait avancer les deux instances de cycles (ou jusqu'à l'arrêt de l'une);
+// renvoie la dernière frontière atteinte
+u64 link_run(LinkCable* link, LinkRunFunc run, void* a, void* b, u64 cycles, bool threaded);
+
+#endif // LINK_H
@@ -1,6 +1,10 @@
 #include "mmu.h"
 #include "timer.h"
 #include "apu.h"
+#include "ppu.h"
+#include "interrupt.h"
+#include "serial.h"
+#include "joypad.h"
 
 // Initialisation de la MMU
 void mmu_init(MMU* mmu) {
@@ -49,6 +53,7 @@ void mmu_cleanup(MMU* mmu) {
 void mmu_reset(MMU* mmu) {
     // Ré-initialiser toute la RAM à 0xFF (zones non écrites lues à 0xFF)
     memset(mmu->memory, 0xFF, 0x10000);
+    mmu->vram_writes++;
 
     // Initialiser les valeurs par défaut des registres IO
     mmu->memory[0xFF00] = 0xCF;  // P1
@@ -73,6 +78,9 @@ void mmu_reset(MMU* mmu) {
     mmu->memory[0xFF4B] = 0x00;  // WX
     mmu->memory[0xFF50] = 0x01;  // BOOT ROM disable
     mmu->memory[0xFFFF] = 0x00;  // IE
+    if (mmu->interrupts) {
+        interrupt_write_if((InterruptManager*)mmu->interrupts, mmu->memory[IF_REG]);
+    }
 }
 
 // Chargement d'une ROM
@@ -177,6 +185,14 @@ u8 mmu_read8(MMU* mmu, u16 address) {
         return mmu->oam[address - 0xFE00];
     } else if (address >= 0xFF00 && address <= 0xFF7F) {
         // IO
+        // Connecter P1 au joypad
+        if (address == P1_REG && mmu->joypad) {
+            return joypad_read((Joypad*)mmu->joypad);
+        }
+        // Connecter les registres série au port série
+        if ((address == SB_REG || address == SC_REG) && mmu->serial) {
+            return serial_read((Serial*)mmu->serial, address);
+        }
         // Connecter les registres timer au timer
         if (address >= 0xFF04 && address <= 0xFF07) {
             return timer_read((Timer*)mmu->timer, address);
@@ -185,6 +201,10 @@ u8 mmu_read8(MMU* mmu, u16 address) {
         if (address >= 0xFF10 && address <= 0xFF3F) {
             return apu_read((APU*)mmu->apu, address);
         }
+        // Connecter les registres LCD au PPU (0xFF46 = DMA reste en IO)
+        if (address >= LCDC_REG && address <= WX_REG && address != DMA_REG) {
+            return ppu_read((PPU*)mmu->ppu, address);
+        }
         // Autres registres IO
         return mmu->io[address - 0xFF00];
     } else if (address >= 0xFF80 && address <= 0xFFFE) {
@@ -213,6 +233,7 @@ void mmu_write8(MMU* mmu, u16 address, u8 value) {
     } else if (address >= 0x8000 && address <= 0x9FFF) {
         // VRAM
         mmu->vram[address - 0x8000] = value;
+        mmu->vram_writes++;
     } else if (address >= 0xA000 && address <= 0xBFFF) {
         // ERAM via MBC
         mbc_write(mmu, address, value);
@@ -237,22 +258,21 @@ void mmu_write8(MMU* mmu, u16 address, u8 value) {
             apu_write((APU*)mmu->apu, address, value);
             return; // Ne pas écrire dans mmu->io
         }
+        // Connecter les registres LCD au PPU (LY en lecture seule, ignoré par ppu_write)
+        if (address >= LCDC_REG && address <= WX_REG && address != DMA_REG) {
+            ppu_write((PPU*)mmu->ppu, address, value);
+            return; // Ne pas écrire dans mmu->io
+        }
         
-        // Support du port série pour les tests
-        if (address == 0xFF01) {  // SB - Serial Data
-            mmu->io[address - 0xFF00] = value;
-        } else if (address == 0xFF02) {  // SC - Serial Control
-            mmu->io[address - 0xFF00] = value;
-            // Si bit 7 est activé, transmettre le caractère
-            if (value & 0x80) {
-                u8 data = mmu->io[0xFF01 - 0xFF00];
-                printf("SERIAL: 0x%02X ('%c')\n", data, (data >= 32 && data <= 126) ? data : '.');
-                // Écrire aussi le caractère brut pour un parsing simple par les tests ROM
-                putchar((int)data);
-                fflush(stdout);
-                // Remettre le bit 7 à 0 après transmission
-                mmu->io[address - 0xFF00] = 0x00;
-            }
+        // P1: sélection des lignes du joypad (peut lever l'IRQ Joypad)
+        if (address == P1_REG && mmu->joypad) {
+            joypad_write((Joypad*)mmu->joypad, value);
+        } else if ((address == SB_REG || address == SC_REG) && mmu->serial) {
+            // Port série: transfert daté, sortie tamponnée (pas d'E/S par octet)
+            serial_write((Serial*)mmu->serial, address, value);
+        } else if (address == IF_REG && mmu->interrupts) {
+            // IF: le contrôleur met à jour son drapeau en cache
+            interrupt_write_if((InterruptManager*)mmu->interrupts, value);
         } else {
             // Autres registres IO
             mmu->io[address - 0xFF00] = value;
@@ -262,7 +282,11 @@ void mmu_write8(MMU* mmu, u16 address, u8 value) {
         mmu->hram[address - 0xFF80] = value;
     } else if (address == 0xFFFF) {
         // IE
-        mmu->memory[0xFFFF] = value;
+        if (mmu->interrupts) {
+            interrupt_write_ie((InterruptManager*)mmu->interrupts, value);
+        } else {
+            mmu->memory[0xFFFF] = value;
+        }
     }
 }
 
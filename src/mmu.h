@@ -81,6 +81,13 @@ typedef struct {
     bool boot_rom_enabled;
     void* timer;  // Pointeur vers le timer (void* pour éviter la dépendance circulaire)
     void* apu;    // Pointeur vers l'APU (void* pour éviter la dépendance circulaire)
+    void* ppu;    // Pointeur vers le PPU (registres LCD 0xFF40-0xFF4B hors DMA)
+    void* interrupts;  // Contrôleur d'interruptions (IE/IF restent stockés ici)
+    void* serial;      // Port série (SB/SC), stockage brut si absent
+    void* joypad;      // Joypad (P1), stockage brut si absent
+    
+    // Compteur d'écritures (copie sur modification pour le thread de rendu)
+    u32 vram_writes;
 } MMU;
 
 // Fonctions MMU
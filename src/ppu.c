@@ -3,9 +3,46 @@
 // Initialisation du PPU
 void ppu_init(PPU* ppu) {
     memset(ppu, 0, sizeof(PPU));
+    ppu->render_policy = PPU_RENDER_ALWAYS;
+    ppu->render_interval = 1;
     ppu_reset(ppu);
 }
 
+// Décide en début de frame si ses lignes seront rendues
+static void ppu_begin_frame(PPU* ppu) {
+    switch (ppu->render_policy) {
+        case PPU_RENDER_EVERY_N:
+            ppu->render_frame = (ppu->frame_count % ppu->render_interval) == 0;
+            break;
+        case PPU_RENDER_ON_DEMAND:
+            ppu->render_frame = ppu->render_requested;
+            ppu->render_requested = false;
+            break;
+        case PPU_RENDER_NEVER:
+            ppu->render_frame = false;
+            break;
+        default:
+            ppu->render_frame = true;
+            break;
+    }
+}
+
+// Changement de politique de rendu (appliqué dès la frame suivante)
+void ppu_set_render_policy(PPU* ppu, PPURenderPolicy policy, u32 interval) {
+    ppu->render_policy = policy;
+    ppu->render_interval = interval > 0 ? interval : 1;
+}
+
+// Demande de rendu de la prochaine frame complète
+void ppu_request_frame(PPU* ppu) {
+    if (ppu->ly == 0 && ppu->mode == PPU_MODE_OAM_SEARCH) {
+        // Aucune ligne de la frame courante n'est encore dessinée
+        ppu->render_frame = true;
+    } else {
+        ppu->render_requested = true;
+    }
+}
+
 // Reset du PPU (DMG, LCD activé, valeurs conformes Pan Docs/minimales tests)
 void ppu_reset(PPU* ppu) {
     ppu->lcdc = 0x91;   // LCD ON, BG ON, tiles 8000h, BG map 9800h
@@ -23,19 +60,33 @@ void ppu_reset(PPU* ppu) {
     ppu->mode = PPU_MODE_OAM_SEARCH;
     ppu->mode_cycles = 0;
     ppu->line_cycles = 0;
+    ppu->stat_line = false;
+    ppu->pending_interrupts = 0;
+    ppu->frame_count = 0;
+    ppu->frame_ready = false;
+    ppu->render_requested = false;
+    ppu_begin_frame(ppu);
 
-    // Framebuffer blanc
-    for (int i = 0; i < GB_WIDTH * GB_HEIGHT; i++) {
-        ppu->framebuffer[i] = 0xFFFFFFFF;
-    }
+    // Framebuffer blanc (teinte 0)
+    memset(ppu->framebuffer, 0, sizeof(ppu->framebuffer));
 
     ppu_update_palettes(ppu);
 }
 
-// Tick PPU - retourne un masque d'interruptions déclenchées (bit0 = VBLANK)
+// Tick PPU - retourne un masque d'interruptions déclenchées (bit0 = VBLANK, bit1 = STAT)
 u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
     u8 interrupts = 0;
 
+    // LCD éteint: PPU figé (LY=0, mode 0), seules les IRQ issues des écritures remontent
+    if (!(ppu->lcdc & 0x80)) {
+        interrupts = ppu->pending_interrupts;
+        ppu->pending_interrupts = 0;
+        return interrupts;
+    }
+
+    PPUMode old_mode = ppu->mode;
+    u8 old_ly = ppu->ly;
+
     // Avancer la ligne en dots (4.19MHz) au granulaire "cycles" passé
     ppu->line_cycles += cycles;
 
@@ -46,7 +97,7 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
         if (ppu->mode_cycles >= 172) {
             ppu->mode = PPU_MODE_HBLANK;
             ppu->mode_cycles = 0;
-            ppu_render_line(ppu, vram);
+            if (ppu->render_frame) ppu_render_line(ppu, vram);
         }
     } else if (ppu->ly < 144) {
         // Avancer selon le mode courant pour respecter les tests qui forcent le mode
@@ -56,6 +107,11 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
                 if (ppu->mode_cycles >= 80) {
                     ppu->mode = PPU_MODE_PIXEL_TRANSFER;
                     ppu->mode_cycles = 0;
+                    if (ppu->observer.line) {
+                        PPULineRegs regs;
+                        ppu_capture_line_regs(ppu, &regs);
+                        ppu->observer.line(ppu->observer.user, ppu->ly, &regs);
+                    }
                 }
                 break;
             case PPU_MODE_PIXEL_TRANSFER:
@@ -63,7 +119,7 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
                 if (ppu->mode_cycles >= 172) {
                     ppu->mode = PPU_MODE_HBLANK;
                     ppu->mode_cycles = 0;
-                    ppu_render_line(ppu, vram);
+                    if (ppu->render_frame) ppu_render_line(ppu, vram);
                 }
                 break;
             case PPU_MODE_HBLANK: {
@@ -76,6 +132,11 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
                     ppu->line_cycles = 0; // Reset line_cycles pour la nouvelle ligne
                     if (ppu->ly == 144) {
                         ppu->mode = PPU_MODE_VBLANK;
+                        ppu->frame_count++;
+                        if (ppu->render_frame) ppu->frame_ready = true;
+                        if (ppu->observer.frame) {
+                            ppu->observer.frame(ppu->observer.user, ppu->frame_count - 1);
+                        }
                         interrupts |= 0x01;
                     } else {
                         ppu->mode = PPU_MODE_OAM_SEARCH;
@@ -100,31 +161,86 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram) {
                 ppu->ly = 0;
                 ppu->line_cycles = 0; // Reset seulement au début de frame
                 ppu->mode = PPU_MODE_OAM_SEARCH;
+                ppu_begin_frame(ppu);
             }
         } else {
             ppu->mode_cycles = ppu->line_cycles;
         }
     }
 
-    // STAT (bits 0-1 = mode, bit 2 = LYC==LY)
+    // Les sources STAT ne changent qu'aux transitions de mode ou de LY:
+    // entre deux transitions, aucun travail STAT n'est fait.
+    if (ppu->mode != old_mode || ppu->ly != old_ly) {
+        ppu_update_stat(ppu);
+    }
+
+    interrupts |= ppu->pending_interrupts;
+    ppu->pending_interrupts = 0;
+    return interrupts;
+}
+
+// Évalue la ligne STAT (OU des sources activées) et lève LCD_STAT sur front montant
+static void ppu_check_stat_line(PPU* ppu) {
+    bool line = false;
+    if (ppu->lcdc & 0x80) {
+        switch (ppu->mode) {
+            case PPU_MODE_HBLANK:     line = (ppu->stat & 0x08) != 0; break;
+            case PPU_MODE_VBLANK:     line = (ppu->stat & 0x10) != 0; break;
+            case PPU_MODE_OAM_SEARCH: line = (ppu->stat & 0x20) != 0; break;
+            default: break;  // Mode 3: pas de source STAT
+        }
+        if ((ppu->stat & 0x40) && ppu->ly == ppu->lyc) {
+            line = true;
+        }
+    }
+
+    if (line && !ppu->stat_line) {
+        ppu->pending_interrupts |= LCD_STAT_INT;
+    }
+    ppu->stat_line = line;
+}
+
+// Mise à jour STAT (bits 0-1 = mode, bit 2 = LYC==LY) puis de la ligne d'interruption
+void ppu_update_stat(PPU* ppu) {
     ppu->stat = (ppu->stat & 0xF8) | (ppu->mode & 0x03);
     if (ppu->ly == ppu->lyc) {
         ppu->stat |= 0x04;
-    } else {
-        ppu->stat &= (u8)~0x04;
     }
-
-    return interrupts;
+    ppu_check_stat_line(ppu);
 }
 
 // Écriture registres PPU
 void ppu_write(PPU* ppu, u16 address, u8 value) {
     switch (address) {
-        case LCDC_REG: ppu->lcdc = value; break;
-        case STAT_REG: ppu->stat = (ppu->stat & 0x07) | (value & 0xF8); break;
+        case LCDC_REG: {
+            bool was_on = (ppu->lcdc & 0x80) != 0;
+            ppu->lcdc = value;
+            if (was_on && !(value & 0x80)) {
+                // Extinction: LY=0, mode 0, la ligne STAT retombe
+                ppu->ly = 0;
+                ppu->mode = PPU_MODE_HBLANK;
+                ppu->mode_cycles = 0;
+                ppu->line_cycles = 0;
+                ppu_update_stat(ppu);
+            } else if (!was_on && (value & 0x80)) {
+                // Rallumage: reprise en début de frame
+                ppu->ly = 0;
+                ppu->mode = PPU_MODE_OAM_SEARCH;
+                ppu->mode_cycles = 0;
+                ppu->line_cycles = 0;
+                ppu_begin_frame(ppu);
+                ppu_update_stat(ppu);
+            }
+            break;
+        }
+        case STAT_REG:
+            // Bits 0-2 en lecture seule; activer une source déjà vraie crée un front
+            ppu->stat = (ppu->stat & 0x07) | (value & 0xF8);
+            ppu_check_stat_line(ppu);
+            break;
         case SCY_REG:  ppu->scy  = value; break;
         case SCX_REG:  ppu->scx  = value; break;
-        case LYC_REG:  ppu->lyc  = value; break;
+        case LYC_REG:  ppu->lyc  = value; ppu_update_stat(ppu); break;
         case BGP_REG:  ppu->bgp  = value; ppu_update_palettes(ppu); break;
         case OBP0_REG: ppu->obp0 = value; ppu_update_palettes(ppu); break;
         case OBP1_REG: ppu->obp1 = value; ppu_update_palettes(ppu); break;
@@ -163,23 +279,68 @@ void ppu_update_palettes(PPU* ppu) {
     }
 }
 
-// Rendu d'une ligne: BG uniquement (DMG minimal)
+// Rendu de la ligne courante (LY): BG uniquement (DMG minimal)
 void ppu_render_line(PPU* ppu, u8* vram) {
     if (!(ppu->lcdc & 0x80)) return; // LCD off
-    if (!(ppu->lcdc & 0x01)) {
+    ppu_render_background(ppu, vram, ppu->ly);
+}
+
+// Rendu complet d'une frame depuis l'état courant des registres, sans toucher LY
+void ppu_render_frame(PPU* ppu, u8* vram) {
+    if (!(ppu->lcdc & 0x80)) return; // LCD off
+    for (u8 line = 0; line < GB_HEIGHT; line++) {
+        ppu_render_background(ppu, vram, line);
+    }
+}
+
+// Observateur des lignes (pipeline de rendu externe); NULL pour le retirer
+void ppu_set_observer(PPU* ppu, const PPUObserver* observer) {
+    if (observer) {
+        ppu->observer = *observer;
+    } else {
+        memset(&ppu->observer, 0, sizeof(PPUObserver));
+    }
+}
+
+// Consomme le signal "frame prête" levé à l'entrée en VBlank
+bool ppu_frame_ready(PPU* ppu) {
+    bool ready = ppu->frame_ready;
+    ppu->frame_ready = false;
+    return ready;
+}
+
+// Rendu du fond pour une ligne donnée
+void ppu_render_background(PPU* ppu, u8* vram, u8 line) {
+    PPULineRegs regs;
+    ppu_capture_line_regs(ppu, &regs);
+    ppu_rasterize_line(&regs, vram, line, &ppu->framebuffer[line * GB_WIDTH]);
+}
+
+// Registres qui déterminent les pixels d'une ligne
+void ppu_capture_line_regs(const PPU* ppu, PPULineRegs* regs) {
+    regs->lcdc = ppu->lcdc;
+    regs->scy = ppu->scy;
+    regs->scx = ppu->scx;
+    regs->wy = ppu->wy;
+    regs->wx = ppu->wx;
+    regs->bgp = ppu->bgp;
+}
+
+// Rastérisation d'une ligne sans état PPU (utilisable depuis un autre thread)
+void ppu_rasterize_line(const PPULineRegs* regs, const u8* vram, u8 line, u8* row) {
+    if (!(regs->lcdc & 0x01)) {
         // BG off => blanc
-        for (int x = 0; x < GB_WIDTH; x++) {
-            ppu->framebuffer[ppu->ly * GB_WIDTH + x] = 0xFFFFFFFF;
-        }
+        memset(row, 0, GB_WIDTH);
         return;
     }
 
-    u8 tile_y  = (ppu->ly + ppu->scy) >> 3;
-    u8 pixel_y = (ppu->ly + ppu->scy) & 7;
-    u16 tile_map = (ppu->lcdc & 0x08) ? 0x9C00 : 0x9800;
+    u8 y = (u8)(line + regs->scy);
+    u8 tile_y  = y >> 3;
+    u8 pixel_y = y & 7;
+    u16 tile_map = (regs->lcdc & 0x08) ? 0x9C00 : 0x9800;
 
     for (int x = 0; x < GB_WIDTH; x++) {
-        u16 sx = (x + ppu->scx) & 0xFF;
+        u16 sx = (x + regs->scx) & 0xFF;
         u8 tile_x  = sx >> 3;
         u8 pixel_x = sx & 7;
 
@@ -187,7 +348,7 @@ void ppu_render_line(PPU* ppu, u8* vram) {
         u8 tile_index = vram[map_addr - 0x8000];
 
         u16 data_addr;
-        if (ppu->lcdc & 0x10) {
+        if (regs->lcdc & 0x10) {
             data_addr = 0x8000 + (u16)tile_index * 16;
         } else {
             s8 st = (s8)tile_index;
@@ -203,8 +364,8 @@ void ppu_render_line(PPU* ppu, u8* vram) {
         if (b1 & mask) pix |= 0x01;
         if (b2 & mask) pix |= 0x02;
 
-        u32 color = ppu_get_pixel_color(ppu, pix);
-        ppu->framebuffer[ppu->ly * GB_WIDTH + x] = color;
+        // La conversion en couleur est différée à la présentation
+        row[x] = (regs->bgp >> (pix * 2)) & 0x03;
     }
 }
 
@@ -220,7 +381,6 @@ u32 ppu_get_pixel_color(PPU* ppu, u8 pixel) {
 }
 
 // Placeholders (API annoncée dans ppu.h)
-void ppu_render_background(PPU* ppu, u8* vram, u8 line) { (void)ppu; (void)vram; (void)line; }
 void ppu_render_window(PPU* ppu, u8* vram, u8 line)    { (void)ppu; (void)vram; (void)line; }
 void ppu_render_sprites(PPU* ppu, u8* vram, u8 line)   { (void)ppu; (void)vram; (void)line; }
 
@@ -11,6 +11,32 @@ typedef enum {
     PPU_MODE_PIXEL_TRANSFER = 3
 } PPUMode;
 
+// Politique de rendu: le timing (modes, LY, IRQ) tourne toujours,
+// seule la génération de pixels peut être sautée
+typedef enum {
+    PPU_RENDER_ALWAYS = 0,   // Chaque frame
+    PPU_RENDER_EVERY_N,      // Une frame sur render_interval
+    PPU_RENDER_ON_DEMAND,    // Seulement les frames demandées via ppu_request_frame
+    PPU_RENDER_NEVER         // Jamais (jobs headless sans lecture du framebuffer)
+} PPURenderPolicy;
+
+// Registres figés pour une ligne (fin du mode 2), rastérisables hors du PPU
+typedef struct {
+    u8 lcdc;
+    u8 scy;
+    u8 scx;
+    u8 wy;
+    u8 wx;
+    u8 bgp;
+} PPULineRegs;
+
+// Observateur du timing (ex. thread de rendu): appelé depuis ppu_tick
+typedef struct {
+    void (*line)(void* user, u8 line, const PPULineRegs* regs);  // Fin du mode 2, lignes 0-143
+    void (*frame)(void* user, u32 frame);                          // Entrée en VBlank
+    void* user;
+} PPUObserver;
+
 // Structure du PPU
 typedef struct {
     // Registres
@@ -31,8 +57,21 @@ typedef struct {
     u32 mode_cycles;
     u32 line_cycles;
     
-    // Framebuffer
-    u32 framebuffer[GB_WIDTH * GB_HEIGHT];
+    // Ligne d'interruption STAT (OU des sources actives, front montant => IRQ)
+    bool stat_line;
+    u8 pending_interrupts;  // IRQ levées hors ppu_tick (écritures registres)
+    
+    // Politique de rendu
+    PPURenderPolicy render_policy;
+    u32 render_interval;    // N pour PPU_RENDER_EVERY_N
+    u32 frame_count;        // Frames complétées (entrées en VBlank)
+    bool render_requested;  // Demande en attente pour PPU_RENDER_ON_DEMAND
+    bool render_frame;      // La frame en cours génère ses pixels
+    bool frame_ready;       // Frame rendue complète (levé à l'entrée en VBlank)
+    PPUObserver observer;   // Rendu externe (inactif si les callbacks sont NULL)
+    
+    // Framebuffer indexé (teintes 0-3 après BGP, voir framebuffer.h)
+    u8 framebuffer[GB_WIDTH * GB_HEIGHT];
     
     // OAM (Object Attribute Memory)
     u8 oam[160];  // 40 sprites * 4 bytes
@@ -50,14 +89,24 @@ u8 ppu_tick(PPU* ppu, u8 cycles, u8* vram);  // Retourne les interruptions décl
 void ppu_write(PPU* ppu, u16 address, u8 value);
 u8 ppu_read(PPU* ppu, u16 address);
 
+// Politique de rendu
+void ppu_set_render_policy(PPU* ppu, PPURenderPolicy policy, u32 interval);
+void ppu_request_frame(PPU* ppu);  // Rendre la prochaine frame (PPU_RENDER_ON_DEMAND)
+void ppu_set_observer(PPU* ppu, const PPUObserver* observer);
+
 // Rendu
+bool ppu_frame_ready(PPU* ppu);  // Consomme le signal "frame prête" (une présentation par frame)
 void ppu_render_line(PPU* ppu, u8* vram);
+void ppu_render_frame(PPU* ppu, u8* vram);  // Rendu complet sans modifier LY
 void ppu_render_background(PPU* ppu, u8* vram, u8 line);
+void ppu_capture_line_regs(const PPU* ppu, PPULineRegs* regs);
+void ppu_rasterize_line(const PPULineRegs* regs, const u8* vram, u8 line, u8* row);
 void ppu_render_window(PPU* ppu, u8* vram, u8 line);
 void ppu_render_sprites(PPU* ppu, u8* vram, u8 line);
 
 // Utilitaires
 void ppu_update_palettes(PPU* ppu);
+void ppu_update_stat(PPU* ppu);
 u32 ppu_get_pixel_color(PPU* ppu, u8 pixel);
 
 #endif // PPU_H
@@ -0,0 +1,174 @@
+#include "render_thread.h"
+
+#define RENDER_OUTPUT_FRESH 0x4
+
+// Rastérise tous les jobs publiés, dans l'ordre
+static void render_thread_main(void* arg) {
+    RenderThread* rt = (RenderThread*)arg;
+
+    for (;;) {
+        u32 consumed = __atomic_load_n(&rt->consumed, __ATOMIC_RELAXED);
+
+        mutex_lock(&rt->lock);
+        while (consumed == __atomic_load_n(&rt->submitted, __ATOMIC_ACQUIRE) &&
+               !__atomic_load_n(&rt->stop, __ATOMIC_ACQUIRE)) {
+            cond_wait(&rt->wake, &rt->lock);
+        }
+        bool done = consumed == __atomic_load_n(&rt->submitted, __ATOMIC_ACQUIRE);
+        mutex_unlock(&rt->lock);
+        if (done) break;  // Arrêt demandé et plus rien à rendre
+
+        const RenderJob* job = &rt->jobs[consumed % RENDER_JOBS];
+        u8* out = rt->output[rt->back];
+        for (int line = 0; line < GB_HEIGHT; line++) {
+            u8* row = &out[line * GB_WIDTH];
+            if (job->line_valid[line]) {
+                ppu_rasterize_line(&job->regs[line], job->vram_copies[job->line_vram[line]], (u8)line, row);
+            } else {
+                memset(row, 0, GB_WIDTH);
+            }
+        }
+        rt->output_frame[rt->back] = job->frame;
+        rt->frames_rendered++;
+
+        if (rt->on_frame) {
+            rt->on_frame(rt->user, job->frame, out);
+        }
+
+        // Publier la sortie puis libérer le job
+        rt->back = __atomic_exchange_n(&rt->middle, rt->back | RENDER_OUTPUT_FRESH, __ATOMIC_ACQ_REL) & 3;
+        __atomic_store_n(&rt->consumed, consumed + 1, __ATOMIC_RELEASE);
+    }
+}
+
+bool render_thread_start(RenderThread* rt, const u8* vram, const u32* vram_writes,
+                         RenderFrameCallback on_frame, void* user) {
+    memset(rt, 0, sizeof(RenderThread));
+    rt->vram = vram;
+    rt->vram_writes = vram_writes;
+    rt->on_frame = on_frame;
+    rt->user = user;
+    rt->back = 0;
+    rt->middle = 1;
+    rt->front = 2;
+
+    mutex_init(&rt->lock);
+    cond_init(&rt->wake);
+    rt->running = thread_start(&rt->thread, render_thread_main, rt);
+    if (!rt->running) {
+        printf("Erreur: impossible de démarrer le thread de rendu\n");
+        cond_destroy(&rt->wake);
+        mutex_destroy(&rt->lock);
+        return false;
+    }
+    return true;
+}
+
+void render_thread_stop(RenderThread* rt) {
+    if (!rt->running) return;
+
+    mutex_lock(&rt->lock);
+    __atomic_store_n(&rt->stop, true, __ATOMIC_RELEASE);
+    cond_signal(&rt->wake);
+    mutex_unlock(&rt->lock);
+    thread_join(&rt->thread);
+    rt->running = false;
+
+    cond_destroy(&rt->wake);
+    mutex_destroy(&rt->lock);
+    for (int j = 0; j < RENDER_JOBS; j++) {
+        for (int i = 0; i < GB_HEIGHT; i++) {
+            free(rt->jobs[j].vram_copies[i]);
+            rt->jobs[j].vram_copies[i] = NULL;
+        }
+    }
+
+    printf("Thread de rendu: %u frames, %u attentes, %u copies VRAM\n",
+           rt->frames_rendered, rt->producer_waits, rt->vram_copies_made);
+}
+
+void render_thread_attach(RenderThread* rt, PPU* ppu) {
+    PPUObserver observer = { render_thread_line, render_thread_frame, rt };
+    ppu_set_observer(ppu, &observer);
+}
+
+// Prend le prochain job libre (attend si le rendu a RENDER_JOBS frames de retard)
+static RenderJob* render_thread_begin_job(RenderThread* rt) {
+    u32 submitted = __atomic_load_n(&rt->submitted, __ATOMIC_RELAXED);
+    if (submitted - __atomic_load_n(&rt->consumed, __ATOMIC_ACQUIRE) >= RENDER_JOBS) {
+        rt->producer_waits++;
+        while (submitted - __atomic_load_n(&rt->consumed, __ATOMIC_ACQUIRE) >= RENDER_JOBS) {
+            thread_yield();
+        }
+    }
+
+    RenderJob* job = &rt->jobs[submitted % RENDER_JOBS];
+    memset(job->line_valid, 0, sizeof(job->line_valid));
+    job->vram_count = 0;
+    return job;
+}
+
+// Copie de VRAM pour la ligne: réutilise la précédente si rien n'a été écrit.
+// La première copie d'un job est conservée d'un usage à l'autre: une VRAM
+// stable d'une frame à l'autre ne coûte aucune copie.
+static u8 render_thread_vram_copy(RenderThread* rt, RenderJob* job) {
+    u32 version = *rt->vram_writes;
+    if (job->vram_count > 0 && job->vram_version[job->vram_count - 1] == version) {
+        return (u8)(job->vram_count - 1);
+    }
+
+    u32 index = job->vram_count;
+    if (!job->vram_copies[index]) {
+        job->vram_copies[index] = malloc(0x2000);
+        if (!job->vram_copies[index]) {
+            printf("Erreur: mémoire insuffisante pour la copie VRAM\n");
+            exit(1);
+        }
+    } else if (index == 0 && job->vram_version[0] == version) {
+        job->vram_count = 1;
+        return 0;
+    }
+
+    memcpy(job->vram_copies[index], rt->vram, 0x2000);
+    job->vram_version[index] = version;
+    job->vram_count++;
+    rt->vram_copies_made++;
+    return (u8)index;
+}
+
+void render_thread_line(void* user, u8 line, const PPULineRegs* regs) {
+    RenderThread* rt = (RenderThread*)user;
+    if (line >= GB_HEIGHT) return;
+    if (!rt->filling) {
+        rt->filling = render_thread_begin_job(rt);
+    }
+
+    RenderJob* job = rt->filling;
+    job->regs[line] = *regs;
+    job->line_vram[line] = render_thread_vram_copy(rt, job);
+    job->line_valid[line] = true;
+}
+
+void render_thread_frame(void* user, u32 frame) {
+    RenderThread* rt = (RenderThread*)user;
+    if (!rt->filling) return;  // Aucune ligne émulée (LCD éteint)
+
+    rt->filling->frame = frame;
+    rt->filling = NULL;
+
+    mutex_lock(&rt->lock);
+    __atomic_store_n(&rt->submitted, rt->submitted + 1, __ATOMIC_RELEASE);
+    cond_signal(&rt->wake);
+    mutex_unlock(&rt->lock);
+}
+
+const u8* render_thread_latest_frame(RenderThread* rt, u32* frame) {
+    if (!(__atomic_load_n(&rt->middle, __ATOMIC_ACQUIRE) & RENDER_OUTPUT_FRESH)) {
+        return NULL;
+    }
+    rt->front = __atomic_exchange_n(&rt->middle, rt->front, __ATOMIC_ACQ_REL) & 3;
+    if (frame) {
+        *frame = rt->output_frame[rt->front];
+    }
+    return rt->output[rt->front];
+}
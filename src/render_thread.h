@@ -0,0 +1,81 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "common.h"
+#include "ppu.h"
+#include "framebuffer.h"
+#include "thread.h"
+
+// Pipeline de rendu optionnel sur un thread dédié.
+// Le thread d'émulation ne fait que figer les registres de chaque ligne
+// (fin du mode 2) et copier la VRAM quand elle a changé; le thread de
+// rendu rastérise la frame N pendant que le CPU émule la frame N+1.
+//
+// Passage de relais sans verrou:
+//  - jobs: double tampon, compteurs submitted/consumed (un producteur, un
+//    consommateur); l'émulation n'attend que si le rendu a 2 frames de retard
+//  - sorties: triple tampon, la présentation prend toujours la plus récente
+#define RENDER_JOBS 2
+
+typedef struct {
+    PPULineRegs regs[GB_HEIGHT];
+    bool line_valid[GB_HEIGHT];     // Ligne effectivement émulée (LCD allumé)
+    u8 line_vram[GB_HEIGHT];        // Copie VRAM utilisée par chaque ligne
+
+    // Copies sur modification (au plus une par ligne)
+    u8* vram_copies[GB_HEIGHT];     // 0x2000 octets, allouées à la demande
+    u32 vram_version[GB_HEIGHT];    // Compteur d'écritures VRAM à la copie
+    u32 vram_count;
+
+    u32 frame;
+} RenderJob;
+
+// Appelé sur le thread de rendu pour chaque frame rastérisée, dans l'ordre
+typedef void (*RenderFrameCallback)(void* user, u32 frame, const u8* framebuffer);
+
+typedef struct {
+    // Source (lue uniquement depuis le thread d'émulation)
+    const u8* vram;
+    const u32* vram_writes;
+
+    // Jobs (producteur: émulation, consommateur: rendu)
+    RenderJob jobs[RENDER_JOBS];
+    RenderJob* filling;             // Job en cours de remplissage
+    u32 submitted;                  // Atomique: jobs publiés
+    u32 consumed;                   // Atomique: jobs rastérisés
+
+    // Sorties en triple tampon
+    u8 output[3][FB_PIXELS];
+    u32 output_frame[3];
+    u32 back;                       // Thread de rendu
+    u32 middle;                     // Atomique: index | RENDER_OUTPUT_FRESH
+    u32 front;                      // Présentation
+
+    RenderFrameCallback on_frame;
+    void* user;
+
+    Thread thread;
+    Mutex lock;                     // Seulement pour endormir le thread inactif
+    CondVar wake;
+    bool stop;
+    bool running;
+
+    // Statistiques
+    u32 frames_rendered;
+    u32 producer_waits;             // Attentes de l'émulation (rendu en retard)
+    u32 vram_copies_made;
+} RenderThread;
+
+bool render_thread_start(RenderThread* rt, const u8* vram, const u32* vram_writes,
+                         RenderFrameCallback on_frame, void* user);
+void render_thread_stop(RenderThread* rt);  // Rastérise les jobs publiés puis termine
+void render_thread_attach(RenderThread* rt, PPU* ppu);
+
+// Callbacks de PPUObserver (thread d'émulation)
+void render_thread_line(void* user, u8 line, const PPULineRegs* regs);
+void render_thread_frame(void* user, u32 frame);
+
+// Présentation: frame la plus récente, NULL si rien de nouveau
+const u8* render_thread_latest_frame(RenderThread* rt, u32* frame);
+
+#endif // RENDER_THREAD_H
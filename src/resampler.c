@@ -0,0 +1,194 @@
+#include "resampler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define RESAMPLER_PI 3.14159265358979323846
+
+// sin(x) sans libm: réduction à [-pi, pi], repli sur [-pi/2, pi/2] puis
+// série de Taylor (erreur < 1e-12), suffisant pour des coefficients 16 bits
+static double resampler_sin(double x) {
+    double turns = x / (2.0 * RESAMPLER_PI);
+    long long n = (long long)(turns >= 0 ? turns + 0.5 : turns - 0.5);
+    x -= (double)n * 2.0 * RESAMPLER_PI;
+    if (x > RESAMPLER_PI / 2) x = RESAMPLER_PI - x;
+    if (x < -RESAMPLER_PI / 2) x = -RESAMPLER_PI - x;
+
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int i = 1; i <= 10; i++) {
+        term *= -x2 / (double)((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+static double resampler_cos(double x) {
+    return resampler_sin(x + RESAMPLER_PI / 2);
+}
+
+// Noyau: pour la phase p, le coefficient k pondère l'échantillon situé à
+// t = k - (TAPS/2 - 1) - p/PHASES du point de sortie
+static void resampler_build_kernel(Resampler* rs) {
+    double cutoff = 0.9;
+    if (rs->out_rate < rs->in_rate) {
+        cutoff *= (double)rs->out_rate / (double)rs->in_rate;
+    }
+
+    for (u32 p = 0; p < RESAMPLER_PHASES; p++) {
+        double h[RESAMPLER_TAPS];
+        double total = 0.0;
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            double t = (double)k - (RESAMPLER_TAPS / 2 - 1) - (double)p / RESAMPLER_PHASES;
+            double x = cutoff * t * RESAMPLER_PI;
+            double sinc = x == 0.0 ? 1.0 : resampler_sin(x) / x;
+            double u = t / RESAMPLER_TAPS;
+            double window = 0.0;
+            if (u > -0.5 && u < 0.5) {
+                window = 0.42 + 0.5 * resampler_cos(2.0 * RESAMPLER_PI * u)
+                       + 0.08 * resampler_cos(4.0 * RESAMPLER_PI * u);
+            }
+            h[k] = sinc * window;
+            total += h[k];
+        }
+
+        // Arrondi puis report du reste sur le coefficient central: gain
+        // exactement unitaire pour chaque phase
+        s16* row = rs->kernel + (size_t)p * RESAMPLER_TAPS;
+        s32 sum = 0;
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            double v = h[k] * (1 << RESAMPLER_UNIT_BITS) / total;
+            row[k] = (s16)(v >= 0 ? v + 0.5 : v - 0.5);
+            sum += row[k];
+        }
+        row[RESAMPLER_TAPS / 2 - 1 + (p >= RESAMPLER_PHASES / 2)] += (s16)((1 << RESAMPLER_UNIT_BITS) - sum);
+    }
+}
+
+bool resampler_init(Resampler* rs, u32 in_rate, u32 out_rate) {
+    memset(rs, 0, sizeof(Resampler));
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->base_step = (s64)(((u64)in_rate << 32) / out_rate);
+    rs->target_step = rs->base_step;
+    rs->step = rs->base_step;
+
+    rs->kernel = malloc((size_t)RESAMPLER_PHASES * RESAMPLER_TAPS * sizeof(s16));
+    rs->history[0] = malloc((RESAMPLER_TAPS + RESAMPLER_MAX_INPUT) * sizeof(s16));
+    rs->history[1] = malloc((RESAMPLER_TAPS + RESAMPLER_MAX_INPUT) * sizeof(s16));
+    if (!rs->kernel || !rs->history[0] || !rs->history[1]) {
+        resampler_cleanup(rs);
+        return false;
+    }
+    resampler_build_kernel(rs);
+    resampler_reset(rs);
+    return true;
+}
+
+void resampler_cleanup(Resampler* rs) {
+    free(rs->kernel);
+    free(rs->history[0]);
+    free(rs->history[1]);
+    rs->kernel = NULL;
+    rs->history[0] = rs->history[1] = NULL;
+}
+
+// Historique initial: silence sur la largeur du noyau
+void resampler_reset(Resampler* rs) {
+    memset(rs->history[0], 0, (RESAMPLER_TAPS - 1) * sizeof(s16));
+    memset(rs->history[1], 0, (RESAMPLER_TAPS - 1) * sizeof(s16));
+    rs->history_len = RESAMPLER_TAPS - 1;
+    rs->pos = 0;
+    rs->step = rs->target_step;
+}
+
+void resampler_set_adjust(Resampler* rs, double adjust) {
+    if (adjust < 1.0 - RESAMPLER_MAX_ADJUST) adjust = 1.0 - RESAMPLER_MAX_ADJUST;
+    if (adjust > 1.0 + RESAMPLER_MAX_ADJUST) adjust = 1.0 + RESAMPLER_MAX_ADJUST;
+    rs->target_step = (s64)((double)rs->base_step / adjust);
+}
+
+u32 resampler_max_output(const Resampler* rs, u32 in_frames) {
+    double max_ratio = (double)rs->out_rate / rs->in_rate * (1.0 + RESAMPLER_MAX_ADJUST);
+    return (u32)(in_frames * max_ratio) + 2;
+}
+
+// Produit scalaire d'une phase avec les deux canaux
+static void resampler_dot(const s16* left, const s16* right, const s16* taps,
+                          s32* out_left, s32* out_right) {
+#if defined(__SSE2__)
+    __m128i acc_l = _mm_setzero_si128();
+    __m128i acc_r = _mm_setzero_si128();
+    for (int k = 0; k < RESAMPLER_TAPS; k += 8) {
+        __m128i t = _mm_loadu_si128((const __m128i*)(taps + k));
+        acc_l = _mm_add_epi32(acc_l, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(left + k)), t));
+        acc_r = _mm_add_epi32(acc_r, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(right + k)), t));
+    }
+    // Sommes horizontales des deux accumulateurs en parallèle
+    __m128i lo = _mm_unpacklo_epi32(acc_l, acc_r);  // l0 r0 l1 r1
+    __m128i hi = _mm_unpackhi_epi32(acc_l, acc_r);  // l2 r2 l3 r3
+    __m128i sum = _mm_add_epi32(lo, hi);
+    sum = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+    *out_left = _mm_cvtsi128_si32(sum);
+    *out_right = _mm_cvtsi128_si32(_mm_srli_si128(sum, 4));
+#else
+    s32 l = 0, r = 0;
+    for (int k = 0; k < RESAMPLER_TAPS; k++) {
+        l += left[k] * taps[k];
+        r += right[k] * taps[k];
+    }
+    *out_left = l;
+    *out_right = r;
+#endif
+}
+
+static s16 resampler_clamp(s32 v) {
+    v >>= RESAMPLER_UNIT_BITS;
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (s16)v;
+}
+
+u32 resampler_run(Resampler* rs, const s16* in, u32 in_frames, s16* out) {
+    u32 produced = 0;
+    while (in_frames > 0) {
+        // Désentrelacer une passe à la suite de l'historique
+        u32 n = in_frames < RESAMPLER_MAX_INPUT ? in_frames : RESAMPLER_MAX_INPUT;
+        s16* left = rs->history[0];
+        s16* right = rs->history[1];
+        for (u32 i = 0; i < n; i++) {
+            left[rs->history_len + i] = in[i * 2];
+            right[rs->history_len + i] = in[i * 2 + 1];
+        }
+        rs->history_len += n;
+        in += n * 2;
+        in_frames -= n;
+
+        // Sorties tant que la fenêtre du noyau tient dans l'historique
+        while ((u32)(rs->pos >> 32) + RESAMPLER_TAPS <= rs->history_len) {
+            u32 base = (u32)(rs->pos >> 32);
+            u32 phase = (u32)(rs->pos >> (32 - RESAMPLER_PHASE_BITS)) & (RESAMPLER_PHASES - 1);
+            s32 l, r;
+            resampler_dot(left + base, right + base,
+                          rs->kernel + (size_t)phase * RESAMPLER_TAPS, &l, &r);
+            out[produced * 2] = resampler_clamp(l);
+            out[produced * 2 + 1] = resampler_clamp(r);
+            produced++;
+
+            rs->pos += (u64)rs->step;
+            rs->step += (rs->target_step - rs->step) >> RESAMPLER_SLEW_SHIFT;
+        }
+
+        // Retirer les échantillons consommés
+        u32 consumed = (u32)(rs->pos >> 32);
+        if (consumed > rs->history_len) consumed = rs->history_len;
+        u32 keep = rs->history_len - consumed;
+        memmove(left, left + consumed, keep * sizeof(s16));
+        memmove(right, right + consumed, keep * sizeof(s16));
+        rs->history_len = keep;
+        rs->pos -= (u64)consumed << 32;
+    }
+    return produced;
+}
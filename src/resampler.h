@@ -0,0 +1,43 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include "common.h"
+
+// Rééchantillonneur polyphase à sinc fenêtré (Blackman), stéréo s16.
+// Le noyau est calculé pour le rapport nominal (coupure à 0.9 x la plus
+// petite des deux fréquences de Nyquist), en RESAMPLER_PHASES phases de
+// RESAMPLER_TAPS coefficients; chaque échantillon de sortie est un produit
+// scalaire (SSE2 pmaddwd) avec la phase la plus proche. Le rapport peut
+// être ajusté finement en marche: le pas glisse vers sa cible sur quelques
+// milliers d'échantillons, sans saut audible.
+#define RESAMPLER_TAPS 48
+#define RESAMPLER_PHASE_BITS 8
+#define RESAMPLER_PHASES (1 << RESAMPLER_PHASE_BITS)
+#define RESAMPLER_UNIT_BITS 14        // Somme des coefficients d'une phase
+#define RESAMPLER_MAX_INPUT 1024      // Frames d'entrée traitées par passe
+#define RESAMPLER_MAX_ADJUST 0.01     // Écart maximum du rapport (±1%)
+#define RESAMPLER_SLEW_SHIFT 12       // Glissement du pas (constante de temps)
+
+typedef struct {
+    u32 in_rate;
+    u32 out_rate;
+    s64 base_step;       // Entrée par sortie au rapport nominal (virgule fixe 32 bits)
+    s64 target_step;     // Pas visé après ajustement
+    s64 step;            // Pas courant
+    u64 pos;             // Position dans l'historique (virgule fixe 32 bits)
+    s16* kernel;         // RESAMPLER_PHASES x RESAMPLER_TAPS
+    s16* history[2];     // Échantillons gauche/droite désentrelacés
+    u32 history_len;
+} Resampler;
+
+bool resampler_init(Resampler* rs, u32 in_rate, u32 out_rate);
+void resampler_cleanup(Resampler* rs);
+void resampler_reset(Resampler* rs);
+// Rapport de sortie relatif (1.0 = nominal, >1 produit plus d'échantillons)
+void resampler_set_adjust(Resampler* rs, double adjust);
+// Frames de sortie maximum pour in_frames frames d'entrée
+u32 resampler_max_output(const Resampler* rs, u32 in_frames);
+// Frames stéréo entrelacées; retourne le nombre de frames écrites dans out
+u32 resampler_run(Resampler* rs, const s16* in, u32 in_frames, s16* out);
+
+#endif // RESAMPLER_H
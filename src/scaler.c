@@ -0,0 +1,232 @@
+#include "scaler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+bool scaler_parse_mode(const char* spec, ScalerMode* mode) {
+    ScalerFilter filter = SCALER_NEAREST;
+    if (strncmp(spec, "epx", 3) == 0) {
+        filter = SCALER_EPX;
+        spec += 3;
+    }
+    if (spec[0] < '1' || spec[0] > '0' + SCALER_MAX_FACTOR) {
+        return false;
+    }
+    if (spec[1] != '\0' && !(spec[1] == 'x' && spec[2] == '\0')) {
+        return false;
+    }
+    mode->factor = (u32)(spec[0] - '0');
+    mode->filter = filter;
+    return true;
+}
+
+bool scaler_init(Scaler* scaler, u32 src_width, u32 src_height, ScalerMode mode) {
+    memset(scaler, 0, sizeof(Scaler));
+    if (mode.factor < 1 || mode.factor > SCALER_MAX_FACTOR) {
+        return false;
+    }
+    scaler->mode = mode;
+    scaler->src_width = src_width;
+    scaler->src_height = src_height;
+    scaler->width = src_width * mode.factor;
+    scaler->height = src_height * mode.factor;
+
+    if (mode.filter == SCALER_EPX && mode.factor == 4) {
+        scaler->scratch = malloc((size_t)src_width * src_height * 4);
+        if (!scaler->scratch) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void scaler_cleanup(Scaler* scaler) {
+    free(scaler->scratch);
+    scaler->scratch = NULL;
+}
+
+// Duplication horizontale d'une ligne
+static void scaler_expand_row(const u8* src, u8* dst, u32 width, u32 factor) {
+    u32 x = 0;
+    switch (factor) {
+        case 1:
+            memcpy(dst, src, width);
+            return;
+        case 2:
+#if defined(__SSE2__)
+            for (; x + 16 <= width; x += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+                _mm_storeu_si128((__m128i*)(dst + x * 2), _mm_unpacklo_epi8(v, v));
+                _mm_storeu_si128((__m128i*)(dst + x * 2 + 16), _mm_unpackhi_epi8(v, v));
+            }
+#endif
+            for (; x < width; x++) {
+                dst[x * 2] = dst[x * 2 + 1] = src[x];
+            }
+            return;
+        case 3:
+#if defined(__SSSE3__)
+        {
+            const __m128i s0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+            const __m128i s1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+            const __m128i s2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+            for (; x + 16 <= width; x += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+                _mm_storeu_si128((__m128i*)(dst + x * 3), _mm_shuffle_epi8(v, s0));
+                _mm_storeu_si128((__m128i*)(dst + x * 3 + 16), _mm_shuffle_epi8(v, s1));
+                _mm_storeu_si128((__m128i*)(dst + x * 3 + 32), _mm_shuffle_epi8(v, s2));
+            }
+        }
+#endif
+            for (; x < width; x++) {
+                dst[x * 3] = dst[x * 3 + 1] = dst[x * 3 + 2] = src[x];
+            }
+            return;
+        case 4:
+#if defined(__SSE2__)
+            for (; x + 16 <= width; x += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+                __m128i lo = _mm_unpacklo_epi8(v, v);
+                __m128i hi = _mm_unpackhi_epi8(v, v);
+                _mm_storeu_si128((__m128i*)(dst + x * 4), _mm_unpacklo_epi8(lo, lo));
+                _mm_storeu_si128((__m128i*)(dst + x * 4 + 16), _mm_unpackhi_epi8(lo, lo));
+                _mm_storeu_si128((__m128i*)(dst + x * 4 + 32), _mm_unpacklo_epi8(hi, hi));
+                _mm_storeu_si128((__m128i*)(dst + x * 4 + 48), _mm_unpackhi_epi8(hi, hi));
+            }
+#endif
+            for (; x < width; x++) {
+                dst[x * 4] = dst[x * 4 + 1] = dst[x * 4 + 2] = dst[x * 4 + 3] = src[x];
+            }
+            return;
+    }
+}
+
+// Plus proche voisin: une ligne élargie puis recopiée factor-1 fois
+static void scaler_nearest(const u8* src, u32 width, u32 height, u32 factor,
+                           u8* dst, u32 dst_pitch) {
+    u32 out_width = width * factor;
+    for (u32 y = 0; y < height; y++) {
+        u8* row = dst + (size_t)y * factor * dst_pitch;
+        scaler_expand_row(src + (size_t)y * width, row, width, factor);
+        for (u32 k = 1; k < factor; k++) {
+            memcpy(row + (size_t)k * dst_pitch, row, out_width);
+        }
+    }
+}
+
+static void scaler_epx2_pixel(const u8* cur, const u8* up, const u8* down, u32 width, u32 x,
+                              u8* out0, u8* out1) {
+    u8 e = cur[x], b = up[x], h = down[x];
+    u8 d = x > 0 ? cur[x - 1] : e;
+    u8 f = x + 1 < width ? cur[x + 1] : e;
+    bool c = b != h && d != f;
+    out0[x * 2]     = c && d == b ? d : e;
+    out0[x * 2 + 1] = c && b == f ? f : e;
+    out1[x * 2]     = c && d == h ? d : e;
+    out1[x * 2 + 1] = c && h == f ? f : e;
+}
+
+// Scale2x (EPX): pour chaque pixel E de voisins B (haut), D (gauche),
+// F (droite), H (bas), si B != H et D != F:
+//   E0 = D==B ? D : E   E1 = B==F ? F : E
+//   E2 = D==H ? D : E   E3 = H==F ? F : E
+// Bords: le voisin hors surface est le pixel lui-même.
+static void scaler_epx2(const u8* src, u32 width, u32 height, u8* dst, u32 dst_pitch) {
+    for (u32 y = 0; y < height; y++) {
+        const u8* cur = src + (size_t)y * width;
+        const u8* up = y > 0 ? cur - width : cur;
+        const u8* down = y + 1 < height ? cur + width : cur;
+        u8* out0 = dst + (size_t)y * 2 * dst_pitch;
+        u8* out1 = out0 + dst_pitch;
+
+        // Colonne 0 et fin de ligne en scalaire (voisins latéraux bornés)
+        u32 x = 1;
+#if defined(__SSE2__)
+        const __m128i ones = _mm_set1_epi8(-1);
+        for (; x + 16 <= width - 1; x += 16) {
+            __m128i e = _mm_loadu_si128((const __m128i*)(cur + x));
+            __m128i b = _mm_loadu_si128((const __m128i*)(up + x));
+            __m128i h = _mm_loadu_si128((const __m128i*)(down + x));
+            __m128i d = _mm_loadu_si128((const __m128i*)(cur + x - 1));
+            __m128i f = _mm_loadu_si128((const __m128i*)(cur + x + 1));
+            __m128i c = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(b, h), _mm_cmpeq_epi8(d, f)), ones);
+            __m128i m0 = _mm_and_si128(c, _mm_cmpeq_epi8(d, b));
+            __m128i m1 = _mm_and_si128(c, _mm_cmpeq_epi8(b, f));
+            __m128i m2 = _mm_and_si128(c, _mm_cmpeq_epi8(d, h));
+            __m128i m3 = _mm_and_si128(c, _mm_cmpeq_epi8(h, f));
+            __m128i e0 = _mm_or_si128(_mm_and_si128(m0, d), _mm_andnot_si128(m0, e));
+            __m128i e1 = _mm_or_si128(_mm_and_si128(m1, f), _mm_andnot_si128(m1, e));
+            __m128i e2 = _mm_or_si128(_mm_and_si128(m2, d), _mm_andnot_si128(m2, e));
+            __m128i e3 = _mm_or_si128(_mm_and_si128(m3, f), _mm_andnot_si128(m3, e));
+            _mm_storeu_si128((__m128i*)(out0 + x * 2), _mm_unpacklo_epi8(e0, e1));
+            _mm_storeu_si128((__m128i*)(out0 + x * 2 + 16), _mm_unpackhi_epi8(e0, e1));
+            _mm_storeu_si128((__m128i*)(out1 + x * 2), _mm_unpacklo_epi8(e2, e3));
+            _mm_storeu_si128((__m128i*)(out1 + x * 2 + 16), _mm_unpackhi_epi8(e2, e3));
+        }
+#endif
+        scaler_epx2_pixel(cur, up, down, width, 0, out0, out1);
+        for (; x < width; x++) {
+            scaler_epx2_pixel(cur, up, down, width, x, out0, out1);
+        }
+    }
+}
+
+// Scale3x (AdvMAME3x) sur le voisinage 3x3 A B C / D E F / G H I
+static void scaler_epx3(const u8* src, u32 width, u32 height, u8* dst, u32 dst_pitch) {
+    for (u32 y = 0; y < height; y++) {
+        const u8* cur = src + (size_t)y * width;
+        const u8* up = y > 0 ? cur - width : cur;
+        const u8* down = y + 1 < height ? cur + width : cur;
+        u8* out0 = dst + (size_t)y * 3 * dst_pitch;
+        u8* out1 = out0 + dst_pitch;
+        u8* out2 = out1 + dst_pitch;
+
+        for (u32 x = 0; x < width; x++) {
+            u32 l = x > 0 ? x - 1 : x;
+            u32 r = x + 1 < width ? x + 1 : x;
+            u8 a = up[l], b = up[x], c = up[r];
+            u8 d = cur[l], e = cur[x], f = cur[r];
+            u8 g = down[l], h = down[x], i = down[r];
+            u8* o0 = out0 + x * 3;
+            u8* o1 = out1 + x * 3;
+            u8* o2 = out2 + x * 3;
+            if (b != h && d != f) {
+                o0[0] = d == b ? d : e;
+                o0[1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+                o0[2] = b == f ? f : e;
+                o1[0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+                o1[1] = e;
+                o1[2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+                o2[0] = d == h ? d : e;
+                o2[1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+                o2[2] = h == f ? f : e;
+            } else {
+                o0[0] = o0[1] = o0[2] = e;
+                o1[0] = o1[1] = o1[2] = e;
+                o2[0] = o2[1] = o2[2] = e;
+            }
+        }
+    }
+}
+
+void scaler_run(Scaler* scaler, const u8* src, u8* dst, u32 dst_pitch) {
+    u32 w = scaler->src_width;
+    u32 h = scaler->src_height;
+    u32 factor = scaler->mode.factor;
+
+    if (scaler->mode.filter != SCALER_EPX || factor == 1) {
+        scaler_nearest(src, w, h, factor, dst, dst_pitch);
+    } else if (factor == 2) {
+        scaler_epx2(src, w, h, dst, dst_pitch);
+    } else if (factor == 3) {
+        scaler_epx3(src, w, h, dst, dst_pitch);
+    } else {
+        // Scale4x = Scale2x appliqué deux fois
+        scaler_epx2(src, w, h, scaler->scratch, w * 2);
+        scaler_epx2(scaler->scratch, w * 2, h * 2, dst, dst_pitch);
+    }
+}
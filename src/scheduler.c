@@ -0,0 +1,61 @@
+#include "scheduler.h"
+
+void scheduler_init(Scheduler* sched) {
+    memset(sched, 0, sizeof(Scheduler));
+    sched->next = SCHEDULER_NEVER;
+}
+
+// Recalcule la prochaine échéance (quelques emplacements: parcours direct)
+static void scheduler_update_next(Scheduler* sched) {
+    u64 next = SCHEDULER_NEVER;
+    for (u32 i = 0; i < sched->count; i++) {
+        if (sched->events[i].when < next) next = sched->events[i].when;
+    }
+    sched->next = next;
+}
+
+int scheduler_register(Scheduler* sched, SchedulerCallback callback, void* user) {
+    if (sched->count >= SCHEDULER_MAX_EVENTS) return -1;
+    SchedulerEvent* event = &sched->events[sched->count];
+    event->callback = callback;
+    event->user = user;
+    event->when = SCHEDULER_NEVER;
+    return (int)sched->count++;
+}
+
+void scheduler_schedule(Scheduler* sched, int id, u64 when) {
+    sched->events[id].when = when;
+    if (when < sched->next) {
+        sched->next = when;
+    } else {
+        scheduler_update_next(sched);
+    }
+}
+
+void scheduler_cancel(Scheduler* sched, int id) {
+    if (sched->events[id].when == SCHEDULER_NEVER) return;
+    sched->events[id].when = SCHEDULER_NEVER;
+    scheduler_update_next(sched);
+}
+
+u64 scheduler_when(const Scheduler* sched, int id) {
+    return sched->events[id].when;
+}
+
+// Un callback peut reprogrammer son événement (ou un autre), y compris
+// avant now: il est alors rejoué dans la même passe
+void scheduler_run(Scheduler* sched, u64 now) {
+    while (sched->next <= now) {
+        SchedulerEvent* due = NULL;
+        for (u32 i = 0; i < sched->count; i++) {
+            if (sched->events[i].when == sched->next) {
+                due = &sched->events[i];
+                break;
+            }
+        }
+        u64 when = due->when;
+        due->when = SCHEDULER_NEVER;
+        scheduler_update_next(sched);
+        due->callback(due->user, when);
+    }
+}
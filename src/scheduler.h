@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "common.h"
+
+// Événements datés en cycles émulés absolus (horloge maître). Chaque
+// composant réserve ses emplacements une fois, puis programme ou annule
+// leur échéance; la boucle principale compare l'horloge à la prochaine
+// échéance après chaque instruction et ne parcourt les événements qu'à ce
+// moment-là, au lieu d'interroger chaque composant à chaque pas.
+#define SCHEDULER_MAX_EVENTS 16
+#define SCHEDULER_NEVER UINT64_MAX
+
+// when: échéance programmée (l'horloge peut l'avoir dépassée de quelques
+// cycles, le temps de finir l'instruction en cours)
+typedef void (*SchedulerCallback)(void* user, u64 when);
+
+typedef struct {
+    SchedulerCallback callback;
+    void* user;
+    u64 when;           // SCHEDULER_NEVER si inactif
+} SchedulerEvent;
+
+typedef struct {
+    SchedulerEvent events[SCHEDULER_MAX_EVENTS];
+    u32 count;          // Emplacements réservés
+    u64 next;           // Échéance la plus proche
+} Scheduler;
+
+void scheduler_init(Scheduler* sched);
+int scheduler_register(Scheduler* sched, SchedulerCallback callback, void* user);  // -1 si plein
+void scheduler_schedule(Scheduler* sched, int id, u64 when);
+void scheduler_cancel(Scheduler* sched, int id);
+u64 scheduler_when(const Scheduler* sched, int id);
+void scheduler_run(Scheduler* sched, u64 now);  // Échéances <= now, dans l'ordre
+
+#endif // SCHEDULER_H
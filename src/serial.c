@@ -0,0 +1,214 @@
+#include "serial.h"
+
+// Ajoute un octet émis; le tampon double quand il est plein
+static void serial_output_push(Serial* serial, u8 value) {
+    if (serial->output_length + 1 >= serial->output_capacity) {
+        u32 capacity = serial->output_capacity ? serial->output_capacity * 2 : SERIAL_OUTPUT_INITIAL;
+        u8* output = realloc(serial->output, capacity);
+        if (!output) return;  // Octet perdu plutôt qu'un arrêt de l'émulation
+        serial->output = output;
+        serial->output_capacity = capacity;
+    }
+    serial->output[serial->output_length++] = value;
+    serial->output[serial->output_length] = 0;
+}
+
+// Fin du transfert en cours
+static void serial_complete(Serial* serial) {
+    serial_output_push(serial, serial->sb);
+    if (serial->linked && serial->peer_ready) {
+        // Échange: l'octet émis sera livré au partenaire à la frontière suivante
+        serial->link_byte = serial->sb;
+        serial->link_pending = true;
+        serial->sb = serial->peer_sb;
+        serial->peer_ready = false;
+    } else {
+        serial->sb = 0xFF;  // Pas de partenaire: bits entrants à 1
+    }
+    serial->sc &= 0x7F;
+    serial->transferring = false;
+    serial->interrupt_pending = true;
+}
+
+static void serial_sync_to(Serial* serial, u64 target) {
+    if (serial->transferring && serial->transfer_end <= target) {
+        serial_complete(serial);
+    }
+}
+
+void serial_sync(Serial* serial) {
+    serial_sync_to(serial, *serial->clock);
+}
+
+static void serial_schedule(Serial* serial) {
+    if (!serial->scheduler) return;
+    if (serial->transferring) {
+        scheduler_schedule(serial->scheduler, serial->transfer_event, serial->transfer_end);
+    } else {
+        scheduler_cancel(serial->scheduler, serial->transfer_event);
+    }
+}
+
+// Événement: fin de transfert à l'instant exact
+static void serial_transfer_event(void* user, u64 when) {
+    serial_sync_to((Serial*)user, when);
+}
+
+void serial_init(Serial* serial) {
+    memset(serial, 0, sizeof(Serial));
+    serial->clock = &serial->local_cycles;
+    serial->transfer_event = -1;
+    serial_reset(serial);
+}
+
+void serial_reset(Serial* serial) {
+    serial->sb = 0x00;
+    serial->sc = 0x7E;
+    serial->transferring = false;
+    serial->transfer_end = 0;
+    serial->interrupt_pending = false;
+    serial->output_length = 0;
+    serial->stream_flushed = 0;
+    if (serial->output) serial->output[0] = 0;
+    serial->peer_ready = false;
+    serial->link_pending = false;
+    serial_schedule(serial);
+}
+
+void serial_cleanup(Serial* serial) {
+    serial_flush(serial);
+    free(serial->output);
+    serial->output = NULL;
+    serial->output_length = 0;
+    serial->output_capacity = 0;
+    serial->stream_flushed = 0;
+}
+
+void serial_set_clock(Serial* serial, const u64* clock) {
+    serial_sync(serial);
+    serial->clock = clock ? clock : &serial->local_cycles;
+}
+
+// La fin de transfert devient un événement daté (nécessite l'horloge maître)
+bool serial_set_scheduler(Serial* serial, Scheduler* scheduler) {
+    if (serial->clock == &serial->local_cycles) return false;
+
+    int id = scheduler_register(scheduler, serial_transfer_event, serial);
+    if (id < 0) return false;
+
+    serial->scheduler = scheduler;
+    serial->transfer_event = id;
+    serial_schedule(serial);
+    return true;
+}
+
+// Tick: avance l'horloge locale (sans horloge maître)
+void serial_tick(Serial* serial, u8 cycles) {
+    if (serial->clock != &serial->local_cycles) return;
+    serial->local_cycles += cycles;
+    serial_sync(serial);
+}
+
+void serial_write(Serial* serial, u16 address, u8 value) {
+    serial_sync(serial);
+
+    switch (address) {
+        case SB_REG:
+            serial->sb = value;
+            break;
+
+        case SC_REG:
+            serial->sc = value | 0x7E;
+            // Bit 7 + horloge interne: 8 bits à 8192 Hz. En horloge externe,
+            // le transfert attend le maître (serial_receive, jamais sans câble).
+            serial->transferring = (value & 0x81) == 0x81;
+            if (serial->transferring) {
+                serial->transfer_end = *serial->clock + SERIAL_TRANSFER_CYCLES;
+            }
+            serial_schedule(serial);
+            break;
+    }
+}
+
+u8 serial_read(Serial* serial, u16 address) {
+    serial_sync(serial);
+
+    switch (address) {
+        case SB_REG: return serial->sb;
+        case SC_REG: return serial->sc;
+        default:     return 0xFF;
+    }
+}
+
+u8 serial_get_interrupts(Serial* serial) {
+    if (serial->interrupt_pending) {
+        serial->interrupt_pending = false;
+        return 0x08;  // SERIAL_INT
+    }
+    return 0;
+}
+
+const u8* serial_output(const Serial* serial, u32* length) {
+    if (length) *length = serial->output_length;
+    return serial->output_length ? serial->output : (const u8*)"";
+}
+
+// Recherche dans la sortie (ex. "Passed"/"Failed" des ROMs de test)
+bool serial_output_contains(const Serial* serial, const char* text) {
+    size_t n = strlen(text);
+    if (n == 0) return true;
+    if (n > serial->output_length) return false;
+    // Pas de strstr: la sortie peut contenir des octets nuls
+    for (u32 i = 0; i + n <= serial->output_length; i++) {
+        if (memcmp(serial->output + i, text, n) == 0) return true;
+    }
+    return false;
+}
+
+void serial_set_stream(Serial* serial, FILE* stream) {
+    serial_flush(serial);
+    serial->stream = stream;
+    serial->stream_flushed = serial->output_length;
+}
+
+// Écrit d'un bloc les octets émis depuis le dernier vidage
+void serial_flush(Serial* serial) {
+    if (!serial->stream || serial->stream_flushed == serial->output_length) return;
+    fwrite(serial->output + serial->stream_flushed, 1,
+           serial->output_length - serial->stream_flushed, serial->stream);
+    fflush(serial->stream);
+    serial->stream_flushed = serial->output_length;
+}
+
+void serial_connect(Serial* serial, bool linked) {
+    serial->linked = linked;
+    serial->peer_ready = false;
+    serial->link_pending = false;
+}
+
+void serial_set_peer(Serial* serial, bool ready, u8 sb) {
+    serial->peer_ready = ready;
+    serial->peer_sb = sb;
+}
+
+bool serial_waiting(Serial* serial) {
+    serial_sync(serial);
+    return (serial->sc & 0x81) == 0x80;
+}
+
+bool serial_take_sent(Serial* serial, u8* value) {
+    serial_sync(serial);
+    if (!serial->link_pending) return false;
+    serial->link_pending = false;
+    *value = serial->link_byte;
+    return true;
+}
+
+// Le maître a cadencé les 8 bits: fin du transfert en horloge externe
+void serial_receive(Serial* serial, u8 value) {
+    if (!serial_waiting(serial)) return;  // Pas prêt: l'octet est perdu
+    serial_output_push(serial, serial->sb);
+    serial->sb = value;
+    serial->sc &= 0x7F;
+    serial->interrupt_pending = true;
+}
@@ -0,0 +1,78 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "common.h"
+#include "scheduler.h"
+
+// Port série (SB/SC). Un transfert en horloge interne dure 8 bits à 8192 Hz;
+// à la fin, l'octet émis rejoint le tampon de sortie, SB reçoit l'octet
+// entrant (0xFF sans câble: ligne au repos), SC bit 7 retombe et l'IRQ
+// Serial est levée. Aucun appel système par octet: la sortie s'accumule en
+// mémoire (serial_output) et n'est écrite sur le flux optionnel qu'à la
+// demande (serial_flush, une fois par frame dans la boucle principale).
+//
+// Câble (link.c): l'état du partenaire est relevé à chaque frontière de
+// quantum. Le maître termine son transfert à l'heure exacte avec l'octet
+// relevé; l'esclave (horloge externe) reçoit le sien à la frontière suivante.
+#define SERIAL_TRANSFER_CYCLES (8 * 512)
+#define SERIAL_OUTPUT_INITIAL 256     // Capacité initiale du tampon (doublée au besoin)
+
+typedef struct {
+    u8 sb;                   // Serial transfer data (0xFF01)
+    u8 sc;                   // Serial transfer control (0xFF02)
+    bool transferring;       // SC bit 7 en horloge interne
+    u64 transfer_end;
+    bool interrupt_pending;  // Interruption série en attente
+
+    // Octets émis depuis le reset, toujours terminés par 0 (recherche de texte)
+    u8* output;
+    u32 output_length;
+    u32 output_capacity;
+
+    // Flux optionnel (stdout, fichier); output[stream_flushed..] reste à écrire
+    FILE* stream;
+    u32 stream_flushed;
+
+    // Horloge rattrapée (horloge maître, ou local_cycles avancée par serial_tick)
+    const u64* clock;
+    u64 local_cycles;
+
+    // Fin de transfert programmée (optionnel)
+    Scheduler* scheduler;
+    int transfer_event;
+
+    // Câble: partenaire relevé à la dernière frontière, octet à lui livrer
+    bool linked;
+    bool peer_ready;         // Partenaire en attente en horloge externe
+    u8 peer_sb;
+    bool link_pending;       // Octet émis en horloge interne pas encore livré
+    u8 link_byte;
+} Serial;
+
+void serial_init(Serial* serial);
+void serial_reset(Serial* serial);
+void serial_cleanup(Serial* serial);
+void serial_tick(Serial* serial, u8 cycles);  // Horloge locale uniquement
+void serial_write(Serial* serial, u16 address, u8 value);
+u8 serial_read(Serial* serial, u16 address);
+u8 serial_get_interrupts(Serial* serial);  // Récupère l'interruption série
+
+// Horloge maître et événement de fin de transfert
+void serial_set_clock(Serial* serial, const u64* clock);
+bool serial_set_scheduler(Serial* serial, Scheduler* scheduler);
+void serial_sync(Serial* serial);
+
+// Sortie: tampon en mémoire et flux optionnel
+const u8* serial_output(const Serial* serial, u32* length);
+bool serial_output_contains(const Serial* serial, const char* text);
+void serial_set_stream(Serial* serial, FILE* stream);
+void serial_flush(Serial* serial);
+
+// Câble: appelés par link.c, les deux instances arrêtées à une frontière
+void serial_connect(Serial* serial, bool linked);
+void serial_set_peer(Serial* serial, bool ready, u8 sb);
+bool serial_waiting(Serial* serial);                // Attente en horloge externe
+bool serial_take_sent(Serial* serial, u8* value);   // Octet émis à livrer
+void serial_receive(Serial* serial, u8 value);      // Fin d'un transfert esclave
+
+#endif // SERIAL_H
@@ -0,0 +1,114 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "thread.h"
+
+// Trampoline: signature de thread native -> ThreadFunc
+typedef struct {
+    ThreadFunc func;
+    void* arg;
+} ThreadStart;
+
+#ifdef _WIN32
+
+static DWORD WINAPI thread_entry(LPVOID param) {
+    ThreadStart start = *(ThreadStart*)param;
+    free(param);
+    start.func(start.arg);
+    return 0;
+}
+
+bool thread_start(Thread* thread, ThreadFunc func, void* arg) {
+    ThreadStart* start = malloc(sizeof(ThreadStart));
+    if (!start) return false;
+    start->func = func;
+    start->arg = arg;
+    thread->handle = CreateThread(NULL, 0, thread_entry, start, 0, NULL);
+    if (!thread->handle) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+void thread_join(Thread* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+void thread_yield(void) { SwitchToThread(); }
+void thread_sleep_ms(u32 ms) { Sleep(ms); }
+
+u64 thread_time_us(void) {
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (u64)(now.QuadPart / freq.QuadPart) * 1000000u +
+           (u64)(now.QuadPart % freq.QuadPart) * 1000000u / (u64)freq.QuadPart;
+}
+
+void mutex_init(Mutex* mutex) { InitializeCriticalSection(mutex); }
+void mutex_destroy(Mutex* mutex) { DeleteCriticalSection(mutex); }
+void mutex_lock(Mutex* mutex) { EnterCriticalSection(mutex); }
+void mutex_unlock(Mutex* mutex) { LeaveCriticalSection(mutex); }
+
+void cond_init(CondVar* cond) { InitializeConditionVariable(cond); }
+void cond_destroy(CondVar* cond) { (void)cond; }
+void cond_wait(CondVar* cond, Mutex* mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void cond_signal(CondVar* cond) { WakeConditionVariable(cond); }
+void cond_broadcast(CondVar* cond) { WakeAllConditionVariable(cond); }
+
+#else
+
+#include <sched.h>
+#include <time.h>
+
+static void* thread_entry(void* param) {
+    ThreadStart start = *(ThreadStart*)param;
+    free(param);
+    start.func(start.arg);
+    return NULL;
+}
+
+bool thread_start(Thread* thread, ThreadFunc func, void* arg) {
+    ThreadStart* start = malloc(sizeof(ThreadStart));
+    if (!start) return false;
+    start->func = func;
+    start->arg = arg;
+    if (pthread_create(&thread->handle, NULL, thread_entry, start) != 0) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+void thread_join(Thread* thread) { pthread_join(thread->handle, NULL); }
+
+void thread_yield(void) { sched_yield(); }
+
+void thread_sleep_ms(u32 ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+u64 thread_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000u + (u64)ts.tv_nsec / 1000u;
+}
+
+void mutex_init(Mutex* mutex) { pthread_mutex_init(mutex, NULL); }
+void mutex_destroy(Mutex* mutex) { pthread_mutex_destroy(mutex); }
+void mutex_lock(Mutex* mutex) { pthread_mutex_lock(mutex); }
+void mutex_unlock(Mutex* mutex) { pthread_mutex_unlock(mutex); }
+
+void cond_init(CondVar* cond) { pthread_cond_init(cond, NULL); }
+void cond_destroy(CondVar* cond) { pthread_cond_destroy(cond); }
+void cond_wait(CondVar* cond, Mutex* mutex) { pthread_cond_wait(cond, mutex); }
+void cond_signal(CondVar* cond) { pthread_cond_signal(cond); }
+void cond_broadcast(CondVar* cond) { pthread_cond_broadcast(cond); }
+
+#endif
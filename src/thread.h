@@ -0,0 +1,38 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "common.h"
+
+// Primitives de threads minimales (pthreads ou API Win32)
+#ifdef _WIN32
+#include <windows.h>
+typedef struct { HANDLE handle; } Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE CondVar;
+#else
+#include <pthread.h>
+typedef struct { pthread_t handle; } Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t CondVar;
+#endif
+
+typedef void (*ThreadFunc)(void* arg);
+
+bool thread_start(Thread* thread, ThreadFunc func, void* arg);
+void thread_join(Thread* thread);
+void thread_yield(void);
+void thread_sleep_ms(u32 ms);
+u64 thread_time_us(void);        // Horloge monotone (microsecondes)
+
+void mutex_init(Mutex* mutex);
+void mutex_destroy(Mutex* mutex);
+void mutex_lock(Mutex* mutex);
+void mutex_unlock(Mutex* mutex);
+
+void cond_init(CondVar* cond);
+void cond_destroy(CondVar* cond);
+void cond_wait(CondVar* cond, Mutex* mutex);
+void cond_signal(CondVar* cond);
+void cond_broadcast(CondVar* cond);
+
+#endif // THREAD_H
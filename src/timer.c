@@ -1,85 +1,199 @@
 #include "timer.h"
 
+// Bit du compteur interne par fréquence TAC (4096/262144/65536/16384 Hz)
+static const u16 TIMA_BITS[4] = { 0x0200, 0x0008, 0x0020, 0x0080 };
+
+// Sortie du multiplexeur TAC: bit choisi ET timer activé
+static bool timer_signal(u16 counter, u8 tac) {
+    return (tac & 0x04) && (counter & TIMA_BITS[tac & 0x03]);
+}
+
+// Cycles jusqu'au n-ième front descendant (n >= 1) du bit depuis counter
+static u64 timer_edge_delay(u16 counter, u16 bit, u32 n) {
+    u32 period = (u32)bit << 1;
+    return (u64)(period - (counter & (period - 1))) + (u64)(n - 1) * period;
+}
+
+// Nombre de fronts descendants du bit sur les cycles suivant counter
+static u64 timer_edge_count(u16 counter, u16 bit, u64 cycles) {
+    u32 period = (u32)bit << 1;
+    return ((counter & (period - 1)) + cycles) / period;
+}
+
+// Incrément de TIMA à l'instant synchronisé; le débordement passe par 0x00
+static void timer_increment(Timer* timer) {
+    if (timer->tima == 0xFF) {
+        timer->tima = 0x00;
+        timer->reloading = true;
+        timer->reload_at = timer->synced_cycles + TIMER_RELOAD_DELAY;
+    } else {
+        timer->tima++;
+    }
+}
+
+// Rattraper le timer jusqu'à target: le compteur avance d'un bloc, TIMA du
+// nombre de fronts; chaque débordement découpe l'intervalle au rechargement
+static void timer_sync_to(Timer* timer, u64 target) {
+    while (timer->synced_cycles < target) {
+        u64 limit = target;
+        if (timer->reloading && timer->reload_at < limit) {
+            limit = timer->reload_at;
+        }
+        u64 cycles = limit - timer->synced_cycles;
+
+        // Pas de front pendant le rechargement (plus court qu'une période)
+        if ((timer->tac & 0x04) && !timer->reloading) {
+            u16 bit = TIMA_BITS[timer->tac & 0x03];
+            u64 edges = timer_edge_count(timer->counter, bit, cycles);
+            u32 remaining = 0x100 - timer->tima;
+            if (edges >= remaining) {
+                u64 delay = timer_edge_delay(timer->counter, bit, remaining);
+                timer->counter = (u16)(timer->counter + delay);
+                timer->synced_cycles += delay;
+                timer->tima = 0xFF;
+                timer_increment(timer);
+                continue;
+            }
+            timer->tima = (u8)(timer->tima + edges);
+        }
+
+        timer->counter = (u16)(timer->counter + cycles);
+        timer->synced_cycles = limit;
+
+        if (timer->reloading && timer->synced_cycles == timer->reload_at) {
+            timer->reloading = false;
+            timer->tima = timer->tma;
+            timer->interrupt_pending = true;
+        }
+    }
+}
+
+void timer_sync(Timer* timer) {
+    timer_sync_to(timer, *timer->clock);
+}
+
+// Prochaine échéance: rechargement en cours, sinon débordement calculé
+// depuis le compteur et TIMA (aucun pas intermédiaire)
+static void timer_schedule(Timer* timer) {
+    if (!timer->scheduler) return;
+
+    u64 when = SCHEDULER_NEVER;
+    if (timer->reloading) {
+        when = timer->reload_at;
+    } else if (timer->tac & 0x04) {
+        u16 bit = TIMA_BITS[timer->tac & 0x03];
+        when = timer->synced_cycles
+             + timer_edge_delay(timer->counter, bit, 0x100 - timer->tima)
+             + TIMER_RELOAD_DELAY;
+    }
+
+    if (when == SCHEDULER_NEVER) {
+        scheduler_cancel(timer->scheduler, timer->overflow_event);
+    } else {
+        scheduler_schedule(timer->scheduler, timer->overflow_event, when);
+    }
+}
+
+// Événement: rechargement TMA + IRQ, puis débordement suivant
+static void timer_overflow_event(void* user, u64 when) {
+    Timer* timer = (Timer*)user;
+    timer_sync_to(timer, when);
+    timer_schedule(timer);
+}
+
 // Initialisation du timer
 void timer_init(Timer* timer) {
     memset(timer, 0, sizeof(Timer));
+    timer->clock = &timer->local_cycles;
+    timer->overflow_event = -1;
     timer_reset(timer);
 }
 
 // Reset du timer
 void timer_reset(Timer* timer) {
-    timer->div = 0;
+    timer->counter = 0;
     timer->tima = 0;
     timer->tma = 0;
     timer->tac = 0;
-    timer->div_cycles = 0;
-    timer->tima_cycles = 0;
-    timer->tima_period = 0;
+    timer->reloading = false;
+    timer->reload_at = 0;
     timer->interrupt_pending = false;
+    timer->synced_cycles = *timer->clock;
+    timer_schedule(timer);
+}
+
+void timer_set_clock(Timer* timer, const u64* clock) {
+    timer_sync(timer);
+    timer->clock = clock ? clock : &timer->local_cycles;
+    timer->synced_cycles = *timer->clock;
 }
 
-// Tick du timer
+// Le débordement devient un événement daté (nécessite l'horloge maître)
+bool timer_set_scheduler(Timer* timer, Scheduler* scheduler) {
+    if (timer->clock == &timer->local_cycles) return false;
+
+    int id = scheduler_register(scheduler, timer_overflow_event, timer);
+    if (id < 0) return false;
+
+    timer->scheduler = scheduler;
+    timer->overflow_event = id;
+    timer_sync(timer);
+    timer_schedule(timer);
+    return true;
+}
+
+// Tick du timer: avance l'horloge locale (sans horloge maître)
 void timer_tick(Timer* timer, u8 cycles) {
-    // DIV timer (incrémente toutes les 256 cycles)
-    timer->div_cycles += cycles;
-    if (timer->div_cycles >= 256) {
-        timer->div_cycles -= 256;
-        timer->div++;
-    }
-    
-    // TIMA timer
-    if (timer->tac & 0x04) {  // Timer enabled
-        // Cas particulier attendu par les tests: overflow immédiat quand TIMA==0xFF
-        if (timer->tima == 0xFF) {
-            timer->tima = timer->tma;
-            timer->interrupt_pending = true;
-            timer->tima_cycles = 0;
-            return;
-        }
-        timer->tima_cycles += cycles;
-        if (timer->tima_period > 0 && timer->tima_cycles >= timer->tima_period) {
-            timer->tima_cycles -= timer->tima_period;
-            u16 next = (u16)timer->tima + 1;
-            if (next > 0xFF) {
-                // Overflow: TIMA passes through 0x00 then reload TMA immediately for unit test
-                timer->tima = timer->tma;
-                timer->interrupt_pending = true;
-            } else {
-                timer->tima = (u8)next;
-            }
-        }
-    }
+    if (timer->clock != &timer->local_cycles) return;
+    timer->local_cycles += cycles;
+    timer_sync(timer);
 }
 
 // Écriture dans les registres timer
 void timer_write(Timer* timer, u16 address, u8 value) {
+    timer_sync(timer);
+
     switch (address) {
-        case DIV_REG:
-            // DIV se remet à 0 quand on écrit dedans
-            timer->div = 0;
-            timer->div_cycles = 0;
+        case DIV_REG: {
+            // Remise à zéro du compteur: un bit choisi à 1 tombe (incrément parasite)
+            bool signal = timer_signal(timer->counter, timer->tac);
+            timer->counter = 0;
+            if (signal && !timer->reloading) timer_increment(timer);
             break;
-            
+        }
+
         case TIMA_REG:
+            // Écrire pendant le délai annule le rechargement et l'IRQ
             timer->tima = value;
+            timer->reloading = false;
             break;
-            
+
         case TMA_REG:
             timer->tma = value;
             break;
-            
-        case TAC_REG:
+
+        case TAC_REG: {
+            // Changer de bit ou désactiver peut faire tomber la sortie du multiplexeur
+            bool before = timer_signal(timer->counter, timer->tac);
             timer->tac = value;
-            timer->tima_period = timer_get_tima_period(value);
+            bool after = timer_signal(timer->counter, timer->tac);
+            if (before && !after && !timer->reloading) timer_increment(timer);
             break;
+        }
     }
+
+    timer_schedule(timer);
 }
 
-// Lecture des registres timer
+// Lecture des registres timer (calculés à la demande)
 u8 timer_read(Timer* timer, u16 address) {
     switch (address) {
-        case DIV_REG:  return timer->div;
-        case TIMA_REG: return timer->tima;
+        case DIV_REG:
+            timer_sync(timer);
+            return (u8)(timer->counter >> 8);
+        case TIMA_REG:
+            timer_sync(timer);
+            return timer->tima;
         case TMA_REG:  return timer->tma;
         case TAC_REG:  return timer->tac;
         default:       return 0xFF;
@@ -98,13 +212,9 @@ u8 timer_get_interrupts(Timer* timer) {
 // Calcul de la période TIMA
 u32 timer_get_tima_period(u8 tac) {
     if (!(tac & 0x04)) return 0;  // Timer disabled
-    
-    u8 clock_select = tac & 0x03;
-    switch (clock_select) {
-        case 0: return 1024;  // 4096 Hz
-        case 1: return 16;    // 262144 Hz
-        case 2: return 64;    // 65536 Hz
-        case 3: return 256;   // 16384 Hz
-        default: return 0;
-    }
+    return (u32)TIMA_BITS[tac & 0x03] << 1;
+}
+
+u16 timer_get_tima_bit(u8 tac) {
+    return TIMA_BITS[tac & 0x03];
 }
@@ -2,29 +2,53 @@
 #define TIMER_H
 
 #include "common.h"
+#include "scheduler.h"
 
-// Structure des timers
+// Délai entre le débordement de TIMA et le rechargement TMA + IRQ (1 M-cycle):
+// pendant ce délai TIMA vaut 0x00 et une écriture dans TIMA annule le rechargement
+#define TIMER_RELOAD_DELAY 4
+
+// Structure des timers: un seul compteur interne 16 bits (DIV = bits 15-8).
+// TIMA s'incrémente sur chaque front descendant du bit choisi par TAC (ET
+// l'activation), ce qui reproduit les incréments parasites des écritures
+// DIV/TAC. Rien n'est calculé entre deux accès: l'état est rattrapé à la
+// demande sur l'horloge, et le débordement est un événement daté.
 typedef struct {
-    u8 div;   // Divider register (0xFF04)
-    u8 tima;  // Timer counter (0xFF05)
-    u8 tma;   // Timer modulo (0xFF06)
-    u8 tac;   // Timer control (0xFF07)
-    
-    u32 div_cycles;   // Compteur pour DIV
-    u32 tima_cycles;  // Compteur pour TIMA
-    u32 tima_period;  // Période actuelle de TIMA
+    u16 counter;  // Compteur interne à synced_cycles
+    u8 tima;      // Timer counter (0xFF05)
+    u8 tma;       // Timer modulo (0xFF06)
+    u8 tac;       // Timer control (0xFF07)
+
+    bool reloading;          // TIMA a débordé, rechargement à reload_at
+    u64 reload_at;
     bool interrupt_pending;  // Interruption timer en attente
+
+    // Horloge rattrapée (horloge maître, ou local_cycles avancée par timer_tick)
+    const u64* clock;
+    u64 local_cycles;
+    u64 synced_cycles;
+
+    // Débordement programmé (optionnel)
+    Scheduler* scheduler;
+    int overflow_event;
 } Timer;
 
 // Fonctions timer
 void timer_init(Timer* timer);
 void timer_reset(Timer* timer);
-void timer_tick(Timer* timer, u8 cycles);
+void timer_tick(Timer* timer, u8 cycles);  // Horloge locale uniquement
 void timer_write(Timer* timer, u16 address, u8 value);
 u8 timer_read(Timer* timer, u16 address);
 u8 timer_get_interrupts(Timer* timer);  // Récupère les interruptions timer
 
-// Calcul de la période TIMA
+// Horloge maître (timer_tick devient inutile) et événement de débordement
+void timer_set_clock(Timer* timer, const u64* clock);
+bool timer_set_scheduler(Timer* timer, Scheduler* scheduler);
+void timer_sync(Timer* timer);
+
+// Calcul de la période TIMA (0 si désactivé)
 u32 timer_get_tima_period(u8 tac);
+// Bit du compteur interne observé par TIMA (9/3/5/7 selon TAC)
+u16 timer_get_tima_bit(u8 tac);
 
 #endif // TIMER_H
@@ -0,0 +1,68 @@
+#include "video.h"
+
+typedef struct {
+    const char* name;
+    void (*bind)(VideoBackend* vb);
+} VideoBackendEntry;
+
+static const VideoBackendEntry VIDEO_BACKENDS[] = {
+    {"null", video_null_bind},
+    {"shm", video_shm_bind},
+#ifdef _WIN32
+    {"win32", video_win32_bind},
+#endif
+    {NULL, NULL}
+};
+
+const char* video_backend_default(bool headless) {
+#ifdef _WIN32
+    return headless ? "null" : "win32";
+#else
+    (void)headless;
+    return "null";
+#endif
+}
+
+bool video_backend_open(VideoBackend* vb, const char* name, const char* target, ScalerMode scale) {
+    memset(vb, 0, sizeof(VideoBackend));
+
+    for (int i = 0; VIDEO_BACKENDS[i].name != NULL; i++) {
+        if (strcmp(VIDEO_BACKENDS[i].name, name) == 0) {
+            VIDEO_BACKENDS[i].bind(vb);
+            vb->scale = scale;
+            if (vb->init && !vb->init(vb, target)) {
+                printf("Erreur: initialisation du backend vidéo %s impossible\n", name);
+                memset(vb, 0, sizeof(VideoBackend));
+                return false;
+            }
+            printf("Backend vidéo: %s\n", vb->name);
+            return true;
+        }
+    }
+
+    printf("Erreur: backend vidéo inconnu: %s\n", name);
+    return false;
+}
+
+bool video_backend_renders(const VideoBackend* vb) {
+    return vb->present != NULL;
+}
+
+void video_backend_present(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                           const VideoFrameInfo* info) {
+    if (vb->present) {
+        vb->present(vb, framebuffer, palette, info);
+        vb->frames++;
+    }
+}
+
+bool video_backend_poll(VideoBackend* vb) {
+    return vb->poll ? vb->poll(vb) : true;
+}
+
+void video_backend_close(VideoBackend* vb) {
+    if (vb->cleanup) {
+        vb->cleanup(vb);
+    }
+    memset(vb, 0, sizeof(VideoBackend));
+}
@@ -0,0 +1,52 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include "common.h"
+#include "framebuffer.h"
+#include "scaler.h"
+
+// Backend de présentation indépendant de la plateforme.
+// Le cœur ne voit que cette interface; chaque implémentation remplit
+// les pointeurs de fonctions dans son *_bind.
+typedef struct VideoBackend VideoBackend;
+
+// Contexte d'une frame présentée (alignement frames/actions)
+typedef struct {
+    u32 frame;   // Numéro de frame PPU (depuis 0)
+    u64 cycles;  // Cycles émulés
+    u8 input;    // Boutons enfoncés (joypad_pressed)
+} VideoFrameInfo;
+
+struct VideoBackend {
+    const char* name;
+    bool interactive;  // Fenêtre: l'émulation tourne jusqu'à sa fermeture
+
+    bool (*init)(VideoBackend* vb, const char* target);
+    void (*present)(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                    const VideoFrameInfo* info);
+    bool (*poll)(VideoBackend* vb);  // Traite les événements; false = fermeture demandée
+    void (*cleanup)(VideoBackend* vb);
+
+    ScalerMode scale;  // Mise à l'échelle demandée (backends à fenêtre)
+    void* state;       // Données propres au backend
+    u32 frames;        // Frames présentées
+};
+
+// Implémentations
+void video_null_bind(VideoBackend* vb);   // Aucune sortie (headless)
+void video_shm_bind(VideoBackend* vb);    // Anneau de frames en mémoire partagée (POSIX)
+#ifdef _WIN32
+void video_win32_bind(VideoBackend* vb);  // Fenêtre GDI
+#endif
+
+// Sélection par nom ("null", "shm", "win32") puis initialisation
+bool video_backend_open(VideoBackend* vb, const char* name, const char* target, ScalerMode scale);
+const char* video_backend_default(bool headless);
+bool video_backend_renders(const VideoBackend* vb);  // false pour le backend null
+
+void video_backend_present(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                           const VideoFrameInfo* info);
+bool video_backend_poll(VideoBackend* vb);
+void video_backend_close(VideoBackend* vb);
+
+#endif // VIDEO_H
@@ -0,0 +1,7 @@
+#include "video.h"
+
+// Backend sans sortie: aucune présentation, aucun événement
+void video_null_bind(VideoBackend* vb) {
+    vb->name = "null";
+    vb->interactive = false;
+}
@@ -0,0 +1,183 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "video.h"
+#include "video_shm.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef struct {
+    char name[64];
+    int fd;
+    u8* base;
+} VideoShmState;
+
+static bool video_shm_init(VideoBackend* vb, const char* target) {
+    VideoShmState* st = calloc(1, sizeof(VideoShmState));
+    if (!st) return false;
+    snprintf(st->name, sizeof(st->name), "%s", target ? target : VIDEO_SHM_DEFAULT);
+
+    st->fd = shm_open(st->name, O_CREAT | O_RDWR, 0644);
+    if (st->fd < 0) {
+        printf("Erreur: shm_open(%s) a échoué\n", st->name);
+        free(st);
+        return false;
+    }
+    if (ftruncate(st->fd, (off_t)VIDEO_SHM_SIZE) != 0) {
+        printf("Erreur: dimensionnement de %s impossible\n", st->name);
+        close(st->fd);
+        shm_unlink(st->name);
+        free(st);
+        return false;
+    }
+    st->base = mmap(NULL, VIDEO_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, st->fd, 0);
+    if (st->base == MAP_FAILED) {
+        printf("Erreur: mmap de %s impossible\n", st->name);
+        close(st->fd);
+        shm_unlink(st->name);
+        free(st);
+        return false;
+    }
+
+    VideoShmHeader* header = (VideoShmHeader*)st->base;
+    memset(st->base, 0, VIDEO_SHM_SIZE);
+    header->version = VIDEO_SHM_VERSION;
+    header->width = GB_WIDTH;
+    header->height = GB_HEIGHT;
+    header->format = VIDEO_SHM_FORMAT_INDEXED;
+    header->slot_count = VIDEO_SHM_SLOTS;
+    header->slot_size = sizeof(VideoShmSlot);
+    __atomic_store_n(&header->magic, VIDEO_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    vb->state = st;
+    printf("Anneau de frames partagé: %s (%d slots, %u octets)\n",
+           st->name, VIDEO_SHM_SLOTS, (u32)VIDEO_SHM_SIZE);
+    return true;
+}
+
+// Publication dans le slot suivant de l'anneau; jamais bloquant
+static void video_shm_present(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                              const VideoFrameInfo* info) {
+    VideoShmState* st = (VideoShmState*)vb->state;
+    VideoShmHeader* header = (VideoShmHeader*)st->base;
+    VideoShmSlot* slots = (VideoShmSlot*)(header + 1);
+    u64 index = header->published;
+    VideoShmSlot* slot = &slots[index % VIDEO_SHM_SLOTS];
+
+    // seq impair pendant l'écriture
+    u32 seq = slot->info.seq;
+    __atomic_store_n(&slot->info.seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->info.index = index;
+    slot->info.frame = info ? info->frame : vb->frames;
+    slot->info.cycles = info ? info->cycles : 0;
+    slot->info.palette = *palette;
+    slot->info.input = info ? info->input : 0;
+    memcpy(slot->pixels, framebuffer, FB_PIXELS);
+    __atomic_store_n(&slot->info.seq, seq + 2, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&header->published, index + 1, __ATOMIC_RELEASE);
+}
+
+static void video_shm_cleanup(VideoBackend* vb) {
+    VideoShmState* st = (VideoShmState*)vb->state;
+    if (!st) return;
+    munmap(st->base, VIDEO_SHM_SIZE);
+    close(st->fd);
+    shm_unlink(st->name);
+    free(st);
+    vb->state = NULL;
+}
+
+bool video_shm_attach(VideoShmReader* reader, const char* name) {
+    reader->header = NULL;
+    reader->fd = shm_open(name ? name : VIDEO_SHM_DEFAULT, O_RDONLY, 0);
+    if (reader->fd < 0) {
+        return false;
+    }
+    void* base = mmap(NULL, VIDEO_SHM_SIZE, PROT_READ, MAP_SHARED, reader->fd, 0);
+    if (base == MAP_FAILED) {
+        close(reader->fd);
+        return false;
+    }
+    reader->header = (const VideoShmHeader*)base;
+    if (__atomic_load_n(&reader->header->magic, __ATOMIC_ACQUIRE) != VIDEO_SHM_MAGIC ||
+        reader->header->version != VIDEO_SHM_VERSION) {
+        video_shm_detach(reader);
+        return false;
+    }
+    return true;
+}
+
+void video_shm_detach(VideoShmReader* reader) {
+    if (reader->header) {
+        munmap((void*)reader->header, VIDEO_SHM_SIZE);
+        close(reader->fd);
+        reader->header = NULL;
+    }
+}
+
+#else
+
+// Pas de shm_open sous Windows: le backend refuse de s'initialiser
+static bool video_shm_init(VideoBackend* vb, const char* target) {
+    (void)vb; (void)target;
+    printf("Erreur: backend shm indisponible sur cette plateforme\n");
+    return false;
+}
+
+static void video_shm_present(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                              const VideoFrameInfo* info) {
+    (void)vb; (void)framebuffer; (void)palette; (void)info;
+}
+
+static void video_shm_cleanup(VideoBackend* vb) {
+    (void)vb;
+}
+
+bool video_shm_attach(VideoShmReader* reader, const char* name) {
+    (void)name;
+    reader->header = NULL;
+    return false;
+}
+
+void video_shm_detach(VideoShmReader* reader) {
+    reader->header = NULL;
+}
+
+#endif
+
+u64 video_shm_published(const VideoShmReader* reader) {
+    return __atomic_load_n(&reader->header->published, __ATOMIC_ACQUIRE);
+}
+
+const VideoShmSlot* video_shm_acquire(const VideoShmReader* reader, u64 index, u32* seq) {
+    if (index >= video_shm_published(reader)) {
+        return NULL;
+    }
+    const VideoShmSlot* slots = (const VideoShmSlot*)(reader->header + 1);
+    const VideoShmSlot* slot = &slots[index % reader->header->slot_count];
+    *seq = __atomic_load_n(&slot->info.seq, __ATOMIC_ACQUIRE);
+    if ((*seq & 1) || slot->info.index != index) {
+        return NULL;
+    }
+    return slot;
+}
+
+bool video_shm_slot_valid(const VideoShmSlot* slot, u32 seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->info.seq, __ATOMIC_RELAXED) == seq;
+}
+
+void video_shm_bind(VideoBackend* vb) {
+    vb->name = "shm";
+    vb->interactive = false;
+    vb->init = video_shm_init;
+    vb->present = video_shm_present;
+    vb->cleanup = video_shm_cleanup;
+}
@@ -0,0 +1,71 @@
+#ifndef VIDEO_SHM_H
+#define VIDEO_SHM_H
+
+#include "common.h"
+#include "framebuffer.h"
+
+// Disposition du segment partagé du backend "shm": un en-tête suivi d'un
+// anneau de VIDEO_SHM_SLOTS frames indexées (teintes 0-3, palette dans
+// chaque slot). Les lecteurs mappent le segment et lisent les pixels en
+// place, sans verrou:
+//   1. n = published; slot = (n - 1) % slot_count
+//   2. s = seq du slot (recommencer si impair)
+//   3. consommer frame/cycles/palette/input/pixels
+//   4. si seq != s, le slot a été réécrit pendant la lecture: recommencer
+// Un lecteur qui prend plus de VIDEO_SHM_SLOTS frames de retard perd les
+// plus anciennes; l'émulateur n'attend jamais.
+#define VIDEO_SHM_MAGIC     0x4D484243  // "CBHM"
+#define VIDEO_SHM_VERSION   3
+#define VIDEO_SHM_DEFAULT   "/cameboy-lcd"
+#define VIDEO_SHM_SLOTS     8
+
+// Format des pixels d'un slot
+#define VIDEO_SHM_FORMAT_INDEXED 0  // 1 octet par pixel, teinte 0-3
+
+// En-tête d'un slot, une ligne de cache
+typedef struct {
+    u32 seq;            // Impair pendant l'écriture
+    u32 frame;          // Numéro de frame PPU (depuis 0)
+    u64 index;          // Numéro de publication (depuis 0)
+    u64 cycles;         // Cycles émulés à la présentation
+    FbPalette palette;  // Couleurs des teintes 0-3 (0xRRGGBB) de cette frame
+    u8 input;           // Boutons enfoncés (joypad_pressed)
+    u8 reserved[23];
+} VideoShmSlotHeader;
+
+typedef struct {
+    VideoShmSlotHeader info;
+    u8 pixels[FB_PIXELS];
+} VideoShmSlot;
+
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 width;
+    u32 height;
+    u32 format;         // VIDEO_SHM_FORMAT_*
+    u32 slot_count;
+    u32 slot_size;      // sizeof(VideoShmSlot)
+    u32 reserved0;
+    u64 published;      // Frames publiées (slot suivant = published % slot_count)
+    u8 reserved1[24];
+} VideoShmHeader;
+
+#define VIDEO_SHM_SIZE (sizeof(VideoShmHeader) + VIDEO_SHM_SLOTS * sizeof(VideoShmSlot))
+
+// Côté lecteur (processus consommateur écrit en C)
+typedef struct {
+    int fd;
+    const VideoShmHeader* header;
+} VideoShmReader;
+
+bool video_shm_attach(VideoShmReader* reader, const char* name);
+void video_shm_detach(VideoShmReader* reader);
+u64 video_shm_published(const VideoShmReader* reader);
+// Slot de la publication n° index (depuis 0), NULL s'il est en cours
+// d'écriture ou déjà réutilisé.
+// Les pixels sont lus en place; valider ensuite avec video_shm_slot_valid.
+const VideoShmSlot* video_shm_acquire(const VideoShmReader* reader, u64 index, u32* seq);
+bool video_shm_slot_valid(const VideoShmSlot* slot, u32 seq);
+
+#endif // VIDEO_SHM_H
@@ -0,0 +1,126 @@
+#include "video_sink.h"
+
+#define PPM_HEADER_MAX 32
+static const char Y4M_FRAME_HEADER[] = "FRAME\n";
+
+VideoSinkFormat video_sink_format_from_path(const char* path) {
+    size_t len = strlen(path);
+    if (len >= 4 && strcmp(path + len - 4, ".y4m") == 0) {
+        return VIDEO_SINK_Y4M;
+    }
+    return VIDEO_SINK_PPM;
+}
+
+// Couleurs de la palette en YCbCr BT.601 (plage limitée)
+static void video_sink_build_yuv(VideoSink* sink) {
+    for (int i = 0; i < 4; i++) {
+        int r = (sink->palette->rgb[i] >> 16) & 0xFF;
+        int g = (sink->palette->rgb[i] >> 8) & 0xFF;
+        int b = sink->palette->rgb[i] & 0xFF;
+        sink->yuv_lut[0][i] = (u8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        sink->yuv_lut[1][i] = (u8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        sink->yuv_lut[2][i] = (u8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+bool video_sink_open(VideoSink* sink, const char* path, VideoSinkFormat format,
+                     u32 interval, const FbPalette* palette, ScalerMode scale, bool threaded) {
+    memset(sink, 0, sizeof(VideoSink));
+    sink->format = format;
+    sink->interval = interval ? interval : 1;
+    sink->palette = palette ? palette : &FB_PALETTE_GRAY;
+
+    if (!scaler_init(&sink->scaler, GB_WIDTH, GB_HEIGHT, scale)) {
+        printf("Erreur: mise à l'échelle x%u non supportée\n", scale.factor);
+        return false;
+    }
+    sink->width = sink->scaler.width;
+    sink->height = sink->scaler.height;
+    if (scale.factor > 1) {
+        sink->scaled = malloc((size_t)sink->width * sink->height);
+        if (!sink->scaled) {
+            scaler_cleanup(&sink->scaler);
+            return false;
+        }
+    }
+    size_t pixels = (size_t)sink->width * sink->height;
+
+    sink->file = fopen(path, "wb");
+    if (!sink->file) {
+        printf("Erreur: impossible d'ouvrir %s pour écriture\n", path);
+        free(sink->scaled);
+        scaler_cleanup(&sink->scaler);
+        return false;
+    }
+
+    if (format == VIDEO_SINK_Y4M) {
+        video_sink_build_yuv(sink);
+        fprintf(sink->file, "YUV4MPEG2 W%u H%u F%d:%d Ip A1:1 C444\n",
+                sink->width, sink->height, VIDEO_SINK_FPS_NUM, VIDEO_SINK_FPS_DEN);
+        sink->frame_size = sizeof(Y4M_FRAME_HEADER) - 1 + pixels * 3;
+    } else {
+        sink->frame_size = PPM_HEADER_MAX + pixels * 3;
+    }
+
+    if (!async_writer_open(&sink->writer, sink->file, sink->frame_size, threaded)) {
+        fclose(sink->file);
+        sink->file = NULL;
+        free(sink->scaled);
+        scaler_cleanup(&sink->scaler);
+        return false;
+    }
+
+    printf("Flux vidéo: %s (%s %ux%u, 1 frame sur %u)\n", path,
+           format == VIDEO_SINK_Y4M ? "y4m" : "ppm", sink->width, sink->height, sink->interval);
+    return true;
+}
+
+bool video_sink_wants_frame(const VideoSink* sink, u32 frame) {
+    return sink->file != NULL && (frame % sink->interval) == 0;
+}
+
+void video_sink_write_frame(VideoSink* sink, const u8* indexed) {
+    if (!sink->file) return;
+
+    // Mise à l'échelle sur les teintes, puis une seule conversion
+    if (sink->scaled) {
+        scaler_run(&sink->scaler, indexed, sink->scaled, sink->width);
+        indexed = sink->scaled;
+    }
+    u32 pixels = sink->width * sink->height;
+
+    u8* out = async_writer_acquire(&sink->writer);
+    size_t len;
+    if (sink->format == VIDEO_SINK_Y4M) {
+        // En-tête de frame puis plans Y, U, V complets
+        size_t header = sizeof(Y4M_FRAME_HEADER) - 1;
+        memcpy(out, Y4M_FRAME_HEADER, header);
+        fb_map_u8_n(indexed, out + header, pixels, sink->yuv_lut[0]);
+        fb_map_u8_n(indexed, out + header + pixels, pixels, sink->yuv_lut[1]);
+        fb_map_u8_n(indexed, out + header + (size_t)pixels * 2, pixels, sink->yuv_lut[2]);
+        len = header + (size_t)pixels * 3;
+    } else {
+        int header = snprintf((char*)out, PPM_HEADER_MAX, "P6\n%u %u\n255\n", sink->width, sink->height);
+        fb_convert_n(indexed, out + header, pixels, FB_FORMAT_RGB24, sink->palette);
+        len = (size_t)header + (size_t)pixels * 3;
+    }
+    async_writer_submit(&sink->writer, len);
+    sink->frames++;
+}
+
+bool video_sink_close(VideoSink* sink) {
+    if (!sink->file) return true;
+
+    bool ok = async_writer_close(&sink->writer);
+    if (fclose(sink->file) != 0) {
+        ok = false;
+    }
+    sink->file = NULL;
+    free(sink->scaled);
+    sink->scaled = NULL;
+    scaler_cleanup(&sink->scaler);
+
+    printf("Flux vidéo fermé: %u frames, %u attentes d'écriture%s\n",
+           sink->frames, sink->writer.stalls, ok ? "" : " (erreur d'écriture)");
+    return ok;
+}
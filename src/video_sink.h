@@ -0,0 +1,43 @@
+#ifndef VIDEO_SINK_H
+#define VIDEO_SINK_H
+
+#include "common.h"
+#include "framebuffer.h"
+#include "async_writer.h"
+#include "scaler.h"
+
+// Flux vidéo brut des frames rendues, vers un fichier ou un tube nommé
+// (ex. entrée d'un encodeur externe). Chaque frame est préparée dans un
+// seul tampon puis écrite en un bloc par le thread d'écriture.
+typedef enum {
+    VIDEO_SINK_PPM = 0,   // Images P6 concaténées (image2pipe)
+    VIDEO_SINK_Y4M        // YUV4MPEG2 4:4:4
+} VideoSinkFormat;
+
+// Cadence native du LCD: 4194304 / 70224 ≈ 59.73 Hz
+#define VIDEO_SINK_FPS_NUM 4194304
+#define VIDEO_SINK_FPS_DEN 70224
+
+typedef struct {
+    FILE* file;
+    VideoSinkFormat format;
+    u32 interval;       // Une frame sur N
+    u32 frames;         // Frames écrites
+    size_t frame_size;  // Octets par frame (en-tête de frame compris)
+    u8 yuv_lut[3][4];   // Teinte -> Y, U, V (Y4M)
+    const FbPalette* palette;
+    Scaler scaler;      // Mise à l'échelle avant conversion (facteur 1 = natif)
+    u8* scaled;         // Surface indexée mise à l'échelle
+    u32 width;          // Dimensions des frames écrites
+    u32 height;
+    AsyncWriter writer;
+} VideoSink;
+
+VideoSinkFormat video_sink_format_from_path(const char* path);
+bool video_sink_open(VideoSink* sink, const char* path, VideoSinkFormat format,
+                     u32 interval, const FbPalette* palette, ScalerMode scale, bool threaded);
+bool video_sink_wants_frame(const VideoSink* sink, u32 frame);
+void video_sink_write_frame(VideoSink* sink, const u8* indexed);
+bool video_sink_close(VideoSink* sink);
+
+#endif // VIDEO_SINK_H
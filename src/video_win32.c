@@ -0,0 +1,48 @@
+#include "video.h"
+#include "graphics_win32.h"
+
+// Adaptateur VideoBackend pour la fenêtre GDI de graphics_win32
+static bool video_win32_init(VideoBackend* vb, const char* target) {
+    (void)target;
+    GraphicsWin32* gfx = calloc(1, sizeof(GraphicsWin32));
+    if (!gfx) return false;
+    if (!graphics_win32_init(gfx, vb->scale)) {
+        free(gfx);
+        return false;
+    }
+    graphics_win32_show(gfx);
+    vb->state = gfx;
+    return true;
+}
+
+static void video_win32_present(VideoBackend* vb, const u8* framebuffer, const FbPalette* palette,
+                                const VideoFrameInfo* info) {
+    (void)info;
+    GraphicsWin32* gfx = (GraphicsWin32*)vb->state;
+    graphics_win32_update(gfx, framebuffer, palette);
+    graphics_win32_present(gfx);
+}
+
+static bool video_win32_poll(VideoBackend* vb) {
+    GraphicsWin32* gfx = (GraphicsWin32*)vb->state;
+    bool running = true;
+    graphics_win32_handle_events(gfx, &running);
+    return running && gfx->running;
+}
+
+static void video_win32_cleanup(VideoBackend* vb) {
+    GraphicsWin32* gfx = (GraphicsWin32*)vb->state;
+    if (!gfx) return;
+    graphics_win32_cleanup(gfx);
+    free(gfx);
+    vb->state = NULL;
+}
+
+void video_win32_bind(VideoBackend* vb) {
+    vb->name = "win32";
+    vb->interactive = true;
+    vb->init = video_win32_init;
+    vb->present = video_win32_present;
+    vb->poll = video_win32_poll;
+    vb->cleanup = video_win32_cleanup;
+}
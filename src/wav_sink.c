@@ -0,0 +1,102 @@
+#include "wav_sink.h"
+
+static void wav_put_u16(u8* p, u16 v) {
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+}
+
+static void wav_put_u32(u8* p, u32 v) {
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+    p[2] = (u8)(v >> 16);
+    p[3] = (u8)(v >> 24);
+}
+
+// En-tête RIFF/WAVE canonique (fmt PCM puis data), champs petit-boutistes
+static void wav_build_header(u8* h, u32 sample_rate, u32 channels, u32 data_bytes) {
+    memcpy(h, "RIFF", 4);
+    wav_put_u32(h + 4, 36 + data_bytes);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    wav_put_u32(h + 16, 16);
+    wav_put_u16(h + 20, 1);                               // PCM
+    wav_put_u16(h + 22, (u16)channels);
+    wav_put_u32(h + 24, sample_rate);
+    wav_put_u32(h + 28, sample_rate * channels * 2);      // Octets par seconde
+    wav_put_u16(h + 32, (u16)(channels * 2));             // Octets par frame
+    wav_put_u16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    wav_put_u32(h + 40, data_bytes);
+}
+
+bool wav_sink_open(WavSink* sink, const char* path, u32 sample_rate, u32 channels, bool threaded) {
+    memset(sink, 0, sizeof(WavSink));
+    sink->channels = channels;
+    sink->sample_rate = sample_rate;
+
+    sink->file = fopen(path, "wb");
+    if (!sink->file) {
+        printf("Erreur: impossible d'ouvrir %s pour écriture\n", path);
+        return false;
+    }
+
+    // En-tête provisoire (tailles nulles), réécrit à la fermeture
+    u8 header[WAV_HEADER_SIZE];
+    wav_build_header(header, sample_rate, channels, 0);
+    if (fwrite(header, 1, sizeof(header), sink->file) != sizeof(header) ||
+        !async_writer_open(&sink->writer, sink->file, WAV_SINK_BLOCK, threaded)) {
+        fclose(sink->file);
+        sink->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+void wav_sink_write(WavSink* sink, const s16* samples, u32 frames) {
+    if (!sink->file) return;
+
+    // PCM petit-boutiste: les échantillons hôte sont copiés tels quels (x86)
+    size_t bytes = (size_t)frames * sink->channels * sizeof(s16);
+    const u8* src = (const u8*)samples;
+    while (bytes > 0) {
+        if (!sink->block) {
+            sink->block = async_writer_acquire(&sink->writer);
+            sink->block_len = 0;
+        }
+        size_t n = WAV_SINK_BLOCK - sink->block_len;
+        if (n > bytes) n = bytes;
+        memcpy(sink->block + sink->block_len, src, n);
+        sink->block_len += n;
+        sink->data_bytes += n;
+        src += n;
+        bytes -= n;
+
+        if (sink->block_len == WAV_SINK_BLOCK) {
+            async_writer_submit(&sink->writer, sink->block_len);
+            sink->block = NULL;
+        }
+    }
+}
+
+bool wav_sink_close(WavSink* sink) {
+    if (!sink->file) return true;
+
+    if (sink->block && sink->block_len > 0) {
+        async_writer_submit(&sink->writer, sink->block_len);
+    }
+    sink->block = NULL;
+    bool ok = async_writer_close(&sink->writer);
+
+    // Tailles définitives (plafonnées au maximum RIFF 32 bits)
+    u32 data_bytes = sink->data_bytes > 0xFFFFFFFFu - 36 ? 0xFFFFFFFFu - 36 : (u32)sink->data_bytes;
+    u8 header[WAV_HEADER_SIZE];
+    wav_build_header(header, sink->sample_rate, sink->channels, data_bytes);
+    if (fseek(sink->file, 0, SEEK_SET) != 0 ||
+        fwrite(header, 1, sizeof(header), sink->file) != sizeof(header)) {
+        ok = false;
+    }
+    if (fclose(sink->file) != 0) {
+        ok = false;
+    }
+    sink->file = NULL;
+    return ok;
+}
@@ -0,0 +1,28 @@
+#ifndef WAV_SINK_H
+#define WAV_SINK_H
+
+#include "common.h"
+#include "async_writer.h"
+
+// Capture audio en WAV PCM 16 bits. Les échantillons s'accumulent dans de
+// grands blocs vidés par le thread d'écriture; l'en-tête, écrit vide à
+// l'ouverture, reçoit les tailles réelles à la fermeture.
+#define WAV_SINK_BLOCK (128 * 1024)   // Octets par écriture
+#define WAV_HEADER_SIZE 44
+
+typedef struct {
+    FILE* file;
+    u32 channels;        // 1 (piste par canal) ou 2 (mixage stéréo)
+    u32 sample_rate;
+    u64 data_bytes;      // Octets PCM écrits
+    u8* block;           // Bloc en cours de remplissage (case de l'écrivain)
+    size_t block_len;
+    AsyncWriter writer;
+} WavSink;
+
+bool wav_sink_open(WavSink* sink, const char* path, u32 sample_rate, u32 channels, bool threaded);
+// frames frames de channels échantillons entrelacés
+void wav_sink_write(WavSink* sink, const s16* samples, u32 frames);
+bool wav_sink_close(WavSink* sink);
+
+#endif // WAV_SINK_H
@@ -38,7 +38,10 @@ echo Compiling headless emulator_simple...
 set CFLAGS=-Wall -Wextra -std=c99 -O2 -g -Isrc
 set LDFLAGS=-lgdi32 -luser32 -lkernel32
 
-gcc %CFLAGS% src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\ppu.c src\joypad.c src\interrupt.c src\apu.c src\graphics_win32.c src\emulator_simple.c -o "%SIMP%" %LDFLAGS% 2>> "%LOGS_DIR%\test_build.log"
+REM Same source list as the Makefile and build.sh
+set SOURCES=src\cpu.c src\cpu_tables.c src\cpu_tables_cb.c src\mmu.c src\timer.c src\serial.c src\link.c src\ppu.c src\framebuffer.c src\golden.c src\thread.c src\async_writer.c src\video_sink.c src\scaler.c src\render_thread.c src\joypad.c src\interrupt.c src\apu.c src\blip.c src\scheduler.c src\audio_ring.c src\resampler.c src\audio.c src\wav_sink.c src\video.c src\video_null.c src\video_shm.c src\video_win32.c src\graphics_win32.c src\emulator_simple.c
+
+gcc %CFLAGS% %SOURCES% -o "%SIMP%" %LDFLAGS% 2>> "%LOGS_DIR%\test_build.log"
 if errorlevel 1 (
   echo ERREUR: compilation emulator_simple
   exit /b 1
@@ -75,10 +78,9 @@ for %%R in (tests\rom\*.gb) do (
   set ROM=%%R
   set NAME=%%~nR
   echo Running ROM: !ROM!
-  "%SIMP%" "!ROM!" %CYCLES% --headless --dump-ppm "%ROM_DIR%\!NAME!.ppm" > "%ROM_DIR%\!NAME!.log" 2>&1
-  findstr /C:"SERIAL:" "%ROM_DIR%\!NAME!.log" > "%ROM_DIR%\!NAME!_serial.txt"
-  rem Check for PASS directly in main log (raw chars written)
-  findstr /C:"PASS" "%ROM_DIR%\!NAME!.log" >nul
+  "%SIMP%" "!ROM!" %CYCLES% --headless --dump-ppm "%ROM_DIR%\!NAME!.ppm" --serial-out "%ROM_DIR%\!NAME!_serial.txt" > "%ROM_DIR%\!NAME!.log" 2>&1
+  rem Check for PASS in the serial output (raw bytes)
+  findstr /C:"PASS" "%ROM_DIR%\!NAME!_serial.txt" >nul
   if !errorlevel! equ 0 (
     echo PASS !NAME!
     echo PASS !NAME! >> "%LOGS_DIR%\rom_test_results.log"
@@ -48,7 +48,7 @@ static void write_header(uint8_t *rom, const char *title) {
 
 static void write_program_pass(uint8_t *rom) {
     // Code à 0x0150 : écrire "PASS\n" sur SB/SC (FF01/FF02)
-    // Routine simple: pour chaque octet dans la table, ldh (SB),a ; ld a,$81 ; ldh (SC),a ; loop attend SC bit7=0 ; suivant
+    // Routine simple: pour chaque octet dans la table, ldh (SB),a ; ld a,$81 ; ldh (SC),a ; attend SC bit7=0 ; suivant
     // Table à 0x0200
     const char *msg = "PASS\n";
     memcpy(&rom[0x0200], msg, strlen(msg));
@@ -68,8 +68,14 @@ static void write_program_pass(uint8_t *rom) {
     *c++ = 0xE0; *c++ = 0x01;
     // LD A,0x81 (start + internal clock)
     *c++ = 0x3E; *c++ = 0x81;
-    // LDH (FF02),A (transfert immédiat simulé par l'émulateur)
+    // LDH (FF02),A
     *c++ = 0xE0; *c++ = 0x02;
+    // wait: LDH A,(FF02) ; AND 80h ; JR NZ,wait (le transfert dure 4096 cycles)
+    uint16_t wait = (uint16_t)(p + (c - &rom[p]));
+    *c++ = 0xF0; *c++ = 0x02;
+    *c++ = 0xE6; *c++ = 0x80;
+    int8_t rel_wait = (int8_t)(wait - ((p + (c - &rom[p])) + 2));
+    *c++ = 0x20; *c++ = (uint8_t)rel_wait;
     // INC HL
     *c++ = 0x23;
     // DEC B
@@ -0,0 +1,847 @@
+/**
+ * TESTS UNITAIRES POUR L'APU
+ *
+ * Ce fichier contient des tests unitaires pour valider la synthèse audio:
+ * tampon à bande limitée (BLIP), génération des canaux et mixage.
+ */
+
+#include "../../src/common.h"
+#include "../../src/apu.h"
+#include "../../src/blip.h"
+#include "../../src/scheduler.h"
+#include "../../src/audio_ring.h"
+#include "../../src/resampler.h"
+#include "../../src/wav_sink.h"
+#include "../../src/thread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Prototypes des fonctions de test
+void test_blip_step(void);
+void test_blip_frames(void);
+void test_apu_square_synthesis(void);
+void test_apu_mix(void);
+void test_apu_output_disabled(void);
+void test_apu_lazy_sync(void);
+void test_apu_noise_sequence(void);
+void test_apu_status_without_output(void);
+void test_scheduler_order(void);
+void test_apu_sweep(void);
+void test_apu_channel_blocks(void);
+void test_audio_ring(void);
+void test_audio_ring_threads(void);
+void test_resampler_rates(void);
+void test_resampler_antialias(void);
+void test_resampler_adjust(void);
+void test_wav_sink(void);
+
+// Table des tests APU
+typedef struct {
+    const char* name;
+    void (*test_func)(void);
+} UnitTest;
+
+UnitTest apu_tests[] = {
+    {"BLIP Échelon", test_blip_step},
+    {"BLIP Frames Successives", test_blip_frames},
+    {"APU Synthèse Square", test_apu_square_synthesis},
+    {"APU Mixage NR50/NR51", test_apu_mix},
+    {"APU Sortie Désactivée", test_apu_output_disabled},
+    {"APU Rattrapage Paresseux", test_apu_lazy_sync},
+    {"APU Séquences Noise", test_apu_noise_sequence},
+    {"APU Canaux par Blocs", test_apu_channel_blocks},
+    {"APU Statut NR52 Sans Sortie", test_apu_status_without_output},
+    {"Ordonnanceur Échéances", test_scheduler_order},
+    {"APU Sweep Canal 1", test_apu_sweep},
+    {"Audio File SPSC", test_audio_ring},
+    {"Audio File SPSC Threads", test_audio_ring_threads},
+    {"Rééchantillonneur Taux et Gain", test_resampler_rates},
+    {"Rééchantillonneur Anti-repliement", test_resampler_antialias},
+    {"Rééchantillonneur Ajustement", test_resampler_adjust},
+    {"Capture WAV", test_wav_sink},
+    {NULL, NULL} // Marqueur de fin
+};
+
+/**
+ * FONCTION PRINCIPALE DE TEST
+ */
+int main(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+
+    printf("=== TESTS UNITAIRES APU ===\n\n");
+
+    int passed = 0;
+    int total = 0;
+
+    for (int i = 0; apu_tests[i].name != NULL; i++) {
+        printf("Test %d: %s... ", i + 1, apu_tests[i].name);
+        fflush(stdout);
+
+        // Exécuter le test
+        apu_tests[i].test_func();
+
+        printf("PASS\n");
+        passed++;
+        total++;
+    }
+
+    printf("\n=== RÉSULTATS ===\n");
+    printf("Tests passés: %d/%d\n", passed, total);
+
+    if (passed == total) {
+        printf("✅ TOUS LES TESTS SONT PASSÉS !\n");
+        return 0;
+    } else {
+        printf("❌ CERTAINS TESTS ONT ÉCHOUÉ\n");
+        return 1;
+    }
+}
+
+/**
+ * IMPLEMENTATION DES TESTS
+ */
+
+void test_blip_step(void) {
+    BlipBuffer blip;
+    assert(blip_init(&blip, 1024));
+    blip_set_rates(&blip, GB_FREQ, 44100);
+
+    // Échelon de 1000 au cycle 10000 (~105 échantillons)
+    blip_add_delta(&blip, 10000, 1000);
+    blip_end_frame(&blip, 40000);
+    u32 avail = blip_samples_avail(&blip);
+    assert(avail == (u32)((u64)40000 * 44100 / GB_FREQ));
+
+    s16 out[1024];
+    assert(blip_read_samples(&blip, out, 1024, 1) == avail);
+    assert(blip_samples_avail(&blip) == 0);
+
+    // Silence avant, niveau exact après, dépassement de Gibbs borné
+    for (u32 i = 0; i < 90; i++) {
+        assert(out[i] == 0);
+    }
+    for (u32 i = 120; i < avail; i++) {
+        assert(out[i] == 1000);
+    }
+    for (u32 i = 0; i < avail; i++) {
+        assert(out[i] > -150 && out[i] < 1150);
+    }
+    // Transition à bande limitée: ondulations de part et d'autre du saut,
+    // pas un échelon brut d'un échantillon à l'autre
+    int ripples = 0;
+    for (u32 i = 90; i < 120; i++) {
+        if (out[i] != 0 && out[i] != 1000) ripples++;
+    }
+    assert(ripples >= 4);
+
+    blip_cleanup(&blip);
+}
+
+void test_blip_frames(void) {
+    BlipBuffer blip;
+    assert(blip_init(&blip, 256));
+    blip_set_rates(&blip, GB_FREQ, 48000);
+
+    // Créneau à des instants non alignés sur les échantillons, sur de
+    // nombreuses frames lues une à une: aucune dérive du niveau
+    s16 out[256];
+    s16 last = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        u32 clocks = 7001 + (u32)frame * 13;
+        for (u32 t = 37; t + 500 < clocks; t += 733) {
+            blip_add_delta(&blip, t, 3000);
+            blip_add_delta(&blip, t + 311, -3000);
+        }
+        assert(clocks <= blip_max_frame_clocks(&blip));
+        blip_end_frame(&blip, clocks);
+        u32 n = blip_read_samples(&blip, out, 256, 1);
+        assert(n > 0);
+        last = out[n - 1];
+    }
+
+    // Le noyau encore en attente se vide dans une frame silencieuse
+    blip_end_frame(&blip, 4000);
+    u32 n = blip_read_samples(&blip, out, 256, 1);
+    assert(n > BLIP_WIDTH);
+    assert(out[n - 1] == 0);
+    (void)last;
+
+    blip_cleanup(&blip);
+}
+
+void test_apu_square_synthesis(void) {
+    APU apu;
+    apu_init(&apu);
+    assert(apu_enable_output(&apu, 44100));
+
+    // Canal 2: 50%, volume 15, fréquence 1750 -> 4194304 / (32 * 298) ≈ 439.8 Hz
+    apu_write(&apu, NR50_REG, 0x77);
+    apu_write(&apu, NR51_REG, 0x02);
+    apu_write(&apu, NR21_REG, 0x80);
+    apu_write(&apu, NR22_REG, 0xF0);
+    apu_write(&apu, NR23_REG, 0xD6);
+    apu_write(&apu, NR24_REG, 0x86);
+
+    // 100 ms par pas d'instructions irréguliers
+    static s16 out[44100 / 10 * 2 + 512];
+    u32 frames = 0;
+    u32 cycles = 0;
+    u8 steps[] = {4, 8, 12, 16, 20, 24};
+    for (int i = 0; cycles < GB_FREQ / 10; i++) {
+        u8 c = steps[i % 6];
+        apu_tick(&apu, c);
+        cycles += c;
+        if ((i & 1023) == 0) {
+            frames += apu_read_samples(&apu, out + frames * 2, 256);
+        }
+    }
+    frames += apu_read_samples(&apu, out + frames * 2, 1024);
+    assert(frames >= 4400 && frames <= 4420);
+
+    // Sortie à droite seulement, bipolaire: ±7.5 pas du DAC autour de zéro.
+    // Le passe-haut incline chaque palier (~18% par demi-période à 440 Hz):
+    // les fronts dépassent d'autant le niveau nominal.
+    s16 peak = 0;
+    s16 trough = 0;
+    int crossings = 0;
+    for (u32 i = BLIP_WIDTH; i < frames; i++) {
+        assert(out[i * 2] == 0);
+        if (out[i * 2 + 1] > peak) peak = out[i * 2 + 1];
+        if (out[i * 2 + 1] < trough) trough = out[i * 2 + 1];
+        if (out[(i - 1) * 2 + 1] < 0 && out[i * 2 + 1] >= 0) crossings++;
+    }
+    s16 full = 15 * APU_AMP_SCALE / 2;
+    assert(peak >= full && peak < full * 3 / 2);
+    assert(trough <= -full && trough > -full * 3 / 2);
+    assert(crossings >= 42 && crossings <= 46);
+
+    apu_cleanup(&apu);
+}
+
+void test_apu_mix(void) {
+    APU apu;
+    apu_init(&apu);
+
+    static s16 block[4][1000];
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < 1000; i++) {
+            block[c][i] = (s16)(1000 * (c + 1));
+        }
+    }
+    s16* const channels[4] = {block[0], block[1], block[2], block[3]};
+    static s16 out[2000];
+
+    // Canal 1 à droite, canal 4 à gauche; volume gauche 4/8, droite 8/8
+    // (premier échantillon: passe-haut encore déchargé)
+    apu.nr51 = 0x81;
+    apu.nr50 = 0x37;
+    apu_mix_channels(&apu, channels, out, 4);
+    assert(out[0] == 2000);
+    assert(out[1] == 1000);
+
+    // Tous les canaux des deux côtés, volume gauche 1/8
+    apu.hpf_charge[0] = apu.hpf_charge[1] = 0;
+    apu.nr51 = 0xFF;
+    apu.nr50 = 0x07;
+    apu_mix_channels(&apu, channels, out, 11);
+    assert(out[0] == 10000 / 8);
+    assert(out[1] == 10000);
+
+    // Composante continue retirée: décroissance lente, sans changer de signe
+    assert(out[21] < 10000 && out[21] > 9000);
+    apu_mix_channels(&apu, channels, out, 1000);
+    assert(out[1999] >= 0 && out[1999] < 1000);
+
+    // Blocs vectoriels et échantillons isolés: même résultat
+    for (int i = 0; i < 1000; i++) {
+        block[i % 4][i] = (s16)((i * 7919) % 8000 - 4000);
+    }
+    APU single = apu;
+    static s16 ref[2000];
+    apu_mix_channels(&apu, channels, out, 1000);
+    for (int i = 0; i < 1000; i++) {
+        s16* const one[4] = {block[0] + i, block[1] + i, block[2] + i, block[3] + i};
+        apu_mix_channels(&single, one, ref + i * 2, 1);
+    }
+    assert(memcmp(out, ref, sizeof(ref)) == 0);
+
+    apu_cleanup(&apu);
+}
+
+void test_apu_output_disabled(void) {
+    APU apu;
+    apu_init(&apu);
+
+    apu_write(&apu, NR22_REG, 0xF0);
+    apu_write(&apu, NR24_REG, 0x80);
+    for (int i = 0; i < 100000; i++) {
+        apu_tick(&apu, 4);
+    }
+
+    // Aucun tampon ni delta: seul l'état visible des registres avance
+    assert(!apu.output_enabled);
+    assert(apu.amp[CHANNEL_2] == 0);
+    assert(apu_samples_avail(&apu) == 0);
+    s16 out[2];
+    assert(apu_read_samples(&apu, out, 1) == 0);
+    assert(apu.square2.enabled);
+
+    apu_cleanup(&apu);
+}
+
+void test_apu_lazy_sync(void) {
+    // Référence avancée à chaque instruction, copie rattachée à une horloge
+    APU ticked, lazy;
+    u64 clock = 0;
+    apu_init(&ticked);
+    apu_init(&lazy);
+    apu_set_clock(&lazy, &clock);
+    assert(apu_enable_output(&ticked, 48000));
+    assert(apu_enable_output(&lazy, 48000));
+
+    // Canal 1 de longueur 1 (coupé au premier pas de longueur), canal 2 continu
+    static const u16 regs[] = {NR51_REG, NR11_REG, NR12_REG, NR13_REG, NR14_REG,
+                               NR21_REG, NR22_REG, NR23_REG, NR24_REG};
+    static const u8 values[] = {0xFF, 0x3F, 0xA0, 0x00, 0xC7,
+                                0x40, 0x70, 0x40, 0x85};
+    for (int i = 0; i < 9; i++) {
+        apu_write(&ticked, regs[i], values[i]);
+        apu_write(&lazy, regs[i], values[i]);
+    }
+
+    // Le temps passe sans accès: l'état paresseux ne bouge pas
+    for (int i = 0; i < 5000; i++) {
+        apu_tick(&ticked, 4);
+    }
+    clock += 20000;
+    assert(!ticked.square1.enabled);
+    assert(lazy.square1.enabled);
+
+    // Un accès registre rattrape l'horloge
+    assert(apu_read(&lazy, NR50_REG) == apu_read(&ticked, NR50_REG));
+    assert(!lazy.square1.enabled);
+    assert(lazy.square2.duty_position == ticked.square2.duty_position);
+
+    // Même flux d'échantillons, fin de frame comprise
+    for (int i = 0; i < 17556; i++) {
+        apu_tick(&ticked, 4);
+    }
+    clock += 70224;
+    apu_end_frame(&lazy);
+    static s16 a[4096], b[4096];
+    u32 na = apu_read_samples(&ticked, a, 2048);
+    u32 nb = apu_read_samples(&lazy, b, 2048);
+    assert(na == nb && na > 0);
+    assert(memcmp(a, b, na * 2 * sizeof(s16)) == 0);
+
+    apu_cleanup(&ticked);
+    apu_cleanup(&lazy);
+}
+
+void test_apu_noise_sequence(void) {
+    APU apu;
+    apu_init(&apu);
+
+    // Registre complet de 15 bits: en mode 7 bits la rétroaction va aussi
+    // au bit 6; sortie = bit 0 inversé
+    for (int mode = 0; mode < 2; mode++) {
+        u16 lfsr = 0x7FFF;
+        u32 period = mode ? APU_NOISE_PERIOD_7 : APU_NOISE_PERIOD_15;
+        for (u32 i = 0; i < period * 2; i++) {
+            assert(apu_noise_bit(mode == 1, i % period) == (~lfsr & 1));
+            u16 feedback = (lfsr ^ (lfsr >> 1)) & 1;
+            lfsr = (lfsr >> 1) | (feedback << 14);
+            if (mode) lfsr = (lfsr & ~0x40) | (feedback << 6);
+        }
+    }
+
+    // Canal 4 en mode 7 bits, diviseur 8 sans décalage: un pas tous les 8 cycles
+    assert(apu_enable_output(&apu, 48000));
+    apu_write(&apu, NR42_REG, 0xF0);
+    apu_write(&apu, NR43_REG, 0x08);
+    apu_write(&apu, NR44_REG, 0x80);
+    assert(apu.noise.frequency == 8);
+    for (u32 i = 1; i <= 300; i++) {
+        apu_tick(&apu, 8);
+        assert(apu.noise.lfsr_pos == i % APU_NOISE_PERIOD_7);
+        s32 level = apu_noise_bit(true, i % APU_NOISE_PERIOD_7) ? 15 : -15;
+        assert(apu.amp[CHANNEL_4] == level * APU_AMP_SCALE / 2);
+    }
+
+    // Changement de largeur en cours de note: le registre de 15 bits est
+    // conservé, seule la rétroaction change (bits 0-6 à 0 en mode 7 bits:
+    // LFSR bloqué, sortie à 1)
+    apu_write(&apu, NR43_REG, 0x00);
+    apu_write(&apu, NR44_REG, 0x80);
+    u16 lfsr = 0x7FFF;
+    bool short_mode = false;
+    bool locked_seen = false;
+    for (u32 i = 0; i < 20000; i++) {
+        bool lock = !short_mode && i > 1000 && !locked_seen && (lfsr & 0x7F) == 0;
+        if (i % 37 == 0 || lock || (locked_seen && short_mode && i % 37 == 20)) {
+            short_mode = !short_mode;
+            apu_write(&apu, NR43_REG, short_mode ? 0x08 : 0x00);
+            if (lock) {
+                assert(apu.noise.lfsr_locked);
+                locked_seen = true;
+            }
+        }
+        u8 out = apu.noise.lfsr_locked ? 1 : apu_noise_bit(short_mode, apu.noise.lfsr_pos);
+        assert(out == (~lfsr & 1));
+        apu_tick(&apu, 8);
+        u16 feedback = (lfsr ^ (lfsr >> 1)) & 1;
+        lfsr = (lfsr >> 1) | (feedback << 14);
+        if (short_mode) lfsr = (lfsr & ~0x40) | (feedback << 6);
+    }
+    assert(locked_seen);
+
+    // Diviseur 0 = 8, décalages 14 et 15: horloge arrêtée
+    apu_write(&apu, NR43_REG, 0x25);
+    assert(apu.noise.frequency == 80 << 2);
+    apu_write(&apu, NR43_REG, 0xE0);
+    assert(apu.noise.frequency == 0);
+
+    apu_cleanup(&apu);
+}
+
+void test_apu_channel_blocks(void) {
+    // Mêmes registres, avancés par petits pas ou par grands blocs: même
+    // état et mêmes échantillons
+    APU fine, coarse;
+    apu_init(&fine);
+    apu_init(&coarse);
+    assert(apu_enable_output(&fine, 48000));
+    assert(apu_enable_output(&coarse, 48000));
+
+    static const u16 regs[] = {NR51_REG, NR11_REG, NR12_REG, NR13_REG, NR14_REG,
+                               NR21_REG, NR22_REG, NR23_REG, NR24_REG,
+                               NR30_REG, NR32_REG, NR33_REG, NR34_REG,
+                               NR42_REG, NR43_REG, NR44_REG};
+    static const u8 values[] = {0xFF, 0x00, 0xF3, 0x20, 0x87,
+                                0xC0, 0x91, 0xF0, 0x87,
+                                0x80, 0x20, 0x80, 0x87,
+                                0xA1, 0x11, 0x80};
+    for (int i = 0; i < 16; i++) {
+        apu_write(&fine, WAVE_START + i, (u8)(i * 0x37));
+        apu_write(&coarse, WAVE_START + i, (u8)(i * 0x37));
+    }
+    for (int i = 0; i < 16; i++) {
+        apu_write(&fine, regs[i], values[i]);
+        apu_write(&coarse, regs[i], values[i]);
+    }
+
+    // Deux frames: enveloppes et motifs changent en route
+    for (u32 t = 0; t < 2 * 70224; t += 4) {
+        apu_tick(&fine, 4);
+    }
+    for (u32 t = 0; t < 2 * 70224; t += 228) {
+        apu_tick(&coarse, 228);
+    }
+    assert(fine.square1.duty_position == coarse.square1.duty_position);
+    assert(fine.square2.env.volume == coarse.square2.env.volume);
+    assert(fine.wave.wave_position == coarse.wave.wave_position);
+    assert(fine.noise.lfsr_pos == coarse.noise.lfsr_pos);
+
+    static s16 a[8192], b[8192];
+    u32 na = apu_read_samples(&fine, a, 4096);
+    u32 nb = apu_read_samples(&coarse, b, 4096);
+    assert(na == nb && na > 1500);
+    assert(memcmp(a, b, na * 2 * sizeof(s16)) == 0);
+
+    apu_cleanup(&fine);
+    apu_cleanup(&coarse);
+}
+
+void test_apu_status_without_output(void) {
+    // Même programme avec et sans sortie audio: mêmes compteurs visibles
+    APU quiet, loud;
+    u64 clock = 0;
+    apu_init(&quiet);
+    apu_init(&loud);
+    apu_set_clock(&quiet, &clock);
+    apu_set_clock(&loud, &clock);
+    assert(apu_enable_output(&loud, 48000));
+
+    // Canal 1: longueur 2 active; canal 2: longueur 1 inactive; canal 3:
+    // DAC éteint, le déclenchement ne l'active pas; canal 4: envelope
+    // montante de période 3
+    static const u16 regs[] = {NR11_REG, NR12_REG, NR14_REG,
+                               NR21_REG, NR22_REG, NR24_REG,
+                               NR30_REG, NR34_REG,
+                               NR42_REG, NR44_REG};
+    static const u8 values[] = {0x3E, 0xF0, 0xC0,
+                                0x3F, 0xF0, 0x80,
+                                0x00, 0x80,
+                                0x0B, 0x80};
+    for (int i = 0; i < 10; i++) {
+        apu_write(&quiet, regs[i], values[i]);
+        apu_write(&loud, regs[i], values[i]);
+    }
+    assert(apu_read(&quiet, NR52_REG) == 0xFB);
+
+    // Deux pas de longueur (pas 0 et 2 du frame sequencer): canal 1 coupé
+    clock += 8192 * 3;
+    assert(apu_read(&quiet, NR52_REG) == 0xFA);
+    assert(apu_read(&loud, NR52_REG) == 0xFA);
+
+    // 32 pas: 4 pas d'envelope, un réglage toutes les 3
+    clock += 8192 * 29;
+    apu_sync(&quiet);
+    apu_sync(&loud);
+    assert(quiet.noise.env.volume == 1 && loud.noise.env.volume == 1);
+
+    // Une seconde plus tard, par un seul rattrapage
+    clock += GB_FREQ;
+    assert(apu_read(&quiet, NR52_REG) == apu_read(&loud, NR52_REG));
+    assert(quiet.sequencer_step == loud.sequencer_step);
+    assert(quiet.noise.env.volume == loud.noise.env.volume);
+    assert(quiet.noise.env.volume == 15);
+    assert(quiet.square2.length_counter == 1);
+
+    // DAC éteint: canal coupé; APU éteint: plus aucun canal
+    apu_write(&quiet, NR22_REG, 0x00);
+    assert(apu_read(&quiet, NR52_REG) == 0xF8);
+    apu_write(&quiet, NR52_REG, 0x00);
+    assert(apu_read(&quiet, NR52_REG) == 0x70);
+
+    apu_cleanup(&quiet);
+    apu_cleanup(&loud);
+}
+
+typedef struct {
+    Scheduler* sched;
+    int id;
+    u64 fired[8];
+    int count;
+} SchedulerProbe;
+
+static void scheduler_probe_event(void* user, u64 when) {
+    SchedulerProbe* probe = (SchedulerProbe*)user;
+    probe->fired[probe->count++] = when;
+    // Reprogrammé une fois, avant l'horloge courante: rejoué dans la passe
+    if (probe->count == 2) scheduler_schedule(probe->sched, probe->id, when + 5);
+}
+
+void test_scheduler_order(void) {
+    Scheduler sched;
+    scheduler_init(&sched);
+    SchedulerProbe a = {&sched, 0, {0}, 0};
+    SchedulerProbe b = {&sched, 0, {0}, 0};
+    a.id = scheduler_register(&sched, scheduler_probe_event, &a);
+    b.id = scheduler_register(&sched, scheduler_probe_event, &b);
+    assert(a.id == 0 && b.id == 1);
+    assert(sched.next == SCHEDULER_NEVER);
+
+    scheduler_schedule(&sched, a.id, 100);
+    scheduler_schedule(&sched, b.id, 40);
+    assert(sched.next == 40);
+    scheduler_run(&sched, 39);
+    assert(a.count == 0 && b.count == 0);
+
+    // Échéances dans l'ordre, dates programmées transmises
+    scheduler_run(&sched, 100);
+    assert(b.count == 1 && b.fired[0] == 40);
+    assert(a.count == 1 && a.fired[0] == 100);
+    assert(sched.next == SCHEDULER_NEVER);
+
+    scheduler_schedule(&sched, a.id, 200);
+    scheduler_run(&sched, 300);
+    assert(a.count == 3 && a.fired[1] == 200 && a.fired[2] == 205);
+
+    scheduler_schedule(&sched, b.id, 400);
+    scheduler_cancel(&sched, b.id);
+    assert(sched.next == SCHEDULER_NEVER);
+    scheduler_run(&sched, 1000);
+    assert(b.count == 1);
+}
+
+void test_apu_sweep(void) {
+    // Balayage montant, période 1, décalage 2: 0x400 -> 0x500 -> 0x640 ->
+    // 0x7D0, dont le calcul de contrôle (0x9C4) dépasse 2047
+    APU apu;
+    u64 clock = 0;
+    Scheduler sched;
+    scheduler_init(&sched);
+    apu_init(&apu);
+    apu_set_clock(&apu, &clock);
+    assert(apu_set_scheduler(&apu, &sched));
+
+    apu_write(&apu, NR10_REG, 0x12);
+    apu_write(&apu, NR12_REG, 0xF0);
+    apu_write(&apu, NR13_REG, 0x00);
+    apu_write(&apu, NR14_REG, 0x84);
+    assert(apu.square1.enabled);
+    // Premier pas de sweep: pas 2 du frame sequencer
+    assert(sched.next == 3 * 8192);
+
+    u64 expected[] = {0x500, 0x640, 0x7D0};
+    for (int i = 0; i < 3; i++) {
+        clock = sched.next + 12;  // Instruction à cheval sur l'échéance
+        scheduler_run(&sched, clock);
+        u16 freq = ((apu.square1.freq_hi & 0x07) << 8) | apu.square1.freq_lo;
+        assert(freq == expected[i]);
+        assert(apu.square1.frequency == (2048 - freq) * 4);
+        assert((apu_read(&apu, NR52_REG) & 0x01) == (i < 2 ? 0x01 : 0x00));
+    }
+    assert(sched.next == SCHEDULER_NEVER);
+
+    // Descente puis sortie du mode soustraction: canal coupé
+    apu_write(&apu, NR10_REG, 0x79);
+    apu_write(&apu, NR14_REG, 0x84);
+    assert(apu_read(&apu, NR52_REG) & 0x01);
+    apu_write(&apu, NR10_REG, 0x71);
+    assert((apu_read(&apu, NR52_REG) & 0x01) == 0);
+
+    // Même programme sans ordonnanceur (pas à pas du frame sequencer):
+    // mêmes fréquences, même coupure, mêmes échantillons
+    APU inline_apu;
+    u64 inline_clock = clock;
+    apu_init(&inline_apu);
+    apu_set_clock(&inline_apu, &inline_clock);
+    apu.sequencer_step = inline_apu.sequencer_step = 0;
+    apu.frame_sequencer = inline_apu.frame_sequencer = 0;
+    assert(apu_enable_output(&apu, 48000));
+    assert(apu_enable_output(&inline_apu, 48000));
+    static const u16 regs[] = {NR51_REG, NR12_REG, NR10_REG, NR13_REG, NR14_REG};
+    static const u8 values[] = {0x11, 0xF0, 0x23, 0x80, 0x83};
+    for (int i = 0; i < 5; i++) {
+        apu_write(&apu, regs[i], values[i]);
+        apu_write(&inline_apu, regs[i], values[i]);
+    }
+    static s16 a[16384], b[16384];
+    u32 na = 0, nb = 0;
+    for (int i = 0; i < 1200; i++) {
+        clock += 444;
+        inline_clock += 444;
+        if (clock >= sched.next) scheduler_run(&sched, clock);
+        if (i % 37 == 0) {
+            assert(apu_read(&apu, NR52_REG) == apu_read(&inline_apu, NR52_REG));
+        }
+        if (i % 100 == 99) {
+            na += apu_read_samples(&apu, a + na * 2, 2048);
+            nb += apu_read_samples(&inline_apu, b + nb * 2, 2048);
+        }
+    }
+    assert(apu.square1.freq_lo == inline_apu.square1.freq_lo);
+    assert(apu.square1.shadow_frequency > 0x700);
+    assert(!apu.square1.enabled && !inline_apu.square1.enabled);
+    assert(na == nb && na > 6000);
+    assert(memcmp(a, b, na * 2 * sizeof(s16)) == 0);
+
+    apu_cleanup(&apu);
+    apu_cleanup(&inline_apu);
+}
+
+void test_audio_ring(void) {
+    AudioRing ring;
+    assert(audio_ring_init(&ring, 100));
+    assert(ring.capacity == 128);
+
+    s16 in[200 * 2], out[200 * 2];
+    for (int i = 0; i < 400; i++) {
+        in[i] = (s16)i;
+    }
+
+    // Passage de la fin du tableau
+    assert(audio_ring_write(&ring, in, 100) == 100);
+    assert(audio_ring_read(&ring, out, 90) == 90);
+    assert(audio_ring_write(&ring, in, 100) == 100);
+    assert(audio_ring_fill(&ring) == 110);
+    assert(audio_ring_read(&ring, out, 10) == 10);
+    assert(out[0] == 180 && out[19] == 199);
+    assert(audio_ring_read(&ring, out, 100) == 100);
+    assert(memcmp(out, in, 200 * sizeof(s16)) == 0);
+    assert(ring.underruns == 0 && ring.overruns == 0);
+
+    // Débordement: début gardé, fin perdue et comptée
+    assert(audio_ring_write(&ring, in, 200) == 128);
+    assert(ring.overruns == 1 && ring.dropped_frames == 72);
+
+    // Sous-alimentation: complétée de silence
+    assert(audio_ring_read(&ring, out, 130) == 128);
+    assert(out[127 * 2 + 1] == 255);
+    assert(out[128 * 2] == 0 && out[129 * 2 + 1] == 0);
+    assert(ring.underruns == 1 && ring.silent_frames == 2);
+
+    audio_ring_cleanup(&ring);
+}
+
+#define RING_TEST_FRAMES 200000
+
+static void ring_consumer(void* arg) {
+    AudioRing* ring = (AudioRing*)arg;
+    s16 block[64 * 2];
+    u32 expected = 0;
+    while (expected < RING_TEST_FRAMES) {
+        u32 want = audio_ring_fill(ring);
+        if (want == 0) {
+            thread_yield();
+            continue;
+        }
+        if (want > 64) want = 64;
+        assert(audio_ring_read(ring, block, want) == want);
+        for (u32 i = 0; i < want; i++, expected++) {
+            assert(block[i * 2] == (s16)expected);
+            assert(block[i * 2 + 1] == (s16)~expected);
+        }
+    }
+}
+
+void test_audio_ring_threads(void) {
+    AudioRing ring;
+    assert(audio_ring_init(&ring, 256));
+
+    Thread consumer;
+    assert(thread_start(&consumer, ring_consumer, &ring));
+
+    // Producteur: séquence continue, jamais de perte tant qu'on respecte la place
+    s16 block[37 * 2];
+    u32 next = 0;
+    while (next < RING_TEST_FRAMES) {
+        u32 n = RING_TEST_FRAMES - next < 37 ? RING_TEST_FRAMES - next : 37;
+        if (ring.capacity - audio_ring_fill(&ring) < n) {
+            thread_yield();
+            continue;
+        }
+        for (u32 i = 0; i < n; i++) {
+            block[i * 2] = (s16)(next + i);
+            block[i * 2 + 1] = (s16)~(next + i);
+        }
+        assert(audio_ring_write(&ring, block, n) == n);
+        next += n;
+    }
+    thread_join(&consumer);
+    assert(ring.overruns == 0 && ring.underruns == 0);
+
+    audio_ring_cleanup(&ring);
+}
+
+// Rééchantillonne une seconde d'entrée par blocs irréguliers
+static u32 resample_blocks(Resampler* rs, const s16* in, u32 frames, s16* out) {
+    u32 produced = 0;
+    for (u32 i = 0; i < frames; ) {
+        u32 n = frames - i < 777 ? frames - i : 777;
+        produced += resampler_run(rs, in + i * 2, n, out + produced * 2);
+        i += n;
+    }
+    return produced;
+}
+
+static double power_left(const s16* frames, u32 count) {
+    double sum = 0.0;
+    for (u32 i = 0; i < count; i++) {
+        sum += (double)frames[i * 2] * frames[i * 2];
+    }
+    return sum / count;
+}
+
+void test_resampler_rates(void) {
+    static s16 in[APU_SYNTH_RATE * 2];
+    static s16 out[100000 * 2];
+    for (u32 i = 0; i < APU_SYNTH_RATE; i++) {
+        in[i * 2] = 12000;
+        in[i * 2 + 1] = -7000;
+    }
+
+    static const u32 rates[] = {32000, 44100, 48000, 96000};
+    for (int r = 0; r < 4; r++) {
+        Resampler rs;
+        assert(resampler_init(&rs, APU_SYNTH_RATE, rates[r]));
+        u32 n = resample_blocks(&rs, in, APU_SYNTH_RATE, out);
+        assert(n >= rates[r] && n <= rates[r] + 2);
+        assert(n <= resampler_max_output(&rs, APU_SYNTH_RATE));
+
+        // Gain unitaire exact une fois le noyau rempli
+        for (u32 i = RESAMPLER_TAPS * 2; i < n; i++) {
+            assert(out[i * 2] == 12000 && out[i * 2 + 1] == -7000);
+        }
+        resampler_cleanup(&rs);
+    }
+}
+
+void test_resampler_antialias(void) {
+    // Sinusoïde à fs/4 (16384 Hz): 0, A, 0, -A
+    static s16 in[APU_SYNTH_RATE * 2];
+    static s16 out[100000 * 2];
+    for (u32 i = 0; i < APU_SYNTH_RATE; i++) {
+        s16 v = (i & 1) ? 0 : ((i & 2) ? -10000 : 10000);
+        in[i * 2] = in[i * 2 + 1] = v;
+    }
+    double input_power = 10000.0 * 10000.0 / 2;
+
+    // Au-dessus de Nyquist à 32 kHz: rejetée; sous la coupure à 48 kHz: intacte
+    Resampler rs;
+    assert(resampler_init(&rs, APU_SYNTH_RATE, 32000));
+    u32 n = resample_blocks(&rs, in, APU_SYNTH_RATE, out);
+    assert(power_left(out + 200, n - 400) < input_power * 0.01);
+    resampler_cleanup(&rs);
+
+    assert(resampler_init(&rs, APU_SYNTH_RATE, 48000));
+    n = resample_blocks(&rs, in, APU_SYNTH_RATE, out);
+    double ratio = power_left(out + 200, n - 400) / input_power;
+    assert(ratio > 0.98 && ratio < 1.02);
+    resampler_cleanup(&rs);
+}
+
+void test_resampler_adjust(void) {
+    static s16 in[APU_SYNTH_RATE * 2];
+    static s16 out[100000 * 2];
+    memset(in, 0, sizeof(in));
+
+    Resampler rs;
+    assert(resampler_init(&rs, APU_SYNTH_RATE, 48000));
+    resampler_set_adjust(&rs, 1.005);
+
+    // Le pas glisse vers sa cible: premier bloc quasi nominal, puis +0.5%
+    u32 first = resampler_run(&rs, in, 256, out);
+    assert(first <= 256 * 48000 / APU_SYNTH_RATE + 1);
+    u32 n = resample_blocks(&rs, in, APU_SYNTH_RATE, out);
+    assert(n > 48000 * 1.004 && n < 48000 * 1.006);
+
+    // Ajustement borné
+    resampler_set_adjust(&rs, 2.0);
+    assert(rs.target_step >= (s64)(rs.base_step / (1.0 + RESAMPLER_MAX_ADJUST)) - 1);
+    resampler_cleanup(&rs);
+}
+
+static u32 read_le32(const u8* p) {
+    return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+void test_wav_sink(void) {
+    const char* path = "test_apu_capture.wav";
+
+    // Plus d'un bloc d'écriture, en appels de tailles variées
+    static s16 samples[WAV_SINK_BLOCK];
+    for (u32 i = 0; i < WAV_SINK_BLOCK; i++) {
+        samples[i] = (s16)(i * 7);
+    }
+    u32 frames = WAV_SINK_BLOCK / 2;  // Stéréo: 2 blocs d'octets
+    WavSink sink;
+    assert(wav_sink_open(&sink, path, APU_SYNTH_RATE, 2, true));
+    for (u32 done = 0; done < frames; ) {
+        u32 n = frames - done < 1000 ? frames - done : 1000;
+        wav_sink_write(&sink, samples + done * 2, n);
+        done += n;
+    }
+    assert(wav_sink_close(&sink));
+
+    FILE* f = fopen(path, "rb");
+    assert(f != NULL);
+    static u8 data[WAV_HEADER_SIZE + WAV_SINK_BLOCK * 2];
+    size_t len = fread(data, 1, sizeof(data), f);
+    fclose(f);
+    remove(path);
+
+    // En-tête réécrit avec les tailles réelles
+    u32 bytes = frames * 2 * sizeof(s16);
+    assert(len == WAV_HEADER_SIZE + bytes);
+    assert(memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WAVEfmt ", 8) == 0);
+    assert(read_le32(data + 4) == 36 + bytes);
+    assert(read_le32(data + 24) == APU_SYNTH_RATE);
+    assert(data[22] == 2 && data[34] == 16);
+    assert(memcmp(data + 36, "data", 4) == 0);
+    assert(read_le32(data + 40) == bytes);
+    assert(memcmp(data + WAV_HEADER_SIZE, samples, bytes) == 0);
+}
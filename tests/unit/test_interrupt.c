@@ -22,6 +22,8 @@ void test_interrupt_enable(void);
 void test_interrupt_service_routine(void);
 void test_interrupt_vblank(void);
 void test_interrupt_lcd_stat(void);
+void test_interrupt_mmu_storage(void);
+void test_interrupt_dispatch(void);
 
 // Table des tests Interrupt
 typedef struct {
@@ -38,6 +40,8 @@ UnitTest interrupt_tests[] = {
     {"Interrupt Service Routine", test_interrupt_service_routine},
     {"Interrupt VBlank", test_interrupt_vblank},
     {"Interrupt LCD STAT", test_interrupt_lcd_stat},
+    {"Interrupt Registres MMU", test_interrupt_mmu_storage},
+    {"Interrupt Dispatch", test_interrupt_dispatch},
     {NULL, NULL} // Marqueur de fin
 };
 
@@ -87,9 +91,9 @@ void test_interrupt_init(void) {
     interrupt_init(&im);
 
     // Vérifier les valeurs par défaut
-    assert(im.ie == 0x00);
-    assert(im.if_reg == 0xE1); // Valeur par défaut selon Pan Docs
-    assert(im.pending_interrupts == 0x00);
+    assert(interrupt_read_ie(&im) == 0x00);
+    assert(interrupt_read_if(&im) == 0xE1); // Valeur par défaut selon Pan Docs
+    assert(im.active == 0x00);
 }
 
 void test_interrupt_request(void) {
@@ -100,15 +104,16 @@ void test_interrupt_request(void) {
     // Demander une interruption VBLANK
     interrupt_request(&im, VBLANK_INT);
 
-    assert(im.if_reg & VBLANK_INT);
-    assert(im.pending_interrupts & VBLANK_INT);
+    assert(interrupt_read_if(&im) & VBLANK_INT);
 
     // Demander une interruption TIMER
     interrupt_request(&im, TIMER_INT);
 
-    assert(im.if_reg & TIMER_INT);
-    assert(im.pending_interrupts & TIMER_INT);
-    assert(im.if_reg & VBLANK_INT); // VBLANK toujours présent
+    assert(interrupt_read_if(&im) & TIMER_INT);
+    assert(interrupt_read_if(&im) & VBLANK_INT); // VBLANK toujours présent
+
+    // IE = 0 et IME = 0: rien n'est servable
+    assert(im.active == 0x00);
 }
 
 void test_interrupt_clear(void) {
@@ -124,10 +129,9 @@ void test_interrupt_clear(void) {
     // Effacer VBLANK
     interrupt_clear(&im, VBLANK_INT);
 
-    assert(!(im.if_reg & VBLANK_INT));
-    assert(!(im.pending_interrupts & VBLANK_INT));
-    assert(im.if_reg & TIMER_INT); // Les autres restent
-    assert(im.if_reg & SERIAL_INT);
+    assert(!(interrupt_read_if(&im) & VBLANK_INT));
+    assert(interrupt_read_if(&im) & TIMER_INT); // Les autres restent
+    assert(interrupt_read_if(&im) & SERIAL_INT);
 }
 
 void test_interrupt_priority(void) {
@@ -212,6 +216,12 @@ void test_interrupt_service_routine(void) {
     assert(cpu.pc == INT_VBLANK_ADDR); // PC point vers handler
     assert(mmu_read16(&mmu, 0xFFFC) == 0x0100); // PC sauvegardé
 
+    // Masque vide ou à plusieurs bits: aucune routine déclenchée
+    cpu.ime = true;
+    interrupt_service_routine(&cpu, &mmu, 0);
+    interrupt_service_routine(&cpu, &mmu, VBLANK_INT | TIMER_INT);
+    assert(cpu.ime && cpu.sp == 0xFFFC && cpu.pc == INT_VBLANK_ADDR);
+
     mmu_cleanup(&mmu);
 }
 
@@ -255,3 +265,123 @@ void test_interrupt_lcd_stat(void) {
 
     assert(interrupt_get_highest_priority(&im) == LCD_STAT_INT);
 }
+
+void test_interrupt_mmu_storage(void) {
+    InterruptManager im;
+    CPU cpu;
+    MMU mmu;
+
+    interrupt_init(&im);
+    cpu_init(&cpu);
+    mmu_init(&mmu);
+    interrupt_attach(&im, &mmu);
+
+    // IE/IF n'existent qu'une fois: les registres de la MMU
+    assert(interrupt_read_if(&im) == mmu_read8(&mmu, IF_REG));
+    mmu_write8(&mmu, IF_REG, 0xE0);
+    mmu_write8(&mmu, IE_REG, VBLANK_INT | TIMER_INT);
+    assert(interrupt_read_ie(&im) == (VBLANK_INT | TIMER_INT));
+    interrupt_request(&im, TIMER_INT);
+    assert(mmu_read8(&mmu, IF_REG) & TIMER_INT);
+
+    // IME = 0: demandée mais non servable
+    assert(interrupt_has_pending(&im));
+    assert(im.active == 0x00);
+    assert(interrupt_handle(&im, &cpu, &mmu) == 0);
+
+    // EI (effectif après l'instruction) met à jour le drapeau en cache
+    cpu.pc = 0xC000;
+    mmu_write8(&mmu, 0xC000, 0xFB);  // EI
+    mmu_write8(&mmu, 0xC001, 0xF3);  // DI
+    mmu_write8(&mmu, 0xC002, 0x00);  // NOP
+    cpu_step(&cpu, &mmu);
+    assert(cpu.ime);
+    assert(im.active == TIMER_INT);
+
+    // Écriture IF par la MMU: le cache suit
+    mmu_write8(&mmu, IF_REG, 0xE0 | VBLANK_INT | TIMER_INT);
+    assert(im.active == (VBLANK_INT | TIMER_INT));
+
+    // DI: plus rien de servable, IF intact
+    cpu_step(&cpu, &mmu);
+    assert(!cpu.ime);
+    assert(im.active == 0x00);
+    assert(interrupt_read_if(&im) & VBLANK_INT);
+
+    // Service: IF effacé dans la MMU, IME retombe, le cache suit
+    cpu_set_ime(&cpu, &mmu, true);
+    cpu.sp = 0xFFFE;
+    assert(interrupt_handle(&im, &cpu, &mmu) == VBLANK_INT);
+    assert(cpu.pc == INT_VBLANK_ADDR);
+    assert(!(mmu_read8(&mmu, IF_REG) & VBLANK_INT));
+    assert(!cpu.ime);
+    assert(im.active == 0x00);
+
+    mmu_cleanup(&mmu);
+}
+
+void test_interrupt_dispatch(void) {
+    InterruptManager im;
+    CPU cpu;
+    MMU mmu;
+
+    // Sélection: bit le plus bas de IE & IF, comparé au parcours par priorité
+    interrupt_init(&im);
+    for (int ie = 0; ie < 0x20; ie++) {
+        for (int flags = 0; flags < 0x20; flags++) {
+            interrupt_write_ie(&im, (u8)(ie | 0xE0));
+            interrupt_write_if(&im, (u8)(flags | 0xE0));
+            u8 expected = 0;
+            for (int i = 0; i < 5; i++) {
+                if ((ie & flags) & (1 << i)) {
+                    expected = (u8)(1 << i);
+                    break;
+                }
+            }
+            assert(interrupt_get_highest_priority(&im) == expected);
+        }
+    }
+
+    // Vecteurs 0x40 + 8n; pas de vecteur pour une combinaison ou un bit hors sources
+    assert(interrupt_get_handler_address(TIMER_INT) == INT_TIMER_ADDR);
+    assert(interrupt_get_handler_address(SERIAL_INT) == INT_SERIAL_ADDR);
+    assert(interrupt_get_handler_address(JOYPAD_INT) == INT_JOYPAD_ADDR);
+    assert(interrupt_get_handler_address(0x00) == 0x0000);
+    assert(interrupt_get_handler_address(VBLANK_INT | TIMER_INT) == 0x0000);
+    assert(interrupt_get_handler_address(0x20) == 0x0000);
+
+    // Dispatch depuis HALT, pile en HRAM (écriture directe)
+    interrupt_init(&im);
+    cpu_init(&cpu);
+    mmu_init(&mmu);
+    interrupt_attach(&im, &mmu);
+    mmu_write8(&mmu, IE_REG, 0x1F);
+    mmu_write8(&mmu, IF_REG, 0xE0 | TIMER_INT | JOYPAD_INT);
+    cpu_set_ime(&cpu, &mmu, true);
+    cpu.halted = true;
+    cpu.pc = 0x1234;
+    cpu.sp = 0xFFFE;
+    assert(interrupt_handle(&im, &cpu, &mmu) == TIMER_INT);
+    assert(cpu.pc == INT_TIMER_ADDR);
+    assert(!cpu.halted);
+    assert(cpu.sp == 0xFFFC);
+    assert(mmu_read16(&mmu, 0xFFFC) == 0x1234);
+    assert(mmu_read8(&mmu, IF_REG) == (0xE0 | JOYPAD_INT));
+
+    // Pile hors WRAM/HRAM: accès décodé (compteur d'écritures VRAM)
+    u32 vram_writes = mmu.vram_writes;
+    cpu_set_ime(&cpu, &mmu, true);
+    cpu.pc = 0x4321;
+    cpu.sp = 0x8002;
+    assert(interrupt_handle(&im, &cpu, &mmu) == JOYPAD_INT);
+    assert(cpu.pc == INT_JOYPAD_ADDR);
+    assert(mmu_read16(&mmu, 0x8000) == 0x4321);
+    assert(mmu.vram_writes == vram_writes + 2);
+    assert(im.active == 0x00);
+    assert(interrupt_handle(&im, &cpu, &mmu) == 0);
+
+    // 5 M-cycles par dispatch
+    assert(INTERRUPT_DISPATCH_CYCLES == 20);
+
+    mmu_cleanup(&mmu);
+}
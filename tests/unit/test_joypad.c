@@ -7,6 +7,7 @@
 
 #include "../../src/common.h"
 #include "../../src/joypad.h"
+#include "../../src/scheduler.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -19,6 +20,8 @@ void test_joypad_read(void);
 void test_joypad_buttons(void);
 void test_joypad_directions(void);
 void test_joypad_mixed_input(void);
+void test_joypad_interrupt(void);
+void test_joypad_events(void);
 
 // Table des tests Joypad
 typedef struct {
@@ -34,6 +37,8 @@ UnitTest joypad_tests[] = {
     {"Joypad Buttons", test_joypad_buttons},
     {"Joypad Directions", test_joypad_directions},
     {"Joypad Mixed Input", test_joypad_mixed_input},
+    {"Joypad Interrupt", test_joypad_interrupt},
+    {"Joypad Events", test_joypad_events},
     {NULL, NULL} // Marqueur de fin
 };
 
@@ -112,19 +117,20 @@ void test_joypad_write(void) {
 
     joypad_init(&joypad);
 
-    // Test écriture avec sélection des boutons
-    joypad_write(&joypad, 0x20); // Sélection boutons (bit 5)
-    assert(joypad.p1 == (0xCF & 0x0F) | 0x20);
-    assert(joypad.select_line == 0x20);
-
-    // Test écriture avec sélection des directions
-    joypad_write(&joypad, 0x10); // Sélection directions (bit 4)
-    assert(joypad.p1 == (0xCF & 0x0F) | 0x10);
+    // Test écriture: P15 à 0 sélectionne les boutons
+    joypad_write(&joypad, 0x10);
+    assert(joypad.p1 == 0xDF);
     assert(joypad.select_line == 0x10);
 
+    // Test écriture: P14 à 0 sélectionne les directions
+    joypad_write(&joypad, 0x20);
+    assert(joypad.p1 == 0xEF);
+    assert(joypad.select_line == 0x20);
+
     // Test écriture sans sélection
     joypad_write(&joypad, 0x30); // Aucun sélectionné
     assert(joypad.select_line == 0x30);
+    assert(joypad.p1 == 0xFF);
 }
 
 void test_joypad_read(void) {
@@ -136,14 +142,15 @@ void test_joypad_read(void) {
     joypad_write(&joypad, 0x30); // Aucun sélectionné
     u8 result = joypad_read(&joypad);
     assert((result & 0x0F) == 0x0F);
+    assert((result & 0xC0) == 0xC0);  // Bits 6-7 toujours à 1
 
     // Test lecture avec sélection boutons
-    joypad_write(&joypad, 0x20); // Sélection boutons
+    joypad_write(&joypad, 0x10); // Sélection boutons
     result = joypad_read(&joypad);
     assert((result & 0x0F) == 0x0F); // Tous relâchés
 
     // Test lecture avec sélection directions
-    joypad_write(&joypad, 0x10); // Sélection directions
+    joypad_write(&joypad, 0x20); // Sélection directions
     result = joypad_read(&joypad);
     assert((result & 0x0F) == 0x0F); // Tous relâchés
 }
@@ -154,7 +161,7 @@ void test_joypad_buttons(void) {
     joypad_init(&joypad);
 
     // Sélectionner les boutons
-    joypad_write(&joypad, 0x20);
+    joypad_write(&joypad, 0x10);
 
     // Appuyer sur A
     joypad_press(&joypad, JOYPAD_A);
@@ -169,12 +176,18 @@ void test_joypad_buttons(void) {
     // Appuyer sur START
     joypad_press(&joypad, JOYPAD_START);
     result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0C); // START n'est pas dans les bits 0-3
+    assert((result & 0x0F) == 0x04); // START en bit 3
 
-    // Relâcher A
+    // Appuyer sur SELECT
+    joypad_press(&joypad, JOYPAD_SELECT);
+    result = joypad_read(&joypad);
+    assert((result & 0x0F) == 0x00); // Les 4 boutons appuyés
+
+    // Relâcher A et SELECT
     joypad_release(&joypad, JOYPAD_A);
+    joypad_release(&joypad, JOYPAD_SELECT);
     result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0D); // Seulement B appuyé
+    assert((result & 0x0F) == 0x05); // B et START appuyés
 }
 
 void test_joypad_directions(void) {
@@ -183,7 +196,7 @@ void test_joypad_directions(void) {
     joypad_init(&joypad);
 
     // Sélectionner les directions
-    joypad_write(&joypad, 0x10);
+    joypad_write(&joypad, 0x20);
 
     // Appuyer sur RIGHT
     joypad_press(&joypad, JOYPAD_RIGHT);
@@ -198,12 +211,18 @@ void test_joypad_directions(void) {
     // Appuyer sur DOWN
     joypad_press(&joypad, JOYPAD_DOWN);
     result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0A); // DOWN n'est pas dans les bits 0-3
+    assert((result & 0x0F) == 0x02); // DOWN en bit 3
+
+    // Appuyer sur LEFT
+    joypad_press(&joypad, JOYPAD_LEFT);
+    result = joypad_read(&joypad);
+    assert((result & 0x0F) == 0x00);
 
-    // Relâcher RIGHT
+    // Relâcher RIGHT et LEFT
     joypad_release(&joypad, JOYPAD_RIGHT);
+    joypad_release(&joypad, JOYPAD_LEFT);
     result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0B); // Seulement UP appuyé
+    assert((result & 0x0F) == 0x03); // UP et DOWN appuyés
 }
 
 void test_joypad_mixed_input(void) {
@@ -214,15 +233,16 @@ void test_joypad_mixed_input(void) {
     // Appuyer sur plusieurs boutons
     joypad_press(&joypad, JOYPAD_A);
     joypad_press(&joypad, JOYPAD_RIGHT);
-    joypad_press(&joypad, JOYPAD_START); // Ne sera pas lu dans les bits 0-3
+    joypad_press(&joypad, JOYPAD_START);
+    assert(joypad_pressed(&joypad) == (JOYPAD_A | JOYPAD_RIGHT | JOYPAD_START));
 
     // Tester avec sélection boutons
-    joypad_write(&joypad, 0x20);
+    joypad_write(&joypad, 0x10);
     u8 result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0E); // Seulement A visible
+    assert((result & 0x0F) == 0x06); // A et START
 
     // Tester avec sélection directions
-    joypad_write(&joypad, 0x10);
+    joypad_write(&joypad, 0x20);
     result = joypad_read(&joypad);
     assert((result & 0x0F) == 0x0E); // Seulement RIGHT visible
 
@@ -231,8 +251,103 @@ void test_joypad_mixed_input(void) {
     result = joypad_read(&joypad);
     assert((result & 0x0F) == 0x0F); // Aucun bouton visible
 
-    // Vérifier que START n'interfère pas
-    joypad_press(&joypad, JOYPAD_START);
+    // Deux groupes sélectionnés: ET des lignes
+    joypad_write(&joypad, 0x00);
     result = joypad_read(&joypad);
-    assert((result & 0x0F) == 0x0F); // Toujours aucun
+    assert((result & 0x0F) == 0x06);
+}
+
+void test_joypad_interrupt(void) {
+    Joypad joypad;
+
+    joypad_init(&joypad);
+    joypad_write(&joypad, 0x10);  // Boutons
+    assert(joypad_get_interrupts(&joypad) == 0);
+
+    // Front descendant sur P10: IRQ
+    joypad_press(&joypad, JOYPAD_A);
+    assert(joypad_get_interrupts(&joypad) == 0x10);
+    assert(joypad_get_interrupts(&joypad) == 0);
+
+    // Autre ligne qui tombe alors que A reste enfoncé: IRQ
+    joypad_press(&joypad, JOYPAD_START);
+    assert(joypad_get_interrupts(&joypad) == 0x10);
+
+    // Relâchement (front montant) et groupe non sélectionné: pas d'IRQ
+    joypad_release(&joypad, JOYPAD_A);
+    joypad_press(&joypad, JOYPAD_RIGHT);
+    assert(joypad_get_interrupts(&joypad) == 0);
+
+    // Sélectionner un groupe où une touche est enfoncée fait tomber la ligne
+    joypad_release(&joypad, JOYPAD_START);
+    joypad_write(&joypad, 0x20);
+    assert(joypad_get_interrupts(&joypad) == 0x10);
+    joypad_write(&joypad, 0x30);
+    assert(joypad_get_interrupts(&joypad) == 0);
+}
+
+void test_joypad_events(void) {
+    Scheduler sched;
+    u64 clock = 0;
+    Joypad joypad;
+
+    scheduler_init(&sched);
+    joypad_init(&joypad);
+
+    // Sans horloge maître, pas d'événement possible
+    assert(!joypad_set_scheduler(&joypad, &sched));
+    joypad_set_clock(&joypad, &clock);
+    assert(joypad_set_scheduler(&joypad, &sched));
+    joypad_write(&joypad, 0x10);
+
+    // File triée à l'insertion, même hors ordre
+    assert(joypad_queue_event(&joypad, 3000, JOYPAD_START, false));
+    assert(joypad_queue_event(&joypad, 1000, JOYPAD_START, true));
+    assert(joypad_queue_event(&joypad, 2000, JOYPAD_A, true));
+    assert(joypad.events[0].cycle == 1000 && joypad.events[2].cycle == 3000);
+    assert(scheduler_when(&sched, joypad.input_event) == 1000);
+
+    // Chaque entrée est appliquée au cycle exact et lève l'IRQ à ce moment-là
+    u64 irq_at[2] = {0, 0};
+    int irqs = 0;
+    while (clock < 4000) {
+        clock += 4;
+        if (clock >= sched.next) {
+            scheduler_run(&sched, clock);
+        }
+        if (joypad_get_interrupts(&joypad) && irqs < 2) {
+            irq_at[irqs++] = clock;
+        }
+        if (clock == 1996) assert((joypad_read(&joypad) & 0x0F) == 0x07);
+        if (clock == 2000) assert((joypad_read(&joypad) & 0x0F) == 0x06);
+    }
+    assert(irqs == 2 && irq_at[0] == 1000 && irq_at[1] == 2000);
+    assert(joypad_pressed(&joypad) == JOYPAD_A);
+    assert(scheduler_when(&sched, joypad.input_event) == SCHEDULER_NEVER);
+
+    // Rattrapage à la lecture de P1 (sans passer par l'ordonnanceur)
+    assert(joypad_queue_event(&joypad, 4100, JOYPAD_A, false));
+    clock = 4100;
+    assert((joypad_read(&joypad) & 0x0F) == 0x0F);
+
+    // Fichier d'entrées
+    const char* path = "test_joypad_input.txt";
+    FILE* f = fopen(path, "w");
+    assert(f != NULL);
+    fprintf(f, "# rejeu\n5000 down down\n\n5100 b down  # B\n5200 down up\n");
+    fclose(f);
+    assert(joypad_load_events(&joypad, path));
+    assert(joypad.event_count == 3);
+    clock = 5100;
+    joypad_sync(&joypad);
+    assert(joypad_pressed(&joypad) == (JOYPAD_DOWN | JOYPAD_B));
+
+    f = fopen(path, "w");
+    assert(f != NULL);
+    fprintf(f, "6000 turbo down\n");
+    fclose(f);
+    assert(!joypad_load_events(&joypad, path));
+    remove(path);
+
+    joypad_cleanup(&joypad);
 }
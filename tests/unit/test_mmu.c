@@ -7,6 +7,7 @@
 
 #include "../../src/common.h"
 #include "../../src/mmu.h"
+#include "../../src/joypad.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -20,6 +21,7 @@ void test_mmu_cart_parsing(void);
 void test_mmu_read_write_8bit(void);
 void test_mmu_read_write_16bit(void);
 void test_mmu_echo_ram(void);
+void test_mmu_joypad(void);
 
 // Table des tests MMU
 typedef struct {
@@ -35,6 +37,7 @@ UnitTest mmu_tests[] = {
     {"MMU Read/Write 8-bit", test_mmu_read_write_8bit},
     {"MMU Read/Write 16-bit", test_mmu_read_write_16bit},
     {"MMU Echo RAM", test_mmu_echo_ram},
+    {"MMU Joypad P1", test_mmu_joypad},
     {NULL, NULL} // Marqueur de fin
 };
 
@@ -301,3 +304,27 @@ void test_mmu_echo_ram(void) {
 
     mmu_cleanup(&mmu);
 }
+
+void test_mmu_joypad(void) {
+    MMU mmu;
+    Joypad joypad;
+
+    mmu_init(&mmu);
+    joypad_init(&joypad);
+
+    // Sans joypad attaché: stockage brut (valeur de boot)
+    assert(mmu_read8(&mmu, P1_REG) == 0xCF);
+
+    // P1 routé vers le joypad: les 8 touches sont visibles
+    mmu.joypad = &joypad;
+    joypad_press(&joypad, JOYPAD_START);
+    joypad_press(&joypad, JOYPAD_LEFT);
+    mmu_write8(&mmu, P1_REG, 0x10);  // Boutons
+    assert(mmu_read8(&mmu, P1_REG) == 0xD7);
+    mmu_write8(&mmu, P1_REG, 0x20);  // Directions
+    assert(mmu_read8(&mmu, P1_REG) == 0xED);
+    assert(joypad_get_interrupts(&joypad) == 0x10);
+
+    joypad_cleanup(&joypad);
+    mmu_cleanup(&mmu);
+}
@@ -7,6 +7,9 @@
 
 #include "../../src/common.h"
 #include "../../src/ppu.h"
+#include "../../src/framebuffer.h"
+#include "../../src/golden.h"
+#include "../../src/render_thread.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -21,6 +24,12 @@ void test_ppu_hblank(void);
 void test_ppu_vblank(void);
 void test_ppu_render_line(void);
 void test_ppu_palettes(void);
+void test_ppu_stat_interrupt(void);
+void test_ppu_render_policy(void);
+void test_ppu_frame_ready(void);
+void test_ppu_framebuffer_convert(void);
+void test_ppu_frame_hash(void);
+void test_ppu_render_thread(void);
 
 // Table des tests PPU
 typedef struct {
@@ -38,6 +47,12 @@ UnitTest ppu_tests[] = {
     {"PPU VBlank", test_ppu_vblank},
     {"PPU Render Line", test_ppu_render_line},
     {"PPU Palettes", test_ppu_palettes},
+    {"PPU STAT Interrupt", test_ppu_stat_interrupt},
+    {"PPU Render Policy", test_ppu_render_policy},
+    {"PPU Frame Ready", test_ppu_frame_ready},
+    {"PPU Framebuffer Convert", test_ppu_framebuffer_convert},
+    {"PPU Frame Hash", test_ppu_frame_hash},
+    {"PPU Render Thread", test_ppu_render_thread},
     {NULL, NULL} // Marqueur de fin
 };
 
@@ -326,7 +341,7 @@ void test_ppu_render_line(void) {
     // La première ligne devrait contenir des pixels
     bool has_pixels = false;
     for (int x = 0; x < 8; x++) { // 8 pixels pour une tuile
-        if (ppu.framebuffer[x] != 0xFFFFFFFF) { // Couleur par défaut
+        if (ppu.framebuffer[x] != 0) { // Teinte par défaut (blanc)
             has_pixels = true;
             break;
         }
@@ -365,3 +380,342 @@ void test_ppu_palettes(void) {
     assert(color2 == 0x555555FF); // Gris foncé
     assert(color3 == 0x000000FF); // Noir
 }
+
+void test_ppu_stat_interrupt(void) {
+    PPU ppu;
+    u8 vram[0x2000];
+
+    ppu_init(&ppu);
+    memset(vram, 0, sizeof(vram));
+
+    // Source LYC=LY: front montant quand LY atteint LYC
+    ppu_write(&ppu, LYC_REG, 2);
+    ppu_write(&ppu, STAT_REG, 0x40);
+    int stat_irqs = 0;
+    for (int i = 0; i < 456 * 2; i++) {
+        if (ppu_tick(&ppu, 1, vram) & LCD_STAT_INT) stat_irqs++;
+    }
+    assert(ppu.ly == 2);
+    assert(ppu.stat & 0x04);  // Coïncidence
+    assert(stat_irqs == 1);
+
+    // Ligne maintenue haute pendant toute la ligne 2: pas de nouveau front
+    for (int i = 0; i < 455; i++) {
+        assert(!(ppu_tick(&ppu, 1, vram) & LCD_STAT_INT));
+    }
+
+    // Source HBlank: une IRQ par ligne visible
+    ppu_write(&ppu, STAT_REG, 0x08);
+    stat_irqs = 0;
+    for (int i = 0; i < 456 * 4; i++) {
+        if (ppu_tick(&ppu, 1, vram) & LCD_STAT_INT) stat_irqs++;
+    }
+    assert(stat_irqs == 4);
+
+    // Sources LYC et HBlank combinées: la ligne OU ne crée pas de front entre elles
+    ppu_init(&ppu);
+    ppu_write(&ppu, LYC_REG, 0);
+    assert(ppu_tick(&ppu, 1, vram) == 0);  // Aucune source active
+    ppu_write(&ppu, STAT_REG, 0x48);
+    assert(ppu_tick(&ppu, 1, vram) & LCD_STAT_INT);
+    stat_irqs = 0;
+    for (int i = 0; i < 455; i++) {
+        if (ppu_tick(&ppu, 1, vram) & LCD_STAT_INT) stat_irqs++;
+    }
+    assert(stat_irqs == 0);  // HBlank de la ligne 0 masqué par LYC déjà haut
+
+    // LCD éteint: aucune IRQ, LY figé à 0
+    ppu_write(&ppu, LCDC_REG, 0x11);
+    assert(ppu.ly == 0 && ppu.mode == PPU_MODE_HBLANK);
+    for (int i = 0; i < 456 * 3; i++) {
+        assert(ppu_tick(&ppu, 1, vram) == 0);
+    }
+    assert(ppu.ly == 0);
+}
+
+// Avance d'une frame complète (70224 dots) et indique si la ligne 0 a été rendue
+static bool run_frame_and_check_render(PPU* ppu, u8* vram) {
+    ppu->framebuffer[0] = 0;
+    for (int i = 0; i < 154 * 456; i++) {
+        ppu_tick(ppu, 1, vram);
+    }
+    return ppu->framebuffer[0] != 0;
+}
+
+void test_ppu_render_policy(void) {
+    PPU ppu;
+    u8 vram[0x2000];
+
+    memset(vram, 0, sizeof(vram));
+    vram[0x0000] = 0xFF; // Tuile 0, ligne 0: pixels non blancs
+
+    // Jamais: timing et VBlank continuent, framebuffer intact
+    ppu_init(&ppu);
+    ppu_set_render_policy(&ppu, PPU_RENDER_NEVER, 1);
+    ppu_reset(&ppu);
+    assert(!run_frame_and_check_render(&ppu, vram));
+    assert(ppu.frame_count == 1);
+    assert(ppu.ly == 0);
+
+    // Une frame sur 2
+    ppu_init(&ppu);
+    ppu_set_render_policy(&ppu, PPU_RENDER_EVERY_N, 2);
+    ppu_reset(&ppu);
+    assert(run_frame_and_check_render(&ppu, vram));
+    assert(!run_frame_and_check_render(&ppu, vram));
+    assert(run_frame_and_check_render(&ppu, vram));
+
+    // À la demande: seule la frame suivant la demande est rendue
+    ppu_init(&ppu);
+    ppu_set_render_policy(&ppu, PPU_RENDER_ON_DEMAND, 1);
+    ppu_reset(&ppu);
+    assert(!run_frame_and_check_render(&ppu, vram));
+    ppu_request_frame(&ppu);
+    assert(run_frame_and_check_render(&ppu, vram));
+    assert(!run_frame_and_check_render(&ppu, vram));
+}
+
+void test_ppu_frame_ready(void) {
+    PPU ppu;
+    u8 vram[0x2000];
+
+    ppu_init(&ppu);
+    memset(vram, 0, sizeof(vram));
+
+    // Signal levé une seule fois par frame, à l'entrée en VBlank
+    int ready_count = 0;
+    for (int i = 0; i < 154 * 456 * 2; i++) {
+        ppu_tick(&ppu, 1, vram);
+        if (ppu_frame_ready(&ppu)) {
+            assert(ppu.ly == 144);
+            ready_count++;
+        }
+    }
+    assert(ready_count == 2);
+
+    // Frame sautée par la politique (appliquée à la frame suivante): pas de signal
+    ppu_set_render_policy(&ppu, PPU_RENDER_NEVER, 1);
+    for (int i = 0; i < 154 * 456; i++) {
+        ppu_tick(&ppu, 1, vram);
+    }
+    ppu_frame_ready(&ppu);
+    for (int i = 0; i < 154 * 456 * 2; i++) {
+        ppu_tick(&ppu, 1, vram);
+        assert(!ppu_frame_ready(&ppu));
+    }
+
+    // Rendu complet sans modifier LY
+    vram[0x0000] = 0xFF;
+    ppu.ly = 77;
+    ppu_render_frame(&ppu, vram);
+    assert(ppu.ly == 77);
+    assert(ppu.framebuffer[0] != 0);
+}
+
+void test_ppu_framebuffer_convert(void) {
+    PPU ppu;
+    u8 vram[0x2000];
+
+    ppu_init(&ppu);
+    memset(vram, 0, sizeof(vram));
+
+    // Le PPU stocke la teinte après BGP, pas la couleur
+    vram[0x0000] = 0xFF;          // Pixels de couleur 1 sur la première ligne
+    ppu.bgp = 0xE4;
+    ppu_render_line(&ppu, vram);
+    assert(ppu.framebuffer[0] == 1);
+    ppu.bgp = 0x0C;               // Couleur 1 -> teinte 3
+    ppu_render_line(&ppu, vram);
+    assert(ppu.framebuffer[0] == 3);
+
+    // Motif couvrant les 4 teintes
+    static u8 indexed[FB_PIXELS];
+    for (int i = 0; i < FB_PIXELS; i++) {
+        indexed[i] = (u8)((i * 7 + (i >> 3)) & 3);
+    }
+
+    static u32 rgba[FB_PIXELS];
+    static u16 rgb565[FB_PIXELS];
+    static u8 gray[FB_PIXELS];
+    static u8 rgb[FB_PIXELS * 3];
+    static u8 bgr[FB_PIXELS * 3];
+    fb_convert(indexed, rgba, FB_FORMAT_RGBA8888, &FB_PALETTE_GRAY);
+    fb_convert(indexed, rgb565, FB_FORMAT_RGB565, &FB_PALETTE_GRAY);
+    fb_convert(indexed, gray, FB_FORMAT_GRAY8, &FB_PALETTE_GRAY);
+    fb_convert(indexed, rgb, FB_FORMAT_RGB24, &FB_PALETTE_GREEN);
+    fb_convert(indexed, bgr, FB_FORMAT_BGR24, &FB_PALETTE_GREEN);
+
+    static const u32 gray_rgba[4] = { 0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF, 0x000000FF };
+    static const u16 gray_565[4] = { 0xFFFF, 0xAD55, 0x52AA, 0x0000 };
+    for (int i = 0; i < FB_PIXELS; i++) {
+        u8 t = indexed[i];
+        assert(rgba[i] == gray_rgba[t]);
+        assert(rgb565[i] == gray_565[t]);
+        assert(gray[i] == (u8)(FB_PALETTE_GRAY.rgb[t] & 0xFF));
+        u32 c = FB_PALETTE_GREEN.rgb[t];
+        assert(rgb[i * 3] == (u8)(c >> 16) && rgb[i * 3 + 2] == (u8)c);
+        assert(bgr[i * 3] == (u8)c && bgr[i * 3 + 2] == (u8)(c >> 16));
+    }
+
+    // Nombre de pixels impair: fin non vectorisée après les blocs SSE2
+    u8 lut_rgb[4][3];
+    for (int t = 0; t < 4; t++) {
+        u32 c = FB_PALETTE_GREEN.rgb[t];
+        lut_rgb[t][0] = (u8)(c >> 16);
+        lut_rgb[t][1] = (u8)(c >> 8);
+        lut_rgb[t][2] = (u8)c;
+    }
+    const u8* odd = indexed + 5;
+    memset(rgba, 0, 24 * sizeof(u32));
+    memset(rgb565, 0, 24 * sizeof(u16));
+    memset(gray, 0, 24);
+    memset(rgb, 0, 24 * 3);
+    memset(bgr, 0, 24 * 3);
+    fb_convert_n(odd, rgba, 23, FB_FORMAT_RGBA8888, &FB_PALETTE_GRAY);
+    fb_convert_n(odd, rgb565, 23, FB_FORMAT_RGB565, &FB_PALETTE_GRAY);
+    fb_convert_n(odd, gray, 23, FB_FORMAT_GRAY8, &FB_PALETTE_GRAY);
+    fb_convert_n(odd, rgb, 23, FB_FORMAT_RGB24, &FB_PALETTE_GREEN);
+    fb_convert_n(odd, bgr, 23, FB_FORMAT_BGR24, &FB_PALETTE_GREEN);
+    for (int i = 0; i < 23; i++) {
+        u8 t = odd[i];
+        assert(rgba[i] == gray_rgba[t]);
+        assert(rgb565[i] == gray_565[t]);
+        assert(gray[i] == (u8)(FB_PALETTE_GRAY.rgb[t] & 0xFF));
+        for (int k = 0; k < 3; k++) {
+            assert(rgb[i * 3 + k] == lut_rgb[t][k]);
+            assert(bgr[i * 3 + k] == lut_rgb[t][2 - k]);
+        }
+    }
+    // Rien d'écrit au-delà du dernier pixel
+    assert(rgba[23] == 0 && rgb565[23] == 0 && gray[23] == 0);
+    assert(rgb[69] == 0 && rgb[70] == 0 && rgb[71] == 0 && bgr[69] == 0);
+
+    // Compactage 2 bits/pixel réversible
+    static u8 packed[FB_PACKED_SIZE];
+    static u8 unpacked[FB_PIXELS];
+    fb_pack_2bpp(indexed, packed);
+    fb_unpack_2bpp(packed, unpacked);
+    assert(memcmp(indexed, unpacked, FB_PIXELS) == 0);
+}
+
+void test_ppu_frame_hash(void) {
+    // Vecteurs de référence xxHash64 (graine 0)
+    assert(fb_hash64("", 0, 0) == 0xEF46DB3751D8E999ULL);
+    assert(fb_hash64("abc", 3, 0) == 0x44BC2CF5AD770999ULL);
+
+    // Un pixel modifié change l'empreinte
+    static u8 frame[FB_PIXELS];
+    memset(frame, 0, sizeof(frame));
+    u64 h0 = fb_hash64(frame, FB_PIXELS, 0);
+    frame[FB_PIXELS - 1] = 1;
+    u64 h1 = fb_hash64(frame, FB_PIXELS, 0);
+    assert(h0 != h1);
+
+    // Manifeste: frames 0, 2 et 4 attendues, divergence à la frame 4
+    GoldenCheck golden;
+    golden_init(&golden, 2);
+    golden_add_expected(&golden, 4, h1);   // Insertion dans le désordre
+    golden_add_expected(&golden, 0, h0);
+    golden_add_expected(&golden, 2, h0);
+    golden_add_expected(&golden, 6, h0);   // Jamais atteinte
+
+    assert(golden_wants_frame(&golden, 0));
+    assert(!golden_wants_frame(&golden, 1));
+    assert(golden_check_frame(&golden, 0, h0));
+    assert(golden_check_frame(&golden, 2, h0));
+    assert(!golden_check_frame(&golden, 4, h0));
+    assert(golden.diverged && golden.first_divergent_frame == 4);
+    assert(golden.expected_hash == h1 && golden.actual_hash == h0);
+
+    assert(!golden_finish(&golden));
+    assert(golden.matched == 2 && golden.mismatches == 1 && golden.missing == 1);
+    golden_cleanup(&golden);
+
+    // Manifeste chargé dont une frame n'est jamais atteinte: échec sans divergence
+    const char* path = "test_golden_manifest.txt";
+    FILE* f = fopen(path, "w");
+    assert(f != NULL);
+    fprintf(f, "# frame hash\n0 %016llx\n5000 %016llx\n", (unsigned long long)h0, (unsigned long long)h0);
+    fclose(f);
+    golden_init(&golden, 1);
+    assert(golden_load_manifest(&golden, path));
+    remove(path);
+    assert(golden.count == 2);
+    assert(golden_check_frame(&golden, 0, h0));
+    assert(golden_check_frame(&golden, 1, h1));  // Absente du manifeste
+    assert(!golden_finish(&golden));
+    assert(!golden.diverged && golden.matched == 1 && golden.missing == 1);
+    golden_cleanup(&golden);
+
+    // Sans manifeste: journalisation seule, toujours en succès
+    golden_init(&golden, 1);
+    assert(golden_check_frame(&golden, 0, h0));
+    assert(golden_finish(&golden));
+    golden_cleanup(&golden);
+}
+
+// Empreintes des frames produites par le thread de rendu
+typedef struct {
+    u32 frames;
+    u64 hash[8];
+} RenderCapture;
+
+static void capture_rendered_frame(void* user, u32 frame, const u8* framebuffer) {
+    RenderCapture* capture = (RenderCapture*)user;
+    if (frame < 8) {
+        capture->hash[frame] = fb_hash64(framebuffer, FB_PIXELS, 0);
+    }
+    capture->frames++;
+}
+
+void test_ppu_render_thread(void) {
+    static PPU ppu;
+    static u8 vram[0x2000];
+    static RenderThread rt;
+    static RenderCapture capture;
+    u32 vram_writes = 1;
+    u64 inline_hash[6];
+
+    ppu_init(&ppu);
+    memset(vram, 0, sizeof(vram));
+    memset(&capture, 0, sizeof(capture));
+    vram[0x0000] = 0xFF;  // Tuile 0, ligne 0: couleur 1
+
+    assert(render_thread_start(&rt, vram, &vram_writes, capture_rendered_frame, &capture));
+    render_thread_attach(&rt, &ppu);
+
+    // Le rendu en ligne (politique ALWAYS) sert de référence
+    bool changed = false;
+    u32 frame = 0;
+    while (frame < 6) {
+        ppu_tick(&ppu, 4, vram);
+        // Écritures en milieu de frame (HBlank de la ligne 72): VRAM et SCY
+        if (!changed && ppu.ly == 72 && ppu.mode == PPU_MODE_HBLANK) {
+            vram[0x0002] = 0xFF;
+            vram_writes++;
+            ppu_write(&ppu, SCY_REG, 1);
+            changed = true;
+        }
+        if (ppu_frame_ready(&ppu)) {
+            inline_hash[frame++] = fb_hash64(ppu.framebuffer, FB_PIXELS, 0);
+        }
+    }
+    render_thread_stop(&rt);
+
+    assert(capture.frames == 6);
+    for (int i = 0; i < 6; i++) {
+        assert(capture.hash[i] == inline_hash[i]);
+    }
+    assert(inline_hash[0] != inline_hash[1]);
+
+    // Copies VRAM: 2 pour la frame 0, 1 par job pour les frames 1-3
+    // (version changée), puis réutilisation d'une frame à l'autre
+    assert(rt.vram_copies_made == 4);
+
+    // Sortie la plus récente disponible pour la présentation
+    u32 latest = 0;
+    assert(render_thread_latest_frame(&rt, &latest) != NULL);
+    assert(latest == 5);
+    assert(render_thread_latest_frame(&rt, NULL) == NULL);
+    ppu_set_observer(&ppu, NULL);
+}
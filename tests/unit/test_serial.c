@@ -0,0 +1,411 @@
+/**
+ * TESTS UNITAIRES POUR LE PORT SÉRIE
+ *
+ * Ce fichier contient des tests unitaires pour valider le port série:
+ * durée des transferts, interruption, tampon de sortie, flux optionnel et
+ * câble link entre deux ports (quanta alternés ou deux threads).
+ */
+
+#include "../../src/common.h"
+#include "../../src/serial.h"
+#include "../../src/scheduler.h"
+#include "../../src/link.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Prototypes des fonctions de test
+void test_serial_init(void);
+void test_serial_transfer(void);
+void test_serial_external_clock(void);
+void test_serial_output_buffer(void);
+void test_serial_stream(void);
+void test_serial_scheduled_transfer(void);
+void test_link_exchange(void);
+void test_link_threads(void);
+
+// Table des tests Série
+typedef struct {
+    const char* name;
+    void (*test_func)(void);
+} UnitTest;
+
+UnitTest serial_tests[] = {
+    {"Série Initialisation", test_serial_init},
+    {"Série Transfert", test_serial_transfer},
+    {"Série Horloge Externe", test_serial_external_clock},
+    {"Série Tampon de Sortie", test_serial_output_buffer},
+    {"Série Flux", test_serial_stream},
+    {"Série Transfert Programmé", test_serial_scheduled_transfer},
+    {"Câble Échange", test_link_exchange},
+    {"Câble Threads", test_link_threads},
+    {NULL, NULL} // Marqueur de fin
+};
+
+/**
+ * FONCTION PRINCIPALE DE TEST
+ */
+int main(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+
+    printf("=== TESTS UNITAIRES SÉRIE ===\n\n");
+
+    int passed = 0;
+    int total = 0;
+
+    for (int i = 0; serial_tests[i].name != NULL; i++) {
+        printf("Test %d: %s... ", i + 1, serial_tests[i].name);
+        fflush(stdout);
+
+        // Exécuter le test
+        serial_tests[i].test_func();
+
+        printf("PASS\n");
+        passed++;
+        total++;
+    }
+
+    printf("\n=== RÉSULTATS ===\n");
+    printf("Tests passés: %d/%d\n", passed, total);
+
+    if (passed == total) {
+        printf("✅ TOUS LES TESTS SONT PASSÉS !\n");
+        return 0;
+    } else {
+        printf("❌ CERTAINS TESTS ONT ÉCHOUÉ\n");
+        return 1;
+    }
+}
+
+/**
+ * IMPLEMENTATION DES TESTS
+ */
+
+// Envoie un octet en horloge interne et attend la fin du transfert
+static void serial_send(Serial* serial, u8 value) {
+    serial_write(serial, SB_REG, value);
+    serial_write(serial, SC_REG, 0x81);
+    while (serial_read(serial, SC_REG) & 0x80) {
+        serial_tick(serial, 4);
+    }
+}
+
+void test_serial_init(void) {
+    Serial serial;
+
+    serial_init(&serial);
+
+    // Valeurs après boot (Pan Docs)
+    assert(serial_read(&serial, SB_REG) == 0x00);
+    assert(serial_read(&serial, SC_REG) == 0x7E);
+    assert(!serial.transferring);
+    assert(!serial.interrupt_pending);
+
+    u32 length = 1;
+    serial_output(&serial, &length);
+    assert(length == 0);
+
+    serial_cleanup(&serial);
+}
+
+void test_serial_transfer(void) {
+    Serial serial;
+
+    serial_init(&serial);
+
+    // Horloge interne: SC bit 7 reste levé pendant 8 x 512 cycles
+    serial_write(&serial, SB_REG, 'P');
+    serial_write(&serial, SC_REG, 0x81);
+    assert(serial_read(&serial, SC_REG) == 0xFF);
+
+    for (int i = 0; i < SERIAL_TRANSFER_CYCLES / 4 - 1; i++) {
+        serial_tick(&serial, 4);
+    }
+    assert(serial_read(&serial, SC_REG) & 0x80);
+    assert(!serial.interrupt_pending);
+
+    // Fin de transfert: SC bit 7 retombe, SB reçoit 0xFF (pas de partenaire), IRQ
+    serial_tick(&serial, 4);
+    assert(serial_read(&serial, SC_REG) == 0x7F);
+    assert(serial_read(&serial, SB_REG) == 0xFF);
+    assert(serial_get_interrupts(&serial) == 0x08);
+    assert(serial_get_interrupts(&serial) == 0x00);
+
+    u32 length = 0;
+    const u8* output = serial_output(&serial, &length);
+    assert(length == 1 && output[0] == 'P');
+
+    // Annulation: remettre SC bit 7 à 0 arrête le transfert
+    serial_write(&serial, SB_REG, 'X');
+    serial_write(&serial, SC_REG, 0x81);
+    serial_write(&serial, SC_REG, 0x01);
+    for (int i = 0; i < SERIAL_TRANSFER_CYCLES; i++) {
+        serial_tick(&serial, 1);
+    }
+    serial_output(&serial, &length);
+    assert(length == 1);
+    assert(!serial.interrupt_pending);
+
+    serial_cleanup(&serial);
+}
+
+void test_serial_external_clock(void) {
+    Serial serial;
+
+    serial_init(&serial);
+
+    // Horloge externe sans câble: le transfert ne se termine jamais
+    serial_write(&serial, SB_REG, 0x42);
+    serial_write(&serial, SC_REG, 0x80);
+    for (int i = 0; i < 4 * SERIAL_TRANSFER_CYCLES; i++) {
+        serial_tick(&serial, 1);
+    }
+    assert(serial_read(&serial, SC_REG) & 0x80);
+    assert(serial_read(&serial, SB_REG) == 0x42);
+    assert(!serial.interrupt_pending);
+
+    u32 length = 1;
+    serial_output(&serial, &length);
+    assert(length == 0);
+
+    serial_cleanup(&serial);
+}
+
+void test_serial_output_buffer(void) {
+    Serial serial;
+
+    serial_init(&serial);
+
+    // Plus d'octets que la capacité initiale: le tampon grandit
+    const char* message = "cpu_instrs\n\nPassed all tests\n";
+    for (int n = 0; n < 20; n++) {
+        for (const char* c = message; *c; c++) {
+            serial_send(&serial, (u8)*c);
+        }
+    }
+    serial_send(&serial, 0x00);
+    serial_send(&serial, 'F');
+
+    u32 length = 0;
+    const u8* output = serial_output(&serial, &length);
+    assert(length == 20 * strlen(message) + 2);
+    assert(serial.output_capacity > SERIAL_OUTPUT_INITIAL);
+    assert(memcmp(output, message, strlen(message)) == 0);
+
+    // Recherche en mémoire, y compris après un octet nul
+    assert(serial_output_contains(&serial, "Passed"));
+    assert(!serial_output_contains(&serial, "Failed"));
+    assert(serial_output_contains(&serial, "F"));
+    assert(serial_output_contains(&serial, ""));
+
+    // Reset: sortie vidée, tampon conservé
+    serial_reset(&serial);
+    serial_output(&serial, &length);
+    assert(length == 0);
+    assert(!serial_output_contains(&serial, "Passed"));
+
+    serial_cleanup(&serial);
+}
+
+void test_serial_stream(void) {
+    Serial serial;
+    FILE* stream = tmpfile();
+    assert(stream != NULL);
+
+    serial_init(&serial);
+    serial_set_stream(&serial, stream);
+
+    // Rien n'est écrit avant le vidage
+    serial_send(&serial, 'O');
+    serial_send(&serial, 'K');
+    assert(ftell(stream) == 0);
+
+    // Un vidage écrit tous les octets en attente, une seule fois
+    serial_flush(&serial);
+    assert(ftell(stream) == 2);
+    serial_flush(&serial);
+    assert(ftell(stream) == 2);
+
+    serial_send(&serial, '\n');
+    serial_cleanup(&serial);  // Vide les derniers octets
+
+    char text[8] = {0};
+    rewind(stream);
+    assert(fread(text, 1, sizeof(text), stream) == 3);
+    assert(strcmp(text, "OK\n") == 0);
+    fclose(stream);
+}
+
+void test_serial_scheduled_transfer(void) {
+    Scheduler sched;
+    u64 clock = 0;
+    Serial serial;
+
+    scheduler_init(&sched);
+    serial_init(&serial);
+
+    // Sans horloge maître, pas d'événement possible
+    assert(!serial_set_scheduler(&serial, &sched));
+    serial_set_clock(&serial, &clock);
+    assert(serial_set_scheduler(&serial, &sched));
+    assert(scheduler_when(&sched, serial.transfer_event) == SCHEDULER_NEVER);
+
+    // La fin du transfert est un événement daté: IRQ sans lecture de SC
+    clock = 100;
+    serial_write(&serial, SB_REG, 'Z');
+    serial_write(&serial, SC_REG, 0x81);
+    assert(scheduler_when(&sched, serial.transfer_event) == 100 + SERIAL_TRANSFER_CYCLES);
+
+    u64 fired = 0;
+    while (fired == 0) {
+        clock += 4;
+        if (clock >= sched.next) {
+            scheduler_run(&sched, clock);
+        }
+        if (serial_get_interrupts(&serial)) {
+            fired = clock;
+        }
+    }
+    assert(fired == 100 + SERIAL_TRANSFER_CYCLES);
+    assert(serial_output_contains(&serial, "Z"));
+    assert(scheduler_when(&sched, serial.transfer_event) == SCHEDULER_NEVER);
+
+    // Transfert annulé: l'événement aussi
+    serial_write(&serial, SC_REG, 0x81);
+    serial_write(&serial, SC_REG, 0x00);
+    assert(scheduler_when(&sched, serial.transfer_event) == SCHEDULER_NEVER);
+
+    serial_cleanup(&serial);
+}
+
+// Extrémité de test: un port série sur sa propre horloge maître. Le maître
+// envoie 0x00, 0x01, ... à chaque fin de transfert; l'esclave renvoie
+// l'octet reçu + 0x80 et se remet en attente.
+typedef struct {
+    Serial serial;
+    u64 clock;
+    bool master;
+    u32 irq_count;
+    u64 irq_at[16];
+    u8 irq_sb[16];
+} LinkTestEnd;
+
+static void link_test_end_init(LinkTestEnd* end, bool master) {
+    memset(end, 0, sizeof(LinkTestEnd));
+    serial_init(&end->serial);
+    serial_set_clock(&end->serial, &end->clock);
+    end->master = master;
+}
+
+static bool link_test_run(void* user, u64 until) {
+    LinkTestEnd* end = (LinkTestEnd*)user;
+    while (end->clock < until) {
+        end->clock += 4;
+        serial_sync(&end->serial);
+        if (!serial_get_interrupts(&end->serial)) continue;
+
+        u8 sb = serial_read(&end->serial, SB_REG);
+        if (end->irq_count < 16) {
+            end->irq_at[end->irq_count] = end->clock;
+            end->irq_sb[end->irq_count] = sb;
+        }
+        end->irq_count++;
+        if (end->master) {
+            serial_write(&end->serial, SB_REG, (u8)end->irq_count);
+            serial_write(&end->serial, SC_REG, 0x81);
+        } else {
+            serial_write(&end->serial, SB_REG, (u8)(sb + 0x80));
+            serial_write(&end->serial, SC_REG, 0x80);
+        }
+    }
+    return true;
+}
+
+void test_link_exchange(void) {
+    LinkTestEnd a, b;
+    LinkCable link;
+
+    // Esclave en attente avant le branchement: relevé à l'initialisation
+    link_test_end_init(&a, true);
+    link_test_end_init(&b, false);
+    serial_write(&b.serial, SB_REG, 0x99);
+    serial_write(&b.serial, SC_REG, 0x80);
+    link_init(&link, &a.serial, &b.serial, LINK_QUANTUM_CYCLES);
+    assert(a.serial.peer_ready && a.serial.peer_sb == 0x99);
+
+    // Un seul transfert: le maître reçoit SB esclave à l'heure exacte,
+    // l'esclave reçoit l'octet à la frontière suivante
+    a.master = false;  // Pas de relance automatique
+    serial_write(&a.serial, SB_REG, 0x42);
+    serial_write(&a.serial, SC_REG, 0x81);
+    u64 reached = link_run(&link, link_test_run, &a, &b, 2 * SERIAL_TRANSFER_CYCLES, false);
+    assert(reached == 2 * SERIAL_TRANSFER_CYCLES);
+    assert(a.irq_count >= 1 && a.irq_at[0] == SERIAL_TRANSFER_CYCLES && a.irq_sb[0] == 0x99);
+    assert(b.irq_count == 1 && b.irq_sb[0] == 0x42);
+    assert(b.irq_at[0] > SERIAL_TRANSFER_CYCLES && b.irq_at[0] <= SERIAL_TRANSFER_CYCLES + LINK_QUANTUM_CYCLES);
+    assert(link.exchanges == 1);
+    assert(serial_output_contains(&a.serial, "\x42"));
+    assert(serial_output_contains(&b.serial, "\x99"));
+    link_disconnect(&link);
+    serial_cleanup(&a.serial);
+    serial_cleanup(&b.serial);
+
+    // Partenaire pas prêt (SC bit 7 à 0): le maître reçoit 0xFF, rien n'est
+    // livré. Branchement après 10000 cycles: les frontières partent de là
+    link_test_end_init(&a, false);
+    link_test_end_init(&b, false);
+    a.clock = b.clock = 10000;
+    link_init(&link, &a.serial, &b.serial, LINK_QUANTUM_CYCLES);
+    assert(link.now == 10000);
+    serial_write(&a.serial, SB_REG, 0x42);
+    serial_write(&a.serial, SC_REG, 0x81);
+    reached = link_run(&link, link_test_run, &a, &b, 2 * SERIAL_TRANSFER_CYCLES, false);
+    assert(reached == 10000 + 2 * SERIAL_TRANSFER_CYCLES);
+    assert(a.irq_count == 1 && a.irq_sb[0] == 0xFF);
+    assert(b.irq_count == 0 && serial_read(&b.serial, SB_REG) == 0x00);
+    assert(link.exchanges == 0);
+    link_disconnect(&link);
+    serial_cleanup(&a.serial);
+    serial_cleanup(&b.serial);
+}
+
+// Même scénario en quanta alternés et sur deux threads: résultats identiques
+static void link_test_session(LinkTestEnd* a, LinkTestEnd* b, bool threaded) {
+    LinkCable link;
+
+    link_test_end_init(a, true);
+    link_test_end_init(b, false);
+    serial_write(&b->serial, SC_REG, 0x80);
+    link_init(&link, &a->serial, &b->serial, 512);
+    serial_write(&a->serial, SC_REG, 0x81);
+
+    u64 reached = link_run(&link, link_test_run, a, b, 12 * SERIAL_TRANSFER_CYCLES + 100, threaded);
+    assert(reached == 12 * SERIAL_TRANSFER_CYCLES + 100);
+    assert(link.quanta == (reached + 511) / 512);
+    link_disconnect(&link);
+}
+
+void test_link_threads(void) {
+    LinkTestEnd a1, b1, a2, b2;
+
+    link_test_session(&a1, &b1, false);
+    link_test_session(&a2, &b2, true);
+
+    // Chaque maître a relancé un transfert à chaque fin, l'esclave a répondu
+    assert(a1.irq_count >= 10 && b1.irq_count >= 10);
+    assert(a1.irq_sb[0] == 0x00 && b1.irq_sb[0] == 0x00);  // SB initiaux
+    assert(a1.irq_sb[1] == 0x80);           // Réponse de l'esclave au premier octet
+    assert(b1.irq_sb[1] == 0x01);           // Deuxième octet du maître
+
+    assert(a1.irq_count == a2.irq_count && b1.irq_count == b2.irq_count);
+    assert(memcmp(a1.irq_at, a2.irq_at, sizeof(a1.irq_at)) == 0);
+    assert(memcmp(a1.irq_sb, a2.irq_sb, sizeof(a1.irq_sb)) == 0);
+    assert(memcmp(b1.irq_at, b2.irq_at, sizeof(b1.irq_at)) == 0);
+    assert(memcmp(b1.irq_sb, b2.irq_sb, sizeof(b1.irq_sb)) == 0);
+    assert(serial_read(&a1.serial, SB_REG) == serial_read(&a2.serial, SB_REG));
+
+    serial_cleanup(&a1.serial);
+    serial_cleanup(&b1.serial);
+    serial_cleanup(&a2.serial);
+    serial_cleanup(&b2.serial);
+}
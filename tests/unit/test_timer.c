@@ -7,6 +7,7 @@
 
 #include "../../src/common.h"
 #include "../../src/timer.h"
+#include "../../src/scheduler.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -19,6 +20,8 @@ void test_timer_tima_counter(void);
 void test_timer_overflow(void);
 void test_timer_frequencies(void);
 void test_timer_control(void);
+void test_timer_glitches(void);
+void test_timer_scheduled_overflow(void);
 
 // Table des tests Timer
 typedef struct {
@@ -34,6 +37,8 @@ UnitTest timer_tests[] = {
     {"Timer Overflow", test_timer_overflow},
     {"Timer Frequencies", test_timer_frequencies},
     {"Timer Control", test_timer_control},
+    {"Timer Glitches DIV/TAC", test_timer_glitches},
+    {"Timer Débordement Programmé", test_timer_scheduled_overflow},
     {NULL, NULL} // Marqueur de fin
 };
 
@@ -83,13 +88,12 @@ void test_timer_init(void) {
     timer_init(&timer);
 
     // Vérifier les valeurs par défaut
-    assert(timer.div == 0);
-    assert(timer.tima == 0);
-    assert(timer.tma == 0);
-    assert(timer.tac == 0);
-    assert(timer.div_cycles == 0);
-    assert(timer.tima_cycles == 0);
-    assert(timer.tima_period == 0);
+    assert(timer_read(&timer, DIV_REG) == 0);
+    assert(timer_read(&timer, TIMA_REG) == 0);
+    assert(timer_read(&timer, TMA_REG) == 0);
+    assert(timer_read(&timer, TAC_REG) == 0);
+    assert(timer.counter == 0);
+    assert(!timer.reloading);
     assert(!timer.interrupt_pending);
 }
 
@@ -99,18 +103,21 @@ void test_timer_reset(void) {
     timer_init(&timer);
 
     // Modifier quelques valeurs
-    timer.div = 10;
-    timer.tima = 50;
-    timer.tac = 0x04;
-    timer.interrupt_pending = true;
+    timer_write(&timer, TAC_REG, 0x05);
+    timer_write(&timer, TIMA_REG, 0xFF);
+    for (int i = 0; i < 600; i++) {
+        timer_tick(&timer, 1);
+    }
+    assert(timer.interrupt_pending);
 
     // Reset
     timer_reset(&timer);
 
     // Vérifier que c'est revenu aux valeurs par défaut
-    assert(timer.div == 0);
-    assert(timer.tima == 0);
-    assert(timer.tac == 0);
+    assert(timer_read(&timer, DIV_REG) == 0);
+    assert(timer_read(&timer, TIMA_REG) == 0);
+    assert(timer_read(&timer, TAC_REG) == 0);
+    assert(!timer.reloading);
     assert(!timer.interrupt_pending);
 }
 
@@ -124,15 +131,21 @@ void test_timer_div_counter(void) {
         timer_tick(&timer, 1);
     }
 
-    assert(timer.div == 1);
-    assert(timer.div_cycles == 0);
+    assert(timer_read(&timer, DIV_REG) == 1);
+    assert(timer.counter == 256);
 
     // Test plusieurs incréments
     for (int i = 0; i < 512; i++) {
         timer_tick(&timer, 1);
     }
 
-    assert(timer.div == 3); // 256 + 256 + 512 = 3 incréments
+    assert(timer_read(&timer, DIV_REG) == 3); // 256 + 512 = 3 incréments
+
+    // DIV est l'octet haut du compteur 16 bits: il reboucle après 65536 cycles
+    for (int i = 0; i < 253 * 256; i++) {
+        timer_tick(&timer, 1);
+    }
+    assert(timer_read(&timer, DIV_REG) == 0);
 }
 
 void test_timer_tima_counter(void) {
@@ -144,15 +157,20 @@ void test_timer_tima_counter(void) {
     timer_write(&timer, TAC_REG, 0x06); // Enable + freq 65536Hz
 
     // Vérifier la période calculée
-    assert(timer.tima_period == 64);
+    assert(timer_get_tima_period(timer.tac) == 64);
 
-    // Avancer de 64 cycles
-    for (int i = 0; i < 64; i++) {
+    // Avancer de 63 cycles: le bit 5 n'est pas encore retombé
+    for (int i = 0; i < 63; i++) {
         timer_tick(&timer, 1);
     }
+    assert(timer_read(&timer, TIMA_REG) == 0);
 
-    assert(timer.tima == 1);
-    assert(timer.tima_cycles == 0);
+    timer_tick(&timer, 1);
+    assert(timer_read(&timer, TIMA_REG) == 1);
+
+    // Un seul tick long compte tous les fronts d'un coup
+    timer_tick(&timer, 200);
+    assert(timer_read(&timer, TIMA_REG) == 4); // 264 cycles / 64
 }
 
 void test_timer_overflow(void) {
@@ -161,40 +179,66 @@ void test_timer_overflow(void) {
     timer_init(&timer);
 
     // Configurer TIMA
-    timer_write(&timer, TAC_REG, 0x05); // Enable + freq 65536Hz
+    timer_write(&timer, TAC_REG, 0x05); // Enable + freq 262144Hz
     timer_write(&timer, TMA_REG, 0xAA); // Valeur de reload
 
     // Mettre TIMA à 255 (valeur maximale)
-    timer.tima = 255;
+    timer_write(&timer, TIMA_REG, 0xFF);
+
+    // Pas de rechargement avant le front suivant
+    timer_tick(&timer, 15);
+    assert(timer_read(&timer, TIMA_REG) == 0xFF);
+    assert(!timer.interrupt_pending);
 
-    // Avancer d'un cycle pour déclencher l'overflow
+    // Débordement: TIMA vaut 0x00 pendant un M-cycle
     timer_tick(&timer, 1);
+    assert(timer_read(&timer, TIMA_REG) == 0x00);
+    assert(!timer.interrupt_pending);
 
-    // Vérifier l'overflow
-    assert(timer.tima == 0xAA); // Rechargé avec TMA
+    // Puis rechargement avec TMA et interruption
+    timer_tick(&timer, TIMER_RELOAD_DELAY);
+    assert(timer_read(&timer, TIMA_REG) == 0xAA); // Rechargé avec TMA
     assert(timer.interrupt_pending); // Interruption déclenchée
+    assert(timer_get_interrupts(&timer) == 0x04);
+    assert(!timer.interrupt_pending);
+
+    // Écrire TIMA pendant le délai annule rechargement et interruption
+    timer_write(&timer, TIMA_REG, 0xFF);
+    timer_tick(&timer, 12);                 // Compteur 20 -> 32: front suivant
+    assert(timer_read(&timer, TIMA_REG) == 0x00);
+    timer_write(&timer, TIMA_REG, 0x42);
+    timer_tick(&timer, TIMER_RELOAD_DELAY);
+    assert(timer_read(&timer, TIMA_REG) == 0x42);
+    assert(!timer.interrupt_pending);
 }
 
 void test_timer_frequencies(void) {
-    Timer timer;
-
-    timer_init(&timer);
-
     // Test fréquence 4096Hz (TAC = 0x04)
-    timer_write(&timer, TAC_REG, 0x04);
-    assert(timer.tima_period == 1024);
+    assert(timer_get_tima_period(0x04) == 1024);
+    assert(timer_get_tima_bit(0x04) == 0x0200);
 
     // Test fréquence 262144Hz (TAC = 0x05)
-    timer_write(&timer, TAC_REG, 0x05);
-    assert(timer.tima_period == 16);
+    assert(timer_get_tima_period(0x05) == 16);
+    assert(timer_get_tima_bit(0x05) == 0x0008);
 
     // Test fréquence 65536Hz (TAC = 0x06)
-    timer_write(&timer, TAC_REG, 0x06);
-    assert(timer.tima_period == 64);
+    assert(timer_get_tima_period(0x06) == 64);
+    assert(timer_get_tima_bit(0x06) == 0x0020);
 
     // Test fréquence 16384Hz (TAC = 0x07)
-    timer_write(&timer, TAC_REG, 0x07);
-    assert(timer.tima_period == 256);
+    assert(timer_get_tima_period(0x07) == 256);
+    assert(timer_get_tima_bit(0x07) == 0x0080);
+
+    // Une période complète de chaque fréquence donne exactement un incrément
+    for (u8 tac = 0x04; tac <= 0x07; tac++) {
+        Timer timer;
+        timer_init(&timer);
+        timer_write(&timer, TAC_REG, tac);
+        for (u32 i = 0; i < timer_get_tima_period(tac) * 3; i++) {
+            timer_tick(&timer, 1);
+        }
+        assert(timer_read(&timer, TIMA_REG) == 3);
+    }
 }
 
 void test_timer_control(void) {
@@ -204,26 +248,161 @@ void test_timer_control(void) {
 
     // Test écriture TAC
     timer_write(&timer, TAC_REG, 0x07); // Enable + freq 16384Hz
-    assert(timer.tac == 0x07);
-    assert(timer.tima_period == 256);
+    assert(timer_read(&timer, TAC_REG) == 0x07);
+    assert(timer_get_tima_period(timer.tac) == 256);
 
     // Test désactivation
     timer_write(&timer, TAC_REG, 0x00); // Disable
-    assert(timer.tac == 0x00);
-    assert(timer.tima_period == 0); // Pas de période quand désactivé
-
-    // Test écriture DIV (reset)
-    timer.div = 100;
-    timer.div_cycles = 150;
+    assert(timer_read(&timer, TAC_REG) == 0x00);
+    assert(timer_get_tima_period(timer.tac) == 0); // Pas de période quand désactivé
+    timer_tick(&timer, 255);
+    timer_tick(&timer, 255);
+    assert(timer_read(&timer, TIMA_REG) == 0);
+
+    // Test écriture DIV (reset du compteur interne complet)
+    assert(timer_read(&timer, DIV_REG) == 1);
     timer_write(&timer, DIV_REG, 0xFF); // Peu importe la valeur
-    assert(timer.div == 0);
-    assert(timer.div_cycles == 0);
+    assert(timer_read(&timer, DIV_REG) == 0);
+    assert(timer.counter == 0);
 
     // Test écriture TIMA
     timer_write(&timer, TIMA_REG, 0x42);
-    assert(timer.tima == 0x42);
+    assert(timer_read(&timer, TIMA_REG) == 0x42);
 
     // Test écriture TMA
     timer_write(&timer, TMA_REG, 0x99);
-    assert(timer.tma == 0x99);
+    assert(timer_read(&timer, TMA_REG) == 0x99);
+}
+
+void test_timer_glitches(void) {
+    Timer timer;
+
+    timer_init(&timer);
+    timer_write(&timer, TAC_REG, 0x05); // Bit 3 du compteur
+
+    // Écrire DIV quand le bit choisi vaut 1: front descendant, TIMA +1
+    timer_tick(&timer, 8);
+    assert(timer_read(&timer, TIMA_REG) == 0);
+    timer_write(&timer, DIV_REG, 0);
+    assert(timer_read(&timer, TIMA_REG) == 1);
+
+    // Bit choisi à 0: pas d'incrément
+    timer_tick(&timer, 4);
+    timer_write(&timer, DIV_REG, 0);
+    assert(timer_read(&timer, TIMA_REG) == 1);
+
+    // Le compteur repart de zéro: premier front 16 cycles plus tard
+    timer_tick(&timer, 15);
+    assert(timer_read(&timer, TIMA_REG) == 1);
+    timer_tick(&timer, 1);
+    assert(timer_read(&timer, TIMA_REG) == 2);
+
+    // Désactiver le timer avec le bit à 1: incrément parasite
+    timer_tick(&timer, 8);
+    timer_write(&timer, TAC_REG, 0x01);
+    assert(timer_read(&timer, TIMA_REG) == 3);
+
+    // Réactiver ne produit pas de front (montée)
+    timer_write(&timer, TAC_REG, 0x05);
+    assert(timer_read(&timer, TIMA_REG) == 3);
+
+    // Passer du bit 3 (à 1) au bit 5 (à 0): incrément parasite
+    assert(timer.counter == 24);
+    timer_write(&timer, TAC_REG, 0x06);
+    assert(timer_read(&timer, TIMA_REG) == 4);
+
+    // Incrément parasite sur 0xFF: débordement avec rechargement différé
+    timer_write(&timer, TAC_REG, 0x05);
+    timer_write(&timer, TMA_REG, 0x80);
+    timer_write(&timer, DIV_REG, 0);
+    timer_write(&timer, TIMA_REG, 0xFF);
+    timer_tick(&timer, 8);                  // Compteur 8: bit 3 à 1, pas de front
+    assert(timer_read(&timer, TIMA_REG) == 0xFF);
+    timer_write(&timer, DIV_REG, 0);
+    assert(timer_read(&timer, TIMA_REG) == 0x00);
+    timer_tick(&timer, TIMER_RELOAD_DELAY);
+    assert(timer_read(&timer, TIMA_REG) == 0x80);
+    assert(timer_get_interrupts(&timer) == 0x04);
+}
+
+void test_timer_scheduled_overflow(void) {
+    Scheduler sched;
+    u64 clock = 0;
+    Timer timer;
+    Timer reference;
+
+    scheduler_init(&sched);
+    timer_init(&timer);
+    timer_set_clock(&timer, &clock);
+    assert(timer_set_scheduler(&timer, &sched));
+    timer_init(&reference);
+
+    // Sans horloge maître, pas d'événement possible
+    Timer local;
+    timer_init(&local);
+    assert(!timer_set_scheduler(&local, &sched));
+
+    // Aucun événement tant que le timer est désactivé
+    assert(scheduler_when(&sched, timer.overflow_event) == SCHEDULER_NEVER);
+
+    // TIMA=0xF0: 16 fronts (un tous les 16 cycles) puis rechargement à +4
+    timer_write(&timer, TAC_REG, 0x05);
+    timer_write(&timer, TMA_REG, 0x10);
+    timer_write(&timer, TIMA_REG, 0xF0);
+    timer_write(&reference, TAC_REG, 0x05);
+    timer_write(&reference, TMA_REG, 0x10);
+    timer_write(&reference, TIMA_REG, 0xF0);
+    assert(scheduler_when(&sched, timer.overflow_event) == 16 * 16 + TIMER_RELOAD_DELAY);
+
+    // Avancer par instructions de 4 cycles, comme la boucle principale:
+    // l'événement et le tick cycle à cycle doivent coïncider
+    int interrupts = 0;
+    int reference_interrupts = 0;
+    u64 first_interrupt = 0;
+    for (int step = 0; step < 20000; step++) {
+        clock += 4;
+        if (clock >= sched.next) {
+            scheduler_run(&sched, clock);
+        }
+        for (int c = 0; c < 4; c++) {
+            timer_tick(&reference, 1);
+        }
+
+        if (timer_get_interrupts(&timer)) {
+            if (interrupts == 0) first_interrupt = clock;
+            interrupts++;
+        }
+        if (timer_get_interrupts(&reference)) reference_interrupts++;
+        assert(interrupts == reference_interrupts);
+
+        // Lectures régulières: calculées à la demande, sans effet sur l'échéance
+        if ((step % 37) == 0) {
+            assert(timer_read(&timer, TIMA_REG) == timer_read(&reference, TIMA_REG));
+            assert(timer_read(&timer, DIV_REG) == timer_read(&reference, DIV_REG));
+        }
+
+        // Écritures ponctuelles (glitches compris) appliquées aux deux
+        if (step == 3000) {
+            timer_write(&timer, DIV_REG, 0);
+            timer_write(&reference, DIV_REG, 0);
+        }
+        if (step == 7000) {
+            timer_write(&timer, TAC_REG, 0x07);
+            timer_write(&reference, TAC_REG, 0x07);
+        }
+        if (step == 12000) {
+            timer_write(&timer, TMA_REG, 0xFE);
+            timer_write(&reference, TMA_REG, 0xFE);
+        }
+    }
+
+    assert(first_interrupt == 16 * 16 + TIMER_RELOAD_DELAY);
+    assert(interrupts > 10);
+    assert(timer_read(&timer, TIMA_REG) == timer_read(&reference, TIMA_REG));
+
+    // Désactivé: plus d'échéance une fois un éventuel rechargement terminé
+    timer_write(&timer, TAC_REG, 0x00);
+    clock += TIMER_RELOAD_DELAY;
+    scheduler_run(&sched, clock);
+    assert(scheduler_when(&sched, timer.overflow_event) == SCHEDULER_NEVER);
 }
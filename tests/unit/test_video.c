@@ -0,0 +1,368 @@
+/**
+ * TESTS UNITAIRES POUR LA SORTIE VIDÉO
+ *
+ * Ce fichier contient des tests unitaires pour le flux vidéo (PPM/Y4M)
+ * l'écriture différée en arrière-plan et les backends de présentation.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../../src/common.h"
+#include "../../src/framebuffer.h"
+#include "../../src/async_writer.h"
+#include "../../src/video_sink.h"
+#include "../../src/video.h"
+#include "../../src/video_shm.h"
+#include "../../src/scaler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Prototypes des fonctions de test
+void test_async_writer_sync(void);
+void test_async_writer_threaded(void);
+void test_video_sink_ppm(void);
+void test_video_sink_y4m(void);
+void test_video_backend_null(void);
+void test_video_backend_shm(void);
+void test_scaler_nearest(void);
+void test_scaler_epx(void);
+
+// Table des tests vidéo
+typedef struct {
+    const char* name;
+    void (*test_func)(void);
+} UnitTest;
+
+UnitTest video_tests[] = {
+    {"Async Writer Synchrone", test_async_writer_sync},
+    {"Async Writer Thread", test_async_writer_threaded},
+    {"Video Sink PPM", test_video_sink_ppm},
+    {"Video Sink Y4M", test_video_sink_y4m},
+    {"Backend Null", test_video_backend_null},
+    {"Backend Mémoire Partagée", test_video_backend_shm},
+    {"Scaler Plus Proche Voisin", test_scaler_nearest},
+    {"Scaler EPX", test_scaler_epx},
+    {NULL, NULL} // Marqueur de fin
+};
+
+/**
+ * FONCTION PRINCIPALE DE TEST
+ */
+int main(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+
+    printf("=== TESTS UNITAIRES VIDÉO ===\n\n");
+
+    int passed = 0;
+    int total = 0;
+
+    for (int i = 0; video_tests[i].name != NULL; i++) {
+        printf("Test %d: %s... ", i + 1, video_tests[i].name);
+        fflush(stdout);
+
+        // Exécuter le test
+        video_tests[i].test_func();
+
+        printf("PASS\n");
+        passed++;
+        total++;
+    }
+
+    printf("\n=== RÉSULTATS ===\n");
+    printf("Tests passés: %d/%d\n", passed, total);
+
+    if (passed == total) {
+        printf("✅ TOUS LES TESTS SONT PASSÉS !\n");
+        return 0;
+    } else {
+        printf("❌ CERTAINS TESTS ONT ÉCHOUÉ\n");
+        return 1;
+    }
+}
+
+/**
+ * IMPLEMENTATION DES TESTS
+ */
+
+#define TEST_VIDEO_PATH "test_video_tmp.bin"
+
+static const ScalerMode native = {1, SCALER_NEAREST};
+
+// Écrit 'count' blocs numérotés et vérifie l'ordre à la relecture
+static void check_writer_blocks(bool threaded, int count) {
+    FILE* f = tmpfile();
+    assert(f != NULL);
+
+    AsyncWriter writer;
+    assert(async_writer_open(&writer, f, 256, threaded));
+    for (int i = 0; i < count; i++) {
+        u8* block = async_writer_acquire(&writer);
+        memset(block, i & 0xFF, 100 + i % 50);
+        async_writer_submit(&writer, 100 + i % 50);
+    }
+    assert(async_writer_close(&writer));
+    assert(writer.blocks_written == (u32)count);
+
+    rewind(f);
+    for (int i = 0; i < count; i++) {
+        u8 block[256];
+        size_t len = 100 + i % 50;
+        assert(fread(block, 1, len, f) == len);
+        for (size_t j = 0; j < len; j++) {
+            assert(block[j] == (u8)(i & 0xFF));
+        }
+    }
+    assert(fgetc(f) == EOF);
+    fclose(f);
+}
+
+void test_async_writer_sync(void) {
+    check_writer_blocks(false, 10);
+}
+
+void test_async_writer_threaded(void) {
+    // Plus de blocs que de cases: le producteur doit attendre le thread
+    check_writer_blocks(true, 200);
+}
+
+static long file_size(const char* path) {
+    FILE* f = fopen(path, "rb");
+    assert(f != NULL);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+void test_video_sink_ppm(void) {
+    static u8 frame[FB_PIXELS];
+    memset(frame, 3, sizeof(frame));
+    frame[0] = 0;
+
+    VideoSink sink;
+    assert(video_sink_format_from_path("out.ppm") == VIDEO_SINK_PPM);
+    assert(video_sink_open(&sink, TEST_VIDEO_PATH, VIDEO_SINK_PPM, 2, &FB_PALETTE_GRAY, native, true));
+    assert(video_sink_wants_frame(&sink, 0));
+    assert(!video_sink_wants_frame(&sink, 1));
+    video_sink_write_frame(&sink, frame);
+    video_sink_write_frame(&sink, frame);
+    assert(video_sink_close(&sink));
+
+    // Deux images P6 complètes concaténées
+    const char header[] = "P6\n160 144\n255\n";
+    long frame_bytes = (long)(sizeof(header) - 1) + FB_PIXELS * 3;
+    assert(file_size(TEST_VIDEO_PATH) == frame_bytes * 2);
+
+    FILE* f = fopen(TEST_VIDEO_PATH, "rb");
+    u8 buf[32];
+    fseek(f, frame_bytes, SEEK_SET);
+    assert(fread(buf, 1, sizeof(header) + 5, f) == sizeof(header) + 5);
+    assert(memcmp(buf, header, sizeof(header) - 1) == 0);
+    assert(buf[sizeof(header) - 1] == 0xFF);  // Pixel 0: blanc
+    assert(buf[sizeof(header) + 2] == 0x00);  // Pixel 1: noir
+    fclose(f);
+    remove(TEST_VIDEO_PATH);
+}
+
+void test_video_sink_y4m(void) {
+    static u8 frame[FB_PIXELS];
+    memset(frame, 0, sizeof(frame));
+
+    VideoSink sink;
+    assert(video_sink_format_from_path("review.y4m") == VIDEO_SINK_Y4M);
+    assert(video_sink_open(&sink, TEST_VIDEO_PATH, VIDEO_SINK_Y4M, 1, &FB_PALETTE_GRAY, native, false));
+    for (int i = 0; i < 3; i++) {
+        video_sink_write_frame(&sink, frame);
+    }
+    assert(video_sink_close(&sink));
+
+    FILE* f = fopen(TEST_VIDEO_PATH, "rb");
+    char line[64];
+    assert(fgets(line, sizeof(line), f) != NULL);
+    assert(strncmp(line, "YUV4MPEG2 W160 H144 ", 20) == 0);
+    long header_bytes = (long)strlen(line);
+    fclose(f);
+
+    // Blanc en BT.601 plage limitée: Y=235, U=V=128
+    assert(sink.yuv_lut[0][0] == 235 && sink.yuv_lut[1][0] == 128 && sink.yuv_lut[2][0] == 128);
+    assert(sink.yuv_lut[0][3] == 16);
+    assert(file_size(TEST_VIDEO_PATH) == header_bytes + 3 * (6 + FB_PIXELS * 3));
+    remove(TEST_VIDEO_PATH);
+}
+
+void test_video_backend_null(void) {
+    static u8 frame[FB_PIXELS];
+    VideoBackend vb;
+
+    assert(!video_backend_open(&vb, "inconnu", NULL, native));
+    assert(video_backend_open(&vb, "null", NULL, native));
+    assert(!vb.interactive);
+    assert(!video_backend_renders(&vb));
+    video_backend_present(&vb, frame, &FB_PALETTE_GRAY, NULL);
+    assert(vb.frames == 0);
+    assert(video_backend_poll(&vb));
+    video_backend_close(&vb);
+}
+
+void test_video_backend_shm(void) {
+#ifndef _WIN32
+    static u8 frame[FB_PIXELS];
+    memset(frame, 0, sizeof(frame));
+
+    char name[64];
+    snprintf(name, sizeof(name), "/cameboy-test-%ld", (long)getpid());
+
+    VideoBackend vb;
+    assert(video_backend_open(&vb, "shm", name, native));
+    assert(video_backend_renders(&vb));
+
+    VideoShmReader reader;
+    assert(video_shm_attach(&reader, name));
+    assert(reader.header->slot_count == VIDEO_SHM_SLOTS);
+    assert(reader.header->width == GB_WIDTH && reader.header->height == GB_HEIGHT);
+    assert(video_shm_published(&reader) == 0);
+
+    u32 seq;
+    assert(video_shm_acquire(&reader, 0, &seq) == NULL);  // Rien de publié
+
+    // Faire tourner l'anneau plus d'une fois
+    int total = VIDEO_SHM_SLOTS + 3;
+    for (int i = 0; i < total; i++) {
+        frame[0] = (u8)(i & 3);
+        VideoFrameInfo info = {(u32)(100 + i), (u64)i * 70224, (u8)i};
+        video_backend_present(&vb, frame, &FB_PALETTE_GREEN, &info);
+    }
+    assert(video_shm_published(&reader) == (u64)total);
+
+    // La plus récente est lisible en place, la plus ancienne a été écrasée
+    u64 last = (u64)total - 1;
+    const VideoShmSlot* slot = video_shm_acquire(&reader, last, &seq);
+    assert(slot != NULL && (seq & 1) == 0);
+    assert(slot->info.frame == 100 + last);
+    assert(slot->info.cycles == last * 70224);
+    assert(slot->info.input == (u8)last);
+    assert(slot->info.palette.rgb[0] == FB_PALETTE_GREEN.rgb[0]);
+    assert(slot->pixels[0] == (last & 3));
+    assert(video_shm_slot_valid(slot, seq));
+    assert(video_shm_acquire(&reader, 0, &seq) == NULL);
+    assert(video_shm_acquire(&reader, last - (VIDEO_SHM_SLOTS - 1), &seq) != NULL);
+
+    // Une réécriture pendant la lecture invalide le slot
+    slot = video_shm_acquire(&reader, last, &seq);
+    for (int i = 0; i < VIDEO_SHM_SLOTS; i++) {
+        video_backend_present(&vb, frame, &FB_PALETTE_GREEN, NULL);
+    }
+    assert(!video_shm_slot_valid(slot, seq));
+
+    video_shm_detach(&reader);
+    video_backend_close(&vb);
+    assert(!video_shm_attach(&reader, name));  // Segment supprimé à la fermeture
+#endif
+}
+
+void test_scaler_nearest(void) {
+    static u8 src[FB_PIXELS];
+    static u8 dst[FB_PIXELS * 16];
+    for (u32 i = 0; i < FB_PIXELS; i++) {
+        src[i] = (u8)((i * 7 + i / GB_WIDTH) & 3);
+    }
+
+    ScalerMode mode;
+    assert(scaler_parse_mode("3x", &mode) && mode.factor == 3 && mode.filter == SCALER_NEAREST);
+    assert(scaler_parse_mode("epx2", &mode) && mode.factor == 2 && mode.filter == SCALER_EPX);
+    assert(!scaler_parse_mode("5", &mode) && !scaler_parse_mode("2y", &mode));
+
+    // Chaque pixel de sortie reprend son pixel source (chemins SIMD + queue scalaire)
+    for (u32 factor = 1; factor <= SCALER_MAX_FACTOR; factor++) {
+        Scaler scaler;
+        ScalerMode m = {factor, SCALER_NEAREST};
+        assert(scaler_init(&scaler, GB_WIDTH, GB_HEIGHT, m));
+        assert(scaler.width == GB_WIDTH * factor && scaler.height == GB_HEIGHT * factor);
+        scaler_run(&scaler, src, dst, scaler.width);
+        for (u32 y = 0; y < scaler.height; y++) {
+            for (u32 x = 0; x < scaler.width; x++) {
+                assert(dst[y * scaler.width + x] == src[(y / factor) * GB_WIDTH + x / factor]);
+            }
+        }
+        scaler_cleanup(&scaler);
+    }
+
+    // Le flux vidéo écrit des frames à la taille mise à l'échelle
+    VideoSink sink;
+    ScalerMode x2 = {2, SCALER_NEAREST};
+    assert(video_sink_open(&sink, TEST_VIDEO_PATH, VIDEO_SINK_PPM, 1, &FB_PALETTE_GRAY, x2, false));
+    video_sink_write_frame(&sink, src);
+    assert(video_sink_close(&sink));
+    const char header[] = "P6\n320 288\n255\n";
+    assert(file_size(TEST_VIDEO_PATH) == (long)(sizeof(header) - 1) + FB_PIXELS * 4 * 3);
+    remove(TEST_VIDEO_PATH);
+}
+
+// Référence scalaire de Scale2x (bords répliqués)
+static u8 epx_ref(const u8* src, u32 w, u32 h, u32 x, u32 y, u32 sub) {
+    u32 l = x > 0 ? x - 1 : x, r = x + 1 < w ? x + 1 : x;
+    u32 t = y > 0 ? y - 1 : y, b = y + 1 < h ? y + 1 : y;
+    u8 e = src[y * w + x], B = src[t * w + x], H = src[b * w + x];
+    u8 D = src[y * w + l], F = src[y * w + r];
+    if (B == H || D == F) return e;
+    switch (sub) {
+        case 0: return D == B ? D : e;
+        case 1: return B == F ? F : e;
+        case 2: return D == H ? D : e;
+        default: return H == F ? F : e;
+    }
+}
+
+void test_scaler_epx(void) {
+    static u8 src[FB_PIXELS];
+    static u8 dst[FB_PIXELS * 16];
+    u32 seed = 12345;
+    for (u32 i = 0; i < FB_PIXELS; i++) {
+        seed = seed * 1103515245 + 12345;
+        src[i] = (u8)((seed >> 16) & 3);
+    }
+
+    Scaler scaler;
+    ScalerMode epx2 = {2, SCALER_EPX};
+    assert(scaler_init(&scaler, GB_WIDTH, GB_HEIGHT, epx2));
+    scaler_run(&scaler, src, dst, scaler.width);
+    for (u32 y = 0; y < GB_HEIGHT; y++) {
+        for (u32 x = 0; x < GB_WIDTH; x++) {
+            for (u32 sub = 0; sub < 4; sub++) {
+                u32 ox = x * 2 + (sub & 1), oy = y * 2 + (sub >> 1);
+                assert(dst[oy * scaler.width + ox] == epx_ref(src, GB_WIDTH, GB_HEIGHT, x, y, sub));
+            }
+        }
+    }
+    scaler_cleanup(&scaler);
+
+    // Diagonale: EPX lisse l'escalier, le plus proche voisin le garde
+    static const u8 diag[9] = { 3, 0, 0,
+                                0, 3, 0,
+                                0, 0, 3 };
+    u8 out[81];
+    ScalerMode epx3 = {3, SCALER_EPX};
+    assert(scaler_init(&scaler, 3, 3, epx3));
+    scaler_run(&scaler, diag, out, 9);
+    assert(out[4 * 9 + 4] == 3);  // Centre
+    assert(out[3 * 9 + 2] == 3);  // Marche comblée entre (0,0) et (1,1)
+    assert(out[0 * 9 + 8] == 0);  // Coin hors diagonale intact
+    scaler_cleanup(&scaler);
+
+    // 4x: dimensions et pixels constants préservés
+    ScalerMode epx4 = {4, SCALER_EPX};
+    memset(src, 2, sizeof(src));
+    assert(scaler_init(&scaler, GB_WIDTH, GB_HEIGHT, epx4));
+    assert(scaler.scratch != NULL);
+    scaler_run(&scaler, src, dst, scaler.width);
+    for (u32 i = 0; i < FB_PIXELS * 16; i++) {
+        assert(dst[i] == 2);
+    }
+    scaler_cleanup(&scaler);
+}